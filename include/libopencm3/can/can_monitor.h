@@ -0,0 +1,119 @@
+/** @defgroup can_monitor_defines CAN Monitor Defines
+ *
+ * @brief <b>Defined Constants and Types for the CAN bus monitor</b>
+ *
+ * LGPL License Terms @ref lgpl_license
+ */
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBOPENCM3_CAN_MONITOR_H
+#define LIBOPENCM3_CAN_MONITOR_H
+
+#include <libopencm3/cm3/common.h>
+
+/**@{*/
+
+/** @defgroup can_monitor_flags Frame flags for can_monitor_frame()
+@{*/
+#define CAN_MONITOR_TX			(1 << 0)	/**< Sent, not received */
+#define CAN_MONITOR_EXT			(1 << 1)	/**< 29-bit identifier */
+#define CAN_MONITOR_FD			(1 << 2)	/**< FD frame format */
+#define CAN_MONITOR_BRS			(1 << 3)	/**< FD bit rate switch */
+/**@}*/
+
+/** Traffic of one identifier class. */
+struct can_monitor_class {
+	uint32_t frames;
+	uint32_t bytes;
+};
+
+/** Monitor state. All storage is supplied to can_monitor_init(). */
+struct can_monitor {
+	uint32_t bitrate;		/**< Nominal bit rate, bit/s */
+	uint32_t data_bitrate;		/**< FD data phase bit rate, bit/s */
+	uint32_t tick_hz;		/**< Rate of the time base */
+	uint32_t bucket_ticks;		/**< Length of one window bucket */
+	uint32_t *buckets;		/**< Bus bits per bucket */
+	struct can_monitor_class *classes;
+	uint8_t nbuckets;
+	uint8_t nclasses;
+	uint8_t class_shift;
+	uint8_t bucket;
+	uint32_t bucket_start;
+	uint32_t window_bits;
+	uint32_t peak_bits;
+	uint32_t frames_rx;
+	uint32_t frames_tx;
+	uint32_t bytes_rx;
+	uint32_t bytes_tx;
+	uint8_t tec;
+	uint8_t rec;
+	uint8_t tec_peak;
+	uint8_t rec_peak;
+	uint8_t tec_window;		/**< TEC when the window last wrapped */
+	uint8_t rec_window;		/**< REC when the window last wrapped */
+	int16_t tec_trend;
+	int16_t rec_trend;
+	uint32_t residency_count;
+	uint32_t residency_sum;
+	uint16_t residency_min;
+	uint16_t residency_max;
+};
+
+/** Consistent copy of the monitor figures, see can_monitor_snapshot(). */
+struct can_monitor_snapshot {
+	uint32_t frames_rx;
+	uint32_t frames_tx;
+	uint32_t bytes_rx;
+	uint32_t bytes_tx;
+	uint16_t load;			/**< Bus load over the window, 0.1 % */
+	uint16_t load_peak;		/**< Highest load of a full window, 0.1 % */
+	uint8_t tec;
+	uint8_t rec;
+	uint8_t tec_peak;
+	uint8_t rec_peak;
+	int16_t tec_trend;		/**< TEC change over the last window */
+	int16_t rec_trend;		/**< REC change over the last window */
+	uint32_t residency_count;	/**< Frames with a residency sample */
+	uint16_t residency_min;		/**< In timestamp counter units */
+	uint16_t residency_avg;
+	uint16_t residency_max;
+};
+
+BEGIN_DECLS
+
+void can_monitor_init(struct can_monitor *mon, uint32_t bitrate,
+		      uint32_t data_bitrate, uint32_t tick_hz,
+		      uint32_t *buckets, uint8_t nbuckets,
+		      uint32_t bucket_ticks,
+		      struct can_monitor_class *classes, uint8_t nclasses,
+		      uint8_t class_shift);
+void can_monitor_tick(struct can_monitor *mon, uint32_t now);
+void can_monitor_frame(struct can_monitor *mon, uint32_t now, uint32_t id,
+		       uint8_t length, uint32_t flags);
+void can_monitor_residency(struct can_monitor *mon, uint16_t queued,
+			   uint16_t sent);
+void can_monitor_errors(struct can_monitor *mon, uint8_t tec, uint8_t rec);
+void can_monitor_snapshot(struct can_monitor *mon, uint32_t now,
+			  struct can_monitor_snapshot *snap);
+
+END_DECLS
+
+/**@}*/
+
+#endif
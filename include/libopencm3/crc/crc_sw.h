@@ -0,0 +1,71 @@
+/** @defgroup crc_sw_defines Software CRC Defines
+ *
+ * @brief <b>Defined Constants and Types for the software CRC</b>
+ *
+ * LGPL License Terms @ref lgpl_license
+ */
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBOPENCM3_CRC_SW_H
+#define LIBOPENCM3_CRC_SW_H
+
+#include <stddef.h>
+#include <libopencm3/cm3/common.h>
+
+/**@{*/
+
+/**
+ * A table driven CRC algorithm. All the supported algorithms reflect either
+ * both input and output, or neither.
+ */
+struct crc_sw_algo {
+	uint8_t width;			/**< 7..32 bits */
+	bool reflected;			/**< LSB first */
+	uint8_t slices;			/**< 4 or 8 tables */
+	uint32_t initial;
+	uint32_t xor_out;
+	const uint32_t (*table)[256];	/**< from scripts/gencrctables */
+};
+
+/** CRC-32 (Ethernet, zlib, PNG), slice-by-8 */
+extern const struct crc_sw_algo crc_sw_crc32;
+/** CRC-32/MPEG-2, as the fixed CRC unit of STM32F1/F2/F4/L1, slice-by-8 */
+extern const struct crc_sw_algo crc_sw_crc32_mpeg2;
+/** CRC-16/CCITT-FALSE, slice-by-4 */
+extern const struct crc_sw_algo crc_sw_crc16_ccitt;
+/** CRC-16/MODBUS, slice-by-4 */
+extern const struct crc_sw_algo crc_sw_crc16_modbus;
+/** CRC-8 (SMBus PEC), slice-by-4 */
+extern const struct crc_sw_algo crc_sw_crc8;
+/** CRC-7/MMC (SD card commands), slice-by-4 */
+extern const struct crc_sw_algo crc_sw_crc7_mmc;
+
+BEGIN_DECLS
+
+uint32_t crc_sw_init(const struct crc_sw_algo *algo);
+uint32_t crc_sw_update(const struct crc_sw_algo *algo, uint32_t crc,
+		       const void *data, size_t len);
+uint32_t crc_sw_finalize(const struct crc_sw_algo *algo, uint32_t crc);
+uint32_t crc_sw_calculate(const struct crc_sw_algo *algo, const void *data,
+			  size_t len);
+
+END_DECLS
+
+/**@}*/
+
+#endif
@@ -576,6 +576,7 @@
 #define ETH_DMAMFBOCR_MFC_SHIFT		0
 #define ETH_DMAMFBOCR_MFC		(0xFFFF << ETH_DMAMFBOCR_MFC_SHIFT)
 #define ETH_DMAMFBOCR_OMFC		(1<<16)
+#define ETH_DMAMFBOCR_MFA_SHIFT		17
 #define ETH_DMAMFBOCR_MFA		(0x7FF << ETH_DMAMFBOCR_MFA_SHIFT)
 #define ETH_DMAMFBOCR_OFOC		(1<<28)
 
@@ -729,6 +730,43 @@ enum eth_clk {
 	ETH_CLK_150_168MHZ = ETH_MACMIIAR_CR_HCLK_DIV_102,
 };
 
+/** One buffer of a frame, as lent by eth_rx_get() or passed to eth_tx_sg() */
+struct eth_frag {
+	uint8_t *data;
+	uint32_t len;
+};
+
+/** IEEE 1588 time */
+struct eth_timestamp {
+	uint32_t sec;
+	uint32_t nsec;
+};
+
+/** Status of a received frame, see eth_rx_get_info() */
+struct eth_rx_info {
+	uint32_t status;	/**< RDES4, ETH_RDES4_* */
+	bool checksum_ok;	/**< IP frame with good header and payload sums */
+	bool has_ts;
+	struct eth_timestamp ts;
+};
+
+/** Driver statistics, see eth_get_stats() */
+struct eth_stats {
+	uint32_t rx_frames;
+	uint32_t rx_bytes;	/**< Of frames taken with eth_rx_get() */
+	uint32_t rx_errors;	/**< Frames received with errors */
+	uint32_t rx_dropped;	/**< Frames dropped by the driver */
+	uint32_t rx_missed;	/**< Frames missed for lack of descriptors */
+	uint32_t rx_overruns;	/**< Frames lost to receive FIFO overflow */
+	uint32_t rx_no_buffer;	/**< Receive DMA suspensions */
+	uint32_t tx_frames;
+	uint32_t tx_bytes;
+	uint32_t tx_errors;	/**< Frames aborted with an error */
+	uint32_t tx_underflows;	/**< Transmit FIFO underflows */
+	uint32_t tx_busy;	/**< Frames refused for a full ring */
+	uint32_t bus_errors;	/**< Fatal DMA bus errors */
+};
+
 /*****************************************************************************/
 /* API Functions                                                             */
 /*****************************************************************************/
@@ -747,15 +785,38 @@ void eth_desc_init(uint8_t *buf, uint32_t nTx, uint32_t nRx, uint32_t cTx,
 bool eth_tx(uint8_t *ppkt, uint32_t n);
 bool eth_rx(uint8_t *ppkt, uint32_t *len, uint32_t maxlen);
 
+uint32_t eth_rx_get(struct eth_frag *frags, uint32_t max);
+void eth_rx_release(void);
+bool eth_rx_get_info(struct eth_rx_info *info);
+uint8_t *eth_tx_alloc(uint32_t *size);
+bool eth_tx_submit(uint32_t n);
+bool eth_tx_submit_flags(uint32_t n, uint32_t flags);
+bool eth_tx_sg(const struct eth_frag *frags, uint32_t nfrags);
+bool eth_tx_sg_flags(const struct eth_frag *frags, uint32_t nfrags,
+		     uint32_t flags);
+uint32_t eth_tx_reclaim(void);
+bool eth_tx_get_timestamp(struct eth_timestamp *ts);
+
 void eth_init(uint8_t phy, enum eth_clk clock);
 void eth_start(void);
 
-void eth_enable_checksum_offload(void);
+bool eth_enable_checksum_offload(void);
+
+bool eth_ptp_init(uint32_t hclk);
+void eth_ptp_get_time(struct eth_timestamp *ts);
+void eth_ptp_set_time(const struct eth_timestamp *ts);
+void eth_ptp_adjust_time(int64_t offset_ns);
+void eth_ptp_adjust_freq(int32_t ppb);
 
 void eth_irq_enable(uint32_t reason);
 void eth_irq_disable(uint32_t reason);
 bool eth_irq_is_pending(uint32_t reason);
 bool eth_irq_ack_pending(uint32_t reason);
+void eth_irq_setup(uint8_t rx_watchdog, uint32_t tx_batch);
+uint32_t eth_irq_process(void);
+
+void eth_get_stats(struct eth_stats *stats);
+void eth_clear_stats(void);
 
 
 END_DECLS
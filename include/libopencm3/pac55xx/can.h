@@ -297,6 +297,7 @@ bool can_transmit_std(uint32_t canport, uint32_t id, bool rtr, uint8_t length,
 bool can_transmit_ext(uint32_t canport, uint32_t id, bool rtr, uint8_t length,
 			const uint8_t *data);
 void can_abort_transmit(uint32_t canport);
+void can_get_error_counters(uint32_t canport, uint8_t *tec, uint8_t *rec);
 
 void can_receive(uint32_t canport, uint32_t *id, bool *ext, bool *rtr, uint8_t *length,
 			uint8_t *data);
@@ -254,7 +254,8 @@ LGPL License Terms @ref lgpl_license
 #define CAN_TSR_TME0			(1 << 26)
 
 /* CODE[1:0]: Mailbox code */
-#define CAN_TSR_CODE_MASK		(0x3 << 24)
+#define CAN_TSR_CODE_SHIFT		24
+#define CAN_TSR_CODE_MASK		(0x3 << CAN_TSR_CODE_SHIFT)
 
 /* ABRQ2: Abort request for mailbox 2 */
 #define CAN_TSR_ABRQ2			(1 << 23)
@@ -396,10 +397,12 @@ LGPL License Terms @ref lgpl_license
 /* --- CAN_ESR values ------------------------------------------------------ */
 
 /* REC[7:0]: Receive error counter */
-#define CAN_ESR_REC_MASK		(0xF << 24)
+#define CAN_ESR_REC_SHIFT		24
+#define CAN_ESR_REC_MASK		(0xFFu << 24)
 
 /* TEC[7:0]: Least significant byte of the 9-bit transmit error counter */
-#define CAN_ESR_TEC_MASK		(0xF << 16)
+#define CAN_ESR_TEC_SHIFT		16
+#define CAN_ESR_TEC_MASK		(0xFF << 16)
 
 /* 15:7 Reserved, forced by hardware to 0 */
 
@@ -640,6 +643,95 @@ LGPL License Terms @ref lgpl_license
 
 /* FB[31:0]: Filter bits */
 
+/* --- CAN filter compiler ------------------------------------------------- */
+
+/** Identifier range to accept, see can_filter_compile(). A single ID has
+ * id_last equal to id.
+ */
+struct can_filter_rule {
+	uint32_t id;
+	uint32_t id_last;
+	bool ext;
+};
+
+/** Filter in 32-bit register layout, value and mask. Scratch entry for
+ * can_filter_compile().
+ */
+struct can_filter_entry {
+	uint32_t id;
+	uint32_t mask;
+};
+
+/** Outcome of can_filter_compile(). */
+struct can_filter_report {
+	uint32_t banks;		/**< Filter banks programmed. */
+	uint32_t accepted;	/**< IDs accepted by the programmed banks. */
+	uint32_t false_accepts;	/**< Accepted IDs not covered by any rule. */
+};
+
+/* --- CAN frame ----------------------------------------------------------- */
+
+/** CAN frame used by the frame based functions and the buffered CAN layer.
+ *
+ * The payload directly follows the 32-bit identifier, so it is always word
+ * aligned and moves to and from the mailbox registers with two word accesses.
+ */
+struct can_frame {
+	uint32_t id;		/**< Standard or extended identifier. */
+	uint8_t data[8];	/**< Payload, @ref length bytes are valid. */
+	uint16_t timestamp;	/**< Receive timestamp (time triggered mode). */
+	uint8_t length;		/**< Data length code. */
+	uint8_t fmi;		/**< Filter match index of received frames. */
+	bool ext;		/**< The identifier is a 29-bit extended one. */
+	bool rtr;		/**< Remote transmission request. */
+};
+
+/* --- Buffered CAN layer --------------------------------------------------- */
+
+/** Receive ring filled from the FIFO interrupt. One slot is kept free to
+ * tell a full ring from an empty one.
+ */
+struct can_rx_ring {
+	struct can_frame *frames;
+	uint16_t size;
+	volatile uint16_t head;
+	volatile uint16_t tail;
+};
+
+/** Counters maintained by the buffered CAN layer. Index 0/1 is the FIFO. */
+struct can_stats {
+	uint32_t tx_frames;		/**< Frames transmitted successfully. */
+	uint32_t tx_requeued;		/**< Mailboxes preempted by a frame
+					  of higher priority. */
+	uint32_t tx_errors;		/**< Transmissions that failed. */
+	uint32_t tx_dropped;		/**< Frames refused, TX queue full. */
+	uint32_t rx_frames[2];		/**< Frames stored in the RX rings. */
+	uint32_t rx_dropped[2];		/**< Frames lost, RX ring full. */
+	uint32_t rx_overruns[2];	/**< Hardware FIFO overruns. */
+	uint32_t bus_errors;		/**< Protocol errors (LEC). */
+	uint32_t error_warning;		/**< Entries into error warning. */
+	uint32_t error_passive;		/**< Entries into error passive. */
+	uint32_t bus_off;		/**< Entries into bus off. */
+};
+
+/** State of one bxCAN instance driven by the buffered CAN layer.
+ *
+ * All storage is supplied by the application through can_buf_init(). The
+ * TX queue is kept sorted on bus priority, highest priority last.
+ */
+struct can_buf {
+	uint32_t canport;
+	struct can_frame *tx;
+	uint16_t tx_size;
+	volatile uint16_t tx_count;
+	struct can_frame mbox[3];
+	uint32_t mbox_key[3];
+	uint8_t aborting;
+	uint32_t esr;
+	struct can_rx_ring rx[2];
+	struct can_stats stats;
+};
+
 /* --- CAN functions -------------------------------------------------------- */
 
 BEGIN_DECLS
@@ -663,17 +755,42 @@ void can_filter_id_list_16bit_init(uint32_t nr, uint16_t id1,
 void can_filter_id_list_32bit_init(uint32_t nr, uint32_t id1,
 				   uint32_t id2, uint32_t fifo, bool enable);
 
+bool can_filter_compile(const struct can_filter_rule *rules, uint32_t nrules,
+			struct can_filter_entry *work, uint32_t work_size,
+			uint32_t first_bank, uint32_t nbanks, uint32_t fifo,
+			struct can_filter_report *report);
+
 void can_enable_irq(uint32_t canport, uint32_t irq);
 void can_disable_irq(uint32_t canport, uint32_t irq);
 
 int can_transmit(uint32_t canport, uint32_t id, bool ext, bool rtr,
 		 uint8_t length, uint8_t *data);
+int can_transmit_frame(uint32_t canport, const struct can_frame *frame);
 void can_receive(uint32_t canport, uint8_t fifo, bool release, uint32_t *id,
 		 bool *ext, bool *rtr, uint8_t *fmi, uint8_t *length,
 		 uint8_t *data, uint16_t *timestamp);
+void can_receive_frame(uint32_t canport, uint8_t fifo, bool release,
+		       struct can_frame *frame);
+uint32_t can_receive_burst(uint32_t canport, uint8_t fifo,
+			   struct can_frame *frames, uint32_t max);
 
 void can_fifo_release(uint32_t canport, uint8_t fifo);
 bool can_available_mailbox(uint32_t canport);
+void can_get_error_counters(uint32_t canport, uint8_t *tec, uint8_t *rec);
+
+void can_buf_init(struct can_buf *buf, uint32_t canport,
+		  struct can_frame *tx, uint16_t tx_size,
+		  struct can_frame *rx0, uint16_t rx0_size,
+		  struct can_frame *rx1, uint16_t rx1_size);
+bool can_buf_transmit(struct can_buf *buf, const struct can_frame *frame);
+bool can_buf_receive(struct can_buf *buf, uint8_t fifo,
+		     struct can_frame *frame);
+uint16_t can_buf_tx_pending(struct can_buf *buf);
+uint16_t can_buf_rx_pending(struct can_buf *buf, uint8_t fifo);
+void can_buf_tx_isr(struct can_buf *buf);
+void can_buf_rx_isr(struct can_buf *buf, uint8_t fifo);
+void can_buf_sce_isr(struct can_buf *buf);
+void can_buf_isr(struct can_buf *buf);
 END_DECLS
 
 /**@}*/
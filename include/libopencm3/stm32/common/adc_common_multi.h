@@ -0,0 +1,91 @@
+/** @addtogroup adc_defines
+
+Acquisition engine shared by the "multi" extensions of the v1 and v2 ADC.
+
+ */
+
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**@{*/
+
+/* THIS FILE SHOULD NOT BE INCLUDED DIRECTLY, BUT ONLY VIA ADC.H
+The order of header inclusion is important. adc.h includes the device
+specific memorymap.h header before including this header file.*/
+
+/** @cond */
+#ifdef LIBOPENCM3_ADC_H
+/** @endcond */
+#ifndef LIBOPENCM3_ADC_COMMON_MULTI_H
+#define LIBOPENCM3_ADC_COMMON_MULTI_H
+
+/* --- Acquisition engine ------------------------------------------------- */
+
+/** Channel of an acquisition scan, see adc_acq_init() */
+struct adc_acq_channel {
+	uint8_t channel;	/**< @ref adc_channel */
+	uint8_t sample_time;	/**< @ref adc_sample */
+};
+
+/**
+ * Start a circular DMA transfer of @p n half words from ADC_DR(@p adc) to
+ * @p buf, with half and full transfer complete interrupts. The stream is part
+ * specific, so this is left to the application.
+ */
+typedef void (*adc_acq_dma_callback)(uint32_t adc, uint16_t *buf, uint32_t n);
+
+/**
+ * Receives a completed half of the acquisition buffer: @p nscans scans of
+ * one sample per channel each, in sequence order.
+ */
+typedef void (*adc_acq_block_callback)(const uint16_t *block, uint32_t nscans,
+				       void *arg);
+
+/** Continuous, triggered multi channel acquisition, see adc_acq_init() */
+struct adc_acq {
+	uint32_t adc;
+	uint16_t *buf;
+	uint32_t nscans;	/**< Scans per buffer half */
+	uint8_t nchannels;
+	adc_acq_block_callback block;
+	void *arg;
+	uint32_t blocks;	/**< Halves delivered */
+	uint32_t overruns;	/**< Overruns recovered from */
+};
+
+
+/* --- Function prototypes ------------------------------------------------- */
+
+BEGIN_DECLS
+
+void adc_acq_init(struct adc_acq *acq, uint32_t adc,
+		  const struct adc_acq_channel *channels, uint8_t nchannels,
+		  uint16_t *buf, uint32_t nscans, adc_acq_block_callback block,
+		  void *arg);
+void adc_acq_start(struct adc_acq *acq, uint32_t trigger, uint32_t polarity,
+		   adc_acq_dma_callback start);
+void adc_acq_stop(struct adc_acq *acq);
+void adc_acq_dma_isr(struct adc_acq *acq, bool full);
+bool adc_acq_overrun(struct adc_acq *acq);
+
+END_DECLS
+
+#endif
+/** @cond */
+#endif
+/** @endcond */
+/**@}*/
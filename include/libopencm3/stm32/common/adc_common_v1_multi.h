@@ -37,6 +37,7 @@ specific memorymap.h header before including this header file.*/
 #define LIBOPENCM3_ADC_COMMON_V1_MULTI_H
 
 #include <libopencm3/stm32/common/adc_common_v1.h>
+#include <libopencm3/stm32/common/adc_common_multi.h>
 
 /* --- Convenience macros -------------------------------------------------- */
 
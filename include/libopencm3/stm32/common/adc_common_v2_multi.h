@@ -35,6 +35,8 @@ specific memorymap.h header before including this header file.*/
 #ifndef LIBOPENCM3_ADC_COMMON_V2_MULTI_H
 #define LIBOPENCM3_ADC_COMMON_V2_MULTI_H
 
+#include <libopencm3/stm32/common/adc_common_multi.h>
+
 /*
  * The adc v2 peripheral optionally supports per channel sampling, injected
  * sequences, watchdogs, offsets and other "advanced" features, and is
@@ -121,6 +121,13 @@ specific memorymap.h header before including this header file.*/
 
 /**@}*/
 
+/**
+ * Starts DMA transfers of @p n words from @p in to CORDIC_WDATA and of
+ * @p n words from CORDIC_RDATA to @p out.
+ */
+typedef void (*cordic_dma_callback)(const uint32_t *in, uint32_t *out,
+                                    uint32_t n);
+
 /* --- Function prototypes ------------------------------------------------- */
 
 BEGIN_DECLS
@@ -160,6 +167,22 @@ void cordic_cos_16bit_async(int16_t x);
 void cordic_cos_32bit_async(int32_t x);
 void cordic_sin_16bit_async(int16_t x);
 void cordic_sin_32bit_async(int32_t x);
+void cordic_configure_sincos_q15(void);
+void cordic_configure_sincos_q31(void);
+void cordic_configure_phase_q15(void);
+void cordic_configure_sqrt_q15(uint8_t scale);
+void cordic_sincos_q15_array(const int16_t *angle, int16_t *sin,
+                             int16_t *cos, uint32_t n);
+void cordic_sincos_q31_array(const int32_t *angle, int32_t *sin,
+                             int32_t *cos, uint32_t n);
+void cordic_phase_modulus_q15_array(const int16_t *x, const int16_t *y,
+                                    int16_t *phase, int16_t *modulus,
+                                    uint32_t n);
+void cordic_sqrt_q15_array(const int16_t *x, int16_t *out, uint32_t n,
+                           uint8_t scale);
+void cordic_start_dma(const uint32_t *in, uint32_t *out, uint32_t n,
+                      cordic_dma_callback start);
+void cordic_stop_dma(void);
 END_DECLS
 
 #endif
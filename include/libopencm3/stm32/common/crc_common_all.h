@@ -71,6 +71,13 @@ specific memorymap.h header before including this header file.*/
 #define CRC_CR_RESET			(1 << 0)
 /**@}*/
 
+/*
+ * Parts with the programmable unit (crc_v2.h) also have a streaming API,
+ * crc_stream_init() and friends. This fixed unit only takes whole words of
+ * CRC-32/MPEG-2, so it has no such API; use crc_sw_crc32_mpeg2 from
+ * libopencm3/crc/crc_sw.h for byte streams.
+ */
+
 BEGIN_DECLS
 
 
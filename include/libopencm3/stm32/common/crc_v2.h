@@ -31,6 +31,7 @@
 
 /**@{*/
 
+#include <stddef.h>
 #include <libopencm3/stm32/common/crc_common_all.h>
 
 /*****************************************************************************/
@@ -89,6 +90,42 @@
 /** Default polynomial */
 #define CRC_POL_DEFAULT				0x04C11DB7
 
+/**
+ * Complete description of a CRC algorithm, in the usual Rocksoft model terms,
+ * for the streaming API.
+ *
+ * The streaming API needs the programmable unit and only exists here. The
+ * fixed unit of F1/F2/F4/L1 (crc_common_all.h) takes whole words of
+ * CRC-32/MPEG-2 only; use crc_sw_crc32_mpeg2 from libopencm3/crc/crc_sw.h
+ * to stream bytes there.
+ */
+struct crc_config {
+	uint32_t polynomial;	/**< normal (not reflected) form */
+	uint32_t polysize;	/**< @ref crc_polysize */
+	uint32_t initial;
+	bool reflect_in;	/**< process bytes LSB first */
+	bool reflect_out;	/**< reflect the result before xor_out */
+	uint32_t xor_out;
+};
+
+/** CRC-32 (Ethernet, zlib, PNG) */
+extern const struct crc_config crc_config_crc32;
+/** CRC-32/MPEG-2, what the fixed CRC unit of older parts computes */
+extern const struct crc_config crc_config_crc32_mpeg2;
+/** CRC-16/CCITT-FALSE */
+extern const struct crc_config crc_config_crc16_ccitt;
+/** CRC-16/MODBUS */
+extern const struct crc_config crc_config_crc16_modbus;
+/** CRC-8 (SMBus PEC) */
+extern const struct crc_config crc_config_crc8;
+
+/**
+ * Start a DMA memory to memory transfer of @p n 32 bit words from @p words
+ * to CRC_DR. The channel/stream is part specific, so it is left to the
+ * application.
+ */
+typedef void (*crc_dma_callback)(const uint32_t *words, size_t n);
+
 
 BEGIN_DECLS
 
@@ -101,6 +138,11 @@ void crc_set_polysize(uint32_t polysize);
 void crc_set_polynomial(uint32_t polynomial);
 void crc_set_initial(uint32_t initial);
 
+void crc_stream_init(const struct crc_config *config);
+void crc_stream_update(const void *data, size_t len);
+size_t crc_stream_update_dma(const void *data, size_t len, crc_dma_callback start);
+uint32_t crc_stream_finalize(const struct crc_config *config);
+
 END_DECLS
 
 /**@}*/
@@ -143,6 +143,10 @@ specific memorymap.h header before including this header file.*/
 /* CRYP Initialization Vector Registers (CRYP_IVxLR) x=0..1 */
 #define CRYP_IVR(i)		MMIO32(CRYP_BASE + 0x40 + (i) * 8)
 
+/* Key words K0LR..K3RR, i=0..7, and IV words IV0LR..IV1RR, i=0..3 */
+#define CRYP_KEYW(i)		MMIO32(CRYP_BASE + 0x20 + (i) * 4)
+#define CRYP_IVW(i)		MMIO32(CRYP_BASE + 0x40 + (i) * 4)
+
 /* --- CRYP_CR values ------------------------------------------------------ */
 
 /* ALGODIR: Algorithm direction */
@@ -269,6 +273,28 @@ enum crypto_datatype {
 	CRYPTO_DATA_BIT,
 };
 
+/**
+ * Key, mode and data type of a cipher session. The session last loaded is
+ * remembered, so starting it again skips loading (and for AES ECB/CBC
+ * decryption, preparing) the key.
+ */
+struct crypto_session {
+	uint32_t cr;		/**< CRYP_CR without CRYPEN */
+	uint32_t key[8];	/**< Key register words K0LR..K3RR */
+	bool prepare;		/**< Decryption key needs AES preparation */
+};
+
+/**
+ * Start DMA transfers of @p n 32 bit words from @p in to CRYP_DIN and from
+ * CRYP_DOUT to @p out. The streams are part specific, so this is left to
+ * the application.
+ */
+typedef void (*crypto_dma_callback)(const uint32_t *in, uint32_t *out,
+				    uint32_t n);
+
+/** Called by crypto_dma_isr() once a DMA operation has completed. */
+typedef void (*crypto_done_callback)(void *arg);
+
 BEGIN_DECLS
 void crypto_wait_busy(void);
 void crypto_set_key(enum crypto_keysize keysize, uint64_t key[]);
@@ -278,6 +304,18 @@ void crypto_set_algorithm(enum crypto_mode mode);
 void crypto_start(void);
 void crypto_stop(void);
 uint32_t crypto_process_block(uint32_t *inp, uint32_t *outp, uint32_t length);
+
+void crypto_session_init(struct crypto_session *s, uint32_t mode,
+			 enum crypto_keysize keysize, const uint8_t *key,
+			 enum crypto_datatype datatype);
+void crypto_session_load(struct crypto_session *s, const uint8_t *iv);
+void crypto_session_start(struct crypto_session *s, const uint8_t *iv);
+void crypto_session_invalidate(void);
+bool crypto_process_dma(const uint32_t *in, uint32_t *out, uint32_t n,
+			crypto_dma_callback start, crypto_done_callback done,
+			void *arg);
+void crypto_dma_isr(void);
+bool crypto_dma_busy(void);
 END_DECLS
 /**@}*/
 /**@}*/
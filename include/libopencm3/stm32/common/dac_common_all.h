@@ -250,6 +250,34 @@ enum dac_wave {
 	DAC_WAVE_SAWTOOTH = 3,
 };
 
+/**
+ * Start a circular DMA transfer of @p n items from @p buf to the data holding
+ * register at @p reg, with half and full transfer complete interrupts. Items
+ * are 32 bit for both channels, 16 bit for one. The stream is part specific,
+ * so this is left to the application.
+ */
+typedef void (*dac_stream_dma_callback)(uint32_t reg, const void *buf,
+					uint32_t n);
+
+/**
+ * Refill @p n samples at @p half, the buffer half the DMA just finished
+ * reading.
+ */
+typedef void (*dac_stream_refill_callback)(void *half, uint32_t n, void *arg);
+
+/** Continuous, timer paced DAC output, see dac_stream_init() */
+struct dac_stream {
+	uint32_t dac;
+	int channel;		/**< @ref dac_channel_id */
+	enum dac_align align;
+	void *buf;
+	uint32_t n;		/**< Samples per buffer half */
+	dac_stream_refill_callback refill;
+	void *arg;
+	uint32_t halves;	/**< Halves played */
+	uint32_t underruns;	/**< DMA underruns */
+};
+
 BEGIN_DECLS
 
 void dac_enable(uint32_t dac, int channel);
@@ -269,6 +297,15 @@ void dac_load_data_buffer_single(uint32_t dac, uint16_t data,
 void dac_load_data_buffer_dual(uint32_t dac, uint16_t data1, uint16_t data2,
 			       enum dac_align align);
 void dac_software_trigger(uint32_t dac, int channel);
+void dac_stream_init(struct dac_stream *s, uint32_t dac, int channel,
+		     enum dac_align align, void *buf, uint32_t n,
+		     dac_stream_refill_callback refill, void *arg);
+uint32_t dac_stream_start(struct dac_stream *s, uint32_t timer,
+			  uint32_t timer_clock, uint32_t rate,
+			  uint32_t trigger, dac_stream_dma_callback start);
+void dac_stream_stop(struct dac_stream *s, uint32_t timer);
+void dac_stream_dma_isr(struct dac_stream *s, bool full);
+bool dac_stream_isr(struct dac_stream *s);
 
 END_DECLS
 
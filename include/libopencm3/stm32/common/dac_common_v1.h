@@ -44,6 +44,7 @@ specific memorymap.h header before including this header file.*/
 
 /** TSEL2[2:0]: DAC channel2 trigger selection */
 #define DAC_CR_TSEL2_SHIFT		19
+#define DAC_CR_TSEL2_MASK		(0x7 << DAC_CR_TSEL2_SHIFT)
 /** @defgroup dac_trig2_sel DAC Channel 2 Trigger Source Selection
 @ingroup dac_defines
 
@@ -83,6 +84,7 @@ specific memorymap.h header before including this header file.*/
 
 /* TSEL1[2:0]: DAC channel1 trigger selection */
 #define DAC_CR_TSEL1_SHIFT		3
+#define DAC_CR_TSEL1_MASK		(0x7 << DAC_CR_TSEL1_SHIFT)
 /** @defgroup dac_trig1_sel DAC Channel 1 Trigger Source Selection
 @ingroup dac_defines
 
@@ -78,6 +78,7 @@ specific memorymap.h header before including this header file.*/
 
 /* TSEL2[3:0]: DAC channel2 trigger selection */
 #define DAC_CR_TSEL2_SHIFT		18
+#define DAC_CR_TSEL2_MASK		(0xF << DAC_CR_TSEL2_SHIFT)
 /** @defgroup dac_trig2_sel DAC Channel 2 Trigger Source Selection
 @ingroup dac_defines
 
@@ -126,6 +127,7 @@ specific memorymap.h header before including this header file.*/
 
 /* TSEL1[3:0]: DAC channel1 trigger selection */
 #define DAC_CR_TSEL1_SHIFT		2
+#define DAC_CR_TSEL1_MASK		(0xF << DAC_CR_TSEL1_SHIFT)
 /** @defgroup dac_trig1_sel DAC Channel 1 Trigger Source Selection
 @ingroup dac_defines
 
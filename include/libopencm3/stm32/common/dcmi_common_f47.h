@@ -226,4 +226,47 @@
  */
 #define DCMI_DR				MMIO32(DCMI_BASE + 0x28U)
 
+/* --- API ----------------------------------------------------------------- */
+
+/** A frame has been captured: @p len bytes, the actual size in JPEG mode */
+typedef void (*dcmi_frame_callback)(uint8_t *frame, uint32_t len, void *arg);
+
+/** Line or VSYNC event, @p events DCMI_MIS_LINE and/or DCMI_MIS_VSYNC */
+typedef void (*dcmi_event_callback)(uint32_t events, void *arg);
+
+/** Capture state, see dcmi_capture_init() */
+struct dcmi_capture {
+	uint32_t dma;
+	uint8_t stream;
+	uint8_t *frames[2];
+	uint8_t nframes;
+	uint8_t cur;		/**< Frame being captured */
+	uint16_t nchunks;	/**< DMA transfers per frame buffer */
+	uint16_t done;		/**< Transfers completed in the current frame */
+	uint32_t chunk;		/**< Words per DMA transfer */
+	uint32_t frame_size;	/**< Usable bytes per frame buffer */
+	bool overflow;		/**< Current frame exceeded frame_size */
+	dcmi_frame_callback frame;
+	dcmi_event_callback event;
+	void *arg;
+	uint32_t captured;	/**< Frames captured */
+	uint32_t errors;	/**< Overruns and synchronisation errors */
+};
+
+BEGIN_DECLS
+
+void dcmi_capture_init(struct dcmi_capture *c, uint32_t dma, uint8_t stream,
+		       uint32_t channel, void *frame0, void *frame1,
+		       uint32_t frame_size, dcmi_frame_callback frame,
+		       dcmi_event_callback event, void *arg);
+void dcmi_set_crop(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+void dcmi_disable_crop(void);
+void dcmi_capture_start(struct dcmi_capture *c, uint32_t cr, uint32_t events);
+void dcmi_capture_snapshot(struct dcmi_capture *c);
+void dcmi_capture_stop(struct dcmi_capture *c);
+void dcmi_isr(struct dcmi_capture *c);
+void dcmi_dma_isr(struct dcmi_capture *c);
+
+END_DECLS
+
 /**@}*/
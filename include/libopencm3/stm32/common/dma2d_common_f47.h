@@ -32,6 +32,7 @@
  *
  */
 
+#include <libopencm3/cm3/common.h>
 #include <libopencm3/stm32/memorymap.h>
 #include <stdint.h>
 
@@ -141,7 +142,7 @@
 /** DMA2D Output PFC Control Register */
 #define DMA2D_OPFCCR			MMIO32(DMA2D_BASE + 0x34U)
 #define DMA2D_OPFCCR_CM_SHIFT		0
-#define DMA2D_OPFCCR_CM_MASK		0x3
+#define DMA2D_OPFCCR_CM_MASK		0x7
 #define DMA2D_OPFCCR_CM_ARGB8888	0
 #define DMA2D_OPFCCR_CM_RGB888		1
 #define DMA2D_OPFCCR_CM_RGB565		2
@@ -184,5 +185,57 @@
 /** DMA2D Background Color Lookup table */
 #define DMA2D_BG_CLUT			(uint32_t *)(DMA2D_BASE + 0x800U)
 
+/* --- API -------------------------------------------------------------- */
+
+/** A rectangle of pixels in memory, as source or destination of a transfer */
+struct dma2d_image {
+	const void *addr;	/**< Top left pixel */
+	uint16_t pitch;		/**< Pixels from the start of a line to the next */
+	uint8_t format;		/**< DMA2D_xPFCCR_CM_*, DMA2D_OPFCCR_CM_* for output */
+	uint8_t alpha_mode;	/**< DMA2D_xPFCCR_AM_*, source only */
+	uint8_t alpha;		/**< Constant alpha for alpha_mode, source only */
+	uint16_t clut_size;	/**< CLUT entries, 1 to 256, source only */
+	const uint32_t *clut;	/**< ARGB8888 CLUT of L8/L4/AL44/AL88 sources */
+};
+
+/** A queued transfer, as register values */
+struct dma2d_command {
+	uint32_t cr;
+	uint32_t fgpfccr;
+	uint32_t bgpfccr;
+	uint32_t opfccr;
+	uint32_t fgmar;
+	uint32_t fgor;
+	uint32_t bgmar;
+	uint32_t bgor;
+	uint32_t ocolr;
+	uint32_t omar;
+	uint32_t oor;
+	uint32_t nlr;
+	const uint32_t *fgclut;
+	const uint32_t *bgclut;
+};
+
+/** Called from dma2d_isr() when the queue has run empty */
+typedef void (*dma2d_done_callback)(void *arg);
+
+BEGIN_DECLS
+
+void dma2d_init(struct dma2d_command *queue, uint32_t size,
+		dma2d_done_callback done, void *arg);
+bool dma2d_fill(const struct dma2d_image *dst, uint16_t width,
+		uint16_t height, uint32_t argb);
+bool dma2d_copy(const struct dma2d_image *src, const struct dma2d_image *dst,
+		uint16_t width, uint16_t height);
+bool dma2d_blend(const struct dma2d_image *fg, const struct dma2d_image *bg,
+		 const struct dma2d_image *dst, uint16_t width, uint16_t height);
+bool dma2d_busy(void);
+void dma2d_wait(void);
+void dma2d_invalidate_clut(void);
+uint32_t dma2d_errors(void);
+void dma2d_isr(void);
+
+END_DECLS
+
 /**@}*/
 #endif
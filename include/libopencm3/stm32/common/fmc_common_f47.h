@@ -249,6 +249,41 @@ struct sdram_timing {
 #define SDRAM_MODE_WRITEBURST_MODE_PROGRAMMED	((uint16_t)0x0000)
 #define SDRAM_MODE_WRITEBURST_MODE_SINGLE	((uint16_t)0x0200)
 
+/* SDRAM chip parameters, from its datasheet, for sdram_calc() */
+struct sdram_chip {
+	uint32_t max_freq;	/* Maximum clock, Hz */
+	uint8_t rows;		/* Row address bits, 11 to 13 */
+	uint8_t columns;	/* Column address bits, 8 to 11 */
+	uint8_t banks;		/* Internal banks, 2 or 4 */
+	uint8_t width;		/* Data bus width, 8, 16 or 32 bits */
+	uint8_t cas;		/* CAS latency, 1 to 3 cycles */
+	uint8_t tmrd;		/* Load mode register to active, cycles */
+	uint16_t trcd;		/* Row to column delay, ns */
+	uint16_t trp;		/* Row precharge, ns */
+	uint16_t twr;		/* Write recovery, ns */
+	uint16_t trc;		/* Row cycle, ns */
+	uint16_t tras;		/* Row active, ns */
+	uint16_t txsr;		/* Exit self refresh, ns */
+	uint16_t refresh_ms;	/* Refresh period, ms */
+	uint16_t refresh_rows;	/* Rows refreshed in that period */
+};
+
+/* Register values computed by sdram_calc() for sdram_init() */
+struct sdram_config {
+	uint32_t sdcr;
+	uint32_t sdtr;
+	uint32_t sdrtr;
+	uint16_t mode;		/* Mode register */
+	uint32_t sdclk;		/* SDRAM clock, Hz */
+};
+
+/*
+ * Fill words 32 bit words from addr with value and return when done, eg by
+ * memory to memory DMA, for sdram_march_test()
+ */
+typedef void (*sdram_fill_callback)(uint32_t addr, uint32_t words,
+				    uint32_t value);
+
 enum fmc_sdram_bank { SDRAM_BANK1, SDRAM_BANK2, SDRAM_BOTH_BANKS };
 enum fmc_sdram_command { SDRAM_CLK_CONF, SDRAM_NORMAL, SDRAM_PALL,
 			 SDRAM_AUTO_REFRESH, SDRAM_LOAD_MODE,
@@ -262,6 +297,11 @@ BEGIN_DECLS
 uint32_t sdram_timing(struct sdram_timing *t);
 void sdram_command(enum fmc_sdram_bank bank, enum fmc_sdram_command cmd,
 			int autorefresh, int modereg);
+bool sdram_calc(const struct sdram_chip *chip, uint32_t hclk,
+		struct sdram_config *cfg);
+void sdram_init(enum fmc_sdram_bank bank, const struct sdram_config *cfg);
+uint32_t sdram_march_test(uint32_t base, uint32_t size,
+			  sdram_fill_callback fill);
 
 END_DECLS
 
@@ -31,6 +31,8 @@
 #ifndef LIBOPENCM3_HASH_COMMON_F24_H
 #define LIBOPENCM3_HASH_COMMON_F24_H
 
+#include <stddef.h>
+
 /* --- Convenience macros -------------------------------------------------- */
 
 /****************************************************************************/
@@ -62,8 +64,10 @@
 /* HASH status register (HASH_SR) */
 #define HASH_SR		MMIO32(HASH + 0x28)
 
-/* HASH context swap registers (HASH_CSR[51]) */
-#define HASH_CSR	(&MMIO32(HASH + 0xF8)) /* x51 */
+/* HASH context swap registers (HASH_CSR[54]), 0 to 37 for plain hashes,
+ * all of them for HMAC */
+#define HASH_CSR	(&MMIO32(HASH + 0xF8)) /* x54 */
+#define HASH_CSR_COUNT	54
 
 /* --- HASH_CR values ------------------------------------------------------ */
 
@@ -156,6 +160,35 @@
 /* BUSY: Busy bit */
 #define HASH_SR_BUSY		(1 << 3)
 
+/* --- HASH streaming API -------------------------------------------------- */
+
+/** Words in a processing block */
+#define HASH_BLOCK_WORDS	16
+
+/**
+ * State of one message digest. Any number of contexts can be in progress;
+ * the one using the peripheral is swapped out through HASH_CSR when another
+ * one needs it.
+ */
+struct hash_ctx {
+	uint32_t cr;			/**< Algorithm and mode */
+	uint32_t block[HASH_BLOCK_WORDS];	/**< Bytes not yet written */
+	uint8_t nbytes;
+	bool saved;			/**< State is in the fields below */
+	const uint8_t *key;		/**< HMAC key, NULL for plain hashes */
+	uint32_t keylen;
+	uint32_t imr;
+	uint32_t str;
+	uint32_t csr[HASH_CSR_COUNT];
+};
+
+/**
+ * Start a DMA memory to peripheral transfer of @p n 32 bit words from
+ * @p words to HASH_DIN. The stream is part specific, so it is left to the
+ * application.
+ */
+typedef void (*hash_dma_callback)(const uint32_t *words, size_t n);
+
 /* --- HASH function prototypes -------------------------------------------- */
 
 BEGIN_DECLS
@@ -170,6 +203,16 @@ void hash_add_data(uint32_t data);
 void hash_digest(void);
 void hash_get_result(uint32_t *data);
 
+void hash_ctx_init(struct hash_ctx *ctx, uint8_t algorithm);
+void hash_hmac_init(struct hash_ctx *ctx, uint8_t algorithm,
+		    const uint8_t *key, uint32_t keylen);
+void hash_update(struct hash_ctx *ctx, const void *data, size_t len);
+void hash_final(struct hash_ctx *ctx, uint32_t *digest);
+bool hash_final_dma(struct hash_ctx *ctx, const void *data, size_t len,
+		    hash_dma_callback start);
+void hash_wait_result(struct hash_ctx *ctx, uint32_t *digest);
+void hash_ctx_abort(struct hash_ctx *ctx);
+
 END_DECLS
 /**@}*/
 #endif
@@ -0,0 +1,122 @@
+/** @addtogroup i2c_defines
+ *
+ */
+
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* THIS FILE SHOULD NOT BE INCLUDED DIRECTLY, BUT ONLY VIA I2C.H
+The order of header inclusion is important. i2c.h includes the device
+specific memorymap.h header before including this header file.*/
+
+/**@{*/
+
+/** @cond */
+#ifdef LIBOPENCM3_I2C_H
+/** @endcond */
+#ifndef LIBOPENCM3_I2C_COMMON_ALL_H
+#define LIBOPENCM3_I2C_COMMON_ALL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* --- Interrupt driven transfer queue ------------------------------------- */
+
+/**
+ * Status of a transfer queued with i2c_xfer_submit().
+ */
+enum i2c_xfer_status {
+	I2C_XFER_OK = 0,	/**< completed successfully */
+	I2C_XFER_PENDING,	/**< queued, waiting for the bus */
+	I2C_XFER_ACTIVE,	/**< currently on the bus */
+	I2C_XFER_NACK,		/**< address or data byte was not acknowledged */
+	I2C_XFER_BUS_ERROR,	/**< misplaced start/stop or overrun */
+	I2C_XFER_ARB_LOST,	/**< arbitration lost to another master */
+	I2C_XFER_TIMEOUT,	/**< i2c_xfer_tick() expired, bus was reset */
+};
+
+struct i2c_xfer;
+
+/** Transfer completion callback, run from interrupt context */
+typedef void (*i2c_xfer_callback)(struct i2c_xfer *xfer);
+
+/**
+ * Arm a DMA channel to read @p rn bytes from the data register of @p i2c
+ * into @p r. The channel/stream mapping is part specific, so it is left to
+ * the application.
+ */
+typedef void (*i2c_xfer_dma_callback)(uint32_t i2c, uint8_t *r, size_t rn);
+
+/**
+ * A write/read transaction, as for i2c_transfer7().
+ * The structure belongs to the engine from i2c_xfer_submit() until its
+ * status is neither I2C_XFER_PENDING nor I2C_XFER_ACTIVE.
+ */
+struct i2c_xfer {
+	uint8_t addr;			/**< 7 bit device address */
+	const uint8_t *w;		/**< data to write */
+	size_t wn;			/**< length of w, may be 0 */
+	uint8_t *r;			/**< destination for read data */
+	size_t rn;			/**< bytes to read, may be 0 */
+	uint32_t timeout;		/**< in i2c_xfer_tick() calls, 0 for none */
+	i2c_xfer_callback callback;	/**< may be NULL */
+	void *user;			/**< free for the application */
+	volatile enum i2c_xfer_status status;
+	struct i2c_xfer *next;		/**< private queue link */
+};
+
+/**
+ * Per peripheral transfer queue.
+ * Only i2c, dma_read and dma_threshold are for the application to set,
+ * the rest is engine state.
+ */
+struct i2c_xfer_bus {
+	uint32_t i2c;
+	i2c_xfer_dma_callback dma_read;	/**< may be NULL to never use DMA */
+	size_t dma_threshold;		/**< reads at least this long use DMA */
+	struct i2c_xfer *head;
+	struct i2c_xfer *tail;
+	size_t pos;
+	size_t left;
+	uint32_t ticks;
+	bool reading;
+	bool stop_wait;			/**< START held back for a STOP */
+	enum i2c_xfer_status error;
+};
+
+BEGIN_DECLS
+
+void i2c_xfer_init(struct i2c_xfer_bus *bus, uint32_t i2c);
+void i2c_xfer_submit(struct i2c_xfer_bus *bus, struct i2c_xfer *xfer);
+bool i2c_xfer_idle(struct i2c_xfer_bus *bus);
+void i2c_xfer_isr(struct i2c_xfer_bus *bus);
+void i2c_xfer_tick(struct i2c_xfer_bus *bus);
+
+/** @cond */
+/* Driver specific, for i2c_xfer_submit() */
+void i2c_xfer_start(struct i2c_xfer_bus *bus);
+/** @endcond */
+
+END_DECLS
+
+#endif
+/** @cond */
+#else
+#warning "i2c_common_all.h should not be included explicitly, only via i2c.h"
+#endif
+/** @endcond */
+/**@}*/
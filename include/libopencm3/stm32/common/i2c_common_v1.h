@@ -36,6 +36,7 @@ specific memorymap.h header before including this header file.*/
 
 #include <stddef.h>
 #include <stdint.h>
+#include <libopencm3/stm32/common/i2c_common_all.h>
 
 /* --- Convenience macros -------------------------------------------------- */
 
@@ -416,6 +417,9 @@ void i2c_set_dma_last_transfer(uint32_t i2c);
 void i2c_clear_dma_last_transfer(uint32_t i2c);
 void i2c_transfer7(uint32_t i2c, uint8_t addr, const uint8_t *w, size_t wn, uint8_t *r, size_t rn);
 void i2c_set_speed(uint32_t i2c, enum i2c_speeds speed, uint32_t clock_megahz);
+void i2c_xfer_dma_complete(struct i2c_xfer_bus *bus);
+bool i2c_bus_recover(uint32_t scl_port, uint16_t scl, uint32_t sda_port,
+		     uint16_t sda, uint32_t half_period);
 
 END_DECLS
 
@@ -33,6 +33,7 @@ specific memorymap.h header before including this header file.*/
 
 #include <stddef.h>
 #include <stdint.h>
+#include <libopencm3/stm32/common/i2c_common_all.h>
 
 /* --- Convenience macros -------------------------------------------------- */
 
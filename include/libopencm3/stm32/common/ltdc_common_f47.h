@@ -510,6 +510,45 @@ void ltdc_setup_windowing(
 		uint16_t width,  uint16_t height
 );
 
+/**
+ * layer and framebuffer management
+ */
+
+/** Layer configuration, see ltdc_layer_setup() */
+struct ltdc_layer_config {
+	uint32_t format;	/**< LTDC_LxPFCR_* */
+	uint32_t fb;		/**< Framebuffer address */
+	uint16_t pitch;		/**< Pixels from one line to the next, 0 for width */
+	uint16_t x, y;		/**< Window position in the active area */
+	uint16_t width, height;	/**< Window size */
+	uint8_t alpha;		/**< Constant alpha, 255 for opaque */
+	bool color_key;		/**< Make pixels of color key transparent */
+	uint32_t key;		/**< Color key, RGB888 */
+	const uint32_t *clut;	/**< RGB888 CLUT for L8/AL44/AL88, or NULL */
+	uint16_t clut_size;	/**< CLUT entries */
+};
+
+/** Double or triple buffered layer, see ltdc_flip_init() */
+struct ltdc_flip {
+	uint32_t layer;		/**< @ref ltdc_layer_num */
+	uint32_t buffers[3];
+	uint8_t nbuffers;
+	volatile int8_t front;	/**< Buffer scanned out */
+	volatile int8_t pending;	/**< Buffer shown from the next frame, or -1 */
+	volatile int8_t back;	/**< Buffer to draw into, or -1 */
+};
+
+uint32_t ltdc_pixel_size(uint32_t format);
+void ltdc_layer_setup(uint32_t layer, const struct ltdc_layer_config *cfg);
+void ltdc_vblank_init(void);
+void ltdc_vblank_reload(void);
+uint32_t ltdc_frame_count(void);
+void ltdc_isr(void);
+void ltdc_flip_init(struct ltdc_flip *f, uint32_t layer,
+		    const uint32_t *buffers, uint8_t nbuffers);
+uint32_t ltdc_flip_back_buffer(struct ltdc_flip *f);
+void ltdc_flip_swap(struct ltdc_flip *f);
+
 
 
 /**
@@ -665,6 +665,45 @@ uint16_t quadspi_read_halfword(void);
 @return uint32_t four bytes of data
 */
 uint32_t quadspi_read_word(void);
+
+#ifdef QUADSPI_CR_DMAEN
+/**
+@brief Enable DMA requests from the FIFO
+Only on parts with QUADSPI_CR_DMAEN (F4, F7, G4, L4). Not available on H7, where the MDMA is
+triggered by the FIFO threshold flag instead.
+*/
+void quadspi_enable_dma(void);
+
+/**
+@brief Disable DMA requests from the FIFO
+Only on parts with QUADSPI_CR_DMAEN, see quadspi_enable_dma().
+*/
+void quadspi_disable_dma(void);
+#endif
+
+/**
+@brief Set the polling mask for automatic status-polling mode
+@param[in] mask Unsigned int32. Bits of the status to compare
+*/
+void quadspi_set_polling_mask(uint32_t mask);
+
+/**
+@brief Set the polling match value for automatic status-polling mode
+@param[in] match Unsigned int32. Expected value of the masked status bits
+*/
+void quadspi_set_polling_match(uint32_t match);
+
+/**
+@brief Set the polling interval for automatic status-polling mode
+@param[in] interval Unsigned int16. Number of QuadSPI clock cycles between two reads
+*/
+void quadspi_set_polling_interval(uint16_t interval);
+
+/**
+@brief Set the timeout before nCS is released in memory-mapped mode
+@param[in] cycles Unsigned int16. QuadSPI clock cycles without access, 0 to keep nCS low
+*/
+void quadspi_set_memory_mapped_timeout(uint16_t cycles);
 /**@}*/
 
 
@@ -701,6 +740,61 @@ uint32_t quadspi_write(struct quadspi_command *command, const void *buffer, uint
 */
 uint32_t quadspi_read(struct quadspi_command *command, void *buffer, uint32_t buffer_size);
 
+/**
+@brief Switch to memory-mapped mode
+After this, the external FLASH can be read (and code executed from it) directly through the
+QuadSPI bank in the memory map, without any further register access. The command is used
+for every read, with the address taken from the bus access. Leave memory-mapped mode with
+quadspi_abort().
+@param[in] command struct quadspi_command*. Pointer to the read command, address.address is ignored.
+@return bool: false if the command is invalid.
+*/
+bool quadspi_memory_mapped(struct quadspi_command *command);
+
+/**
+@brief Start automatic status-polling
+The command (typically "read status register") is repeated every interval clock cycles until
+(status & mask) == match, then the status match flag is set and polling stops. Wait for this
+with quadspi_status_polling_done() or the QUADSPI_CR_SMIE interrupt instead of issuing the
+reads from the CPU, eg for program and erase completion.
+@param[in] command struct quadspi_command*. Pointer to the status read command.
+@param[in] mask Unsigned int32. Bits of the status to compare.
+@param[in] match Unsigned int32. Expected value of the masked status bits.
+@param[in] size Unsigned int32. Size of the status in bytes, 1..4.
+@param[in] interval Unsigned int16. Number of QuadSPI clock cycles between two reads.
+@return bool: false if the command or size is invalid.
+*/
+bool quadspi_start_status_polling(struct quadspi_command *command, uint32_t mask,
+				  uint32_t match, uint32_t size, uint16_t interval);
+
+/**
+@brief Check for the end of automatic status-polling
+Clears the status match flag when it is found set.
+@return bool: true if the status matched.
+*/
+bool quadspi_status_polling_done(void);
+
+/**
+@brief Start a DMA driven read from the QuadSPI interface
+The DMA channel must already be configured for buffer_size bytes from QUADSPI_DR and enabled,
+and DMA requests enabled with quadspi_enable_dma() (on H7, the MDMA triggered by the FIFO
+threshold flag). This only issues the command and returns immediately; the end of the transfer
+is signalled by the DMA and the transfer complete flag.
+@param[in] command struct quadspi_command*. Pointer to the command struct.
+@param[in] buffer_size Unsigned int32. Number of bytes to read.
+@return bool: false if the command is invalid.
+*/
+bool quadspi_read_dma(struct quadspi_command *command, uint32_t buffer_size);
+
+/**
+@brief Start a DMA driven write to the QuadSPI interface
+As quadspi_read_dma(), with the DMA channel configured to write to QUADSPI_DR.
+@param[in] command struct quadspi_command*. Pointer to the command struct.
+@param[in] buffer_size Unsigned int32. Number of bytes to write.
+@return bool: false if the command is invalid.
+*/
+bool quadspi_write_dma(struct quadspi_command *command, uint32_t buffer_size);
+
 /**@}*/
 
 
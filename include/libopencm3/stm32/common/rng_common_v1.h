@@ -69,6 +69,16 @@ specific memorymap.h header before including this header file.*/
 /* Seed error interrupt status */
 #define RNG_SR_SEIS		(1 << 6)
 
+/* --- Software DRBG -------------------------------------------------------- */
+
+/** ChaCha20 based generator state, see rng_drbg_init() */
+struct rng_drbg {
+	uint32_t key[8];
+	uint64_t counter;
+	uint32_t generated;	/* Bytes since the last reseed */
+	uint32_t reseed_interval;
+};
+
 /* --- Function prototypes ------------------------------------------------- */
 
 BEGIN_DECLS
@@ -80,6 +90,15 @@ void rng_interrupt_disable(void);
 bool rng_get_random(uint32_t *rand_nr);
 uint32_t rng_get_random_blocking(void);
 
+void rng_pool_init(uint32_t *buf, uint32_t nwords);
+uint32_t rng_pool_level(void);
+void rng_isr(void);
+void rng_fill(void *buf, uint32_t len);
+
+void rng_drbg_init(struct rng_drbg *d, uint32_t reseed_interval);
+void rng_drbg_reseed(struct rng_drbg *d);
+void rng_drbg_generate(struct rng_drbg *d, void *buf, uint32_t len);
+
 END_DECLS
 
 /**@}*/
@@ -91,6 +91,15 @@ BEGIN_DECLS
 void crypto_context_swap(uint32_t *buf);
 void crypto_set_mac_algorithm(enum crypto_mode_mac mode);
 
+void crypto_gcm_start(struct crypto_session *s, const uint8_t *iv,
+		      const uint8_t *aad, uint32_t aadlen);
+void crypto_gcm_finish(uint8_t *tag);
+void crypto_ccm_start(struct crypto_session *s, const uint8_t *nonce,
+		      uint32_t noncelen, const uint8_t *aad, uint32_t aadlen,
+		      uint32_t len, uint32_t taglen);
+void crypto_ccm_finish(uint8_t *tag);
+void crypto_aead_update(const uint8_t *in, uint8_t *out, uint32_t len);
+
 END_DECLS
 /**@}*/
 /**@}*/
@@ -1130,6 +1130,12 @@ void rcc_set_main_pll_hse(uint32_t pllm, uint32_t plln, uint32_t pllp,
 			  uint32_t pllq, uint32_t pllr);
 uint32_t rcc_system_clock_source(void);
 void rcc_clock_setup_pll(const struct rcc_clock_scale *clock);
+bool rcc_clock_solve(uint32_t source_freq, uint8_t pll_source,
+		     uint32_t sysclk, bool usb48,
+		     struct rcc_clock_scale *clock);
+uint32_t rcc_plli2s_solve(const struct rcc_clock_scale *clock,
+			  uint32_t source_freq, uint32_t i2s_freq,
+			  uint16_t *n, uint8_t *r);
 void __attribute__((deprecated("Use rcc_clock_setup_pll as direct replacement"))) rcc_clock_setup_hse_3v3(const struct rcc_clock_scale *clock);
 uint32_t rcc_get_usart_clk_freq(uint32_t usart);
 uint32_t rcc_get_timer_clk_freq(uint32_t timer);
@@ -188,6 +188,13 @@ BEGIN_DECLS
 void adc_set_multi_mode(uint32_t mode);
 void adc_enable_vbat_sensor(void);
 void adc_disable_vbat_sensor(void);
+uint32_t adc_interleave_delay(uint8_t nadcs, uint8_t time, uint32_t resolution);
+uint32_t adc_interleave_init(struct adc_acq *acq, uint8_t nadcs,
+			     uint8_t channel, uint8_t time, uint32_t resolution,
+			     uint32_t adcclk, uint16_t *buf, uint32_t nsamples,
+			     adc_acq_block_callback block, void *arg);
+void adc_interleave_start(struct adc_acq *acq, adc_acq_dma_callback start);
+void adc_interleave_stop(struct adc_acq *acq);
 
 END_DECLS
 
@@ -8,8 +8,10 @@
 #pragma once
 
 #include <libopencm3/stm32/memorymap.h>
-#include <libopencm3/stm32/common/quadspi_common_v1.h>
 
+/* Ahead of the common header, which declares the DMA helpers only if set */
 #define QUADSPI_CR_DMAEN    (1 << 2)
 
+#include <libopencm3/stm32/common/quadspi_common_v1.h>
+
 /**@}*/
\ No newline at end of file
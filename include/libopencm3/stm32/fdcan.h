@@ -653,6 +653,25 @@ struct fdcan_extended_filter {
 #define FDCAN_EFID2_SHIFT				0
 #define FDCAN_EFID2_MASK				0x1FFFFFFF
 
+/** Identifier range to be accepted, input of @ref fdcan_filter_compile.
+ * Single ID is described by id_last equal to id.
+ */
+struct fdcan_filter_rule {
+	uint32_t id;
+	uint32_t id_last;
+	bool ext;
+};
+
+/** Outcome of @ref fdcan_filter_compile. */
+struct fdcan_filter_report {
+	/** Amount of standard ID filter elements used */
+	uint32_t std_filters;
+	/** Amount of extended ID filter elements used */
+	uint32_t ext_filters;
+	/** Amount of IDs accepted, which are not covered by any rule */
+	uint32_t false_accepts;
+};
+
 /** Structure describing receive FIFO element.
  * Receive FIFO element consists of 2 32bit values for header
  * and 16 32bit values for message payload.
@@ -724,6 +743,63 @@ struct fdcan_tx_buffer_element {
 #define FDCAN_FIFO_RXTS_SHIFT			0
 #define FDCAN_FIFO_RXTS_MASK			0xFFFF
 
+/** ET[1:0]: Transmit event type */
+#define FDCAN_FIFO_ET_SHIFT				22
+#define FDCAN_FIFO_ET_MASK				0x3
+
+#define FDCAN_FIFO_TXTS_SHIFT			0
+#define FDCAN_FIFO_TXTS_MASK			0xFFFF
+
+/** Frame as handled by batched transmit and receive functions.
+ *
+ * Payload directly follows 32bit identifier, so it is always word aligned.
+ */
+struct fdcan_frame {
+	/** Standard or extended message ID */
+	uint32_t id;
+	/** Message payload, length bytes are valid */
+	uint8_t data[64];
+	/** Receive timestamp */
+	uint16_t timestamp;
+	/** Payload length in bytes. Must be valid CAN or FDCAN frame length */
+	uint8_t length;
+	/** Index of filter which accepted received frame */
+	uint8_t fmi;
+	/** Message marker copied into transmit event */
+	uint8_t marker;
+	/** Message ID is extended */
+	bool ext;
+	/** Remote transmission request */
+	bool rtr;
+	/** Frame uses FDCAN format */
+	bool fdf;
+	/** Bitrate is switched for data portion of frame */
+	bool brs;
+	/** Store transmit event once frame is sent */
+	bool event;
+};
+
+/** Transmit event as read by @ref fdcan_read_tx_events. */
+struct fdcan_tx_event {
+	/** Message ID of transmitted frame */
+	uint32_t id;
+	/** Transmit timestamp */
+	uint16_t timestamp;
+	/** Message marker of transmitted frame */
+	uint8_t marker;
+	/** Payload length in bytes */
+	uint8_t length;
+	/** Event type, 1 for transmitted frame, 2 for frame transmitted in spite
+	 * of cancellation */
+	uint8_t type;
+	/** Message ID is extended */
+	bool ext;
+	/** Frame used FDCAN format */
+	bool fdf;
+	/** Bitrate was switched for data portion of frame */
+	bool brs;
+};
+
 
 /** @defgroup fdcan_error FDCAN error return values
  * @{
@@ -780,6 +856,11 @@ void fdcan_set_ext_filter(uint32_t canport, uint32_t nr,
 		uint8_t id_list_mode, uint32_t id1, uint32_t id2,
 		uint8_t action);
 
+int fdcan_filter_compile(uint32_t canport, const struct fdcan_filter_rule *rules,
+		uint32_t nrules, struct fdcan_filter_rule *work, uint32_t work_size,
+		uint32_t std_filt, uint32_t ext_filt, uint8_t fifo,
+		struct fdcan_filter_report *report);
+
 void fdcan_enable_irq(uint32_t canport, uint32_t irq);
 void fdcan_disable_irq(uint32_t canport, uint32_t irq);
 
@@ -792,8 +873,16 @@ int fdcan_receive(uint32_t canport, uint8_t fifo, bool release, uint32_t *id,
 
 void fdcan_release_fifo(uint32_t canport, uint8_t fifo);
 
+int fdcan_transmit_batch(uint32_t canport, const struct fdcan_frame *frames,
+		unsigned count);
+int fdcan_receive_batch(uint32_t canport, uint8_t fifo_id,
+		struct fdcan_frame *frames, unsigned max);
+int fdcan_read_tx_events(uint32_t canport, struct fdcan_tx_event *events,
+		unsigned max);
+
 bool fdcan_available_tx(uint32_t canport);
 bool fdcan_available_rx(uint32_t canport, uint8_t fifo);
+void fdcan_get_error_counters(uint32_t canport, uint8_t *tec, uint8_t *rec);
 
 int fdcan_cccr_init_cfg(uint32_t canport, bool set, uint32_t timeout);
 struct fdcan_standard_filter *fdcan_get_flssa_addr(uint32_t canport);
@@ -806,6 +895,10 @@ unsigned fdcan_get_fifo_element_size(uint32_t canport, unsigned fifo_id);
 struct fdcan_tx_event_element *fdcan_get_txevt_addr(uint32_t canport);
 struct fdcan_tx_buffer_element *fdcan_get_txbuf_addr(uint32_t canport, unsigned element_id);
 unsigned fdcan_get_txbuf_element_size(uint32_t canport);
+unsigned fdcan_get_rxfifo_depth(uint32_t canport, unsigned fifo_id);
+unsigned fdcan_get_txevt_depth(uint32_t canport);
+unsigned fdcan_get_txfifo_first(uint32_t canport);
+unsigned fdcan_get_txfifo_depth(uint32_t canport);
 void fdcan_set_fifo_locked_mode(uint32_t canport, bool locked);
 uint32_t fdcan_length_to_dlc(uint8_t length);
 uint8_t fdcan_dlc_to_length(uint32_t dlc);
@@ -135,6 +135,10 @@ LGPL License Terms @ref lgpl_license
 #define FDCAN_XIDFC_FLESA_MASK			FDCAN_FXSA_MASK
 #define FDCAN_XIDFC_FLESA_SHIFT			FDCAN_FXSA_SHIFT
 
+/** NDTB[5:0]: Number of dedicated transmit buffers */
+#define FDCAN_TXBC_NDTB_MASK			0x3F
+#define FDCAN_TXBC_NDTB_SHIFT			16
+
 /** TFQS[5:0]: Tx FIFO/Queue size */
 #define FDCAN_TXBC_TFQS_MASK			0x3F
 #define FDCAN_TXBC_TFQS_SHIFT			24
@@ -35,6 +35,7 @@
 
 #include <libopencm3/stm32/common/adc_common_v2.h>
 #include <libopencm3/stm32/common/adc_common_v2_multi.h>
+#include <libopencm3/stm32/common/adc_common_g4l4.h>
 
 /** @defgroup adc_reg_base ADC register base addresses
  * @ingroup adc_defines
@@ -72,6 +73,39 @@
 #define ADC_CFGR1_EXTSEL_MASK		(0xf << ADC_CFGR1_EXTSEL_SHIFT)
 #define ADC_CFGR1_EXTSEL_VAL(x)		((x) << ADC_CFGR1_EXTSEL_SHIFT)
 
+/* ADC_CFGR2 Values ---------------------------------------------------------*/
+
+/** ROVSE: Regular Oversampling Enable */
+#define ADC_CFGR2_ROVSE				(1 << 0)
+
+/** JOVSE: Injected Oversampling Enable */
+#define ADC_CFGR2_JOVSE				(1 << 1)
+
+/** OVSR[2:0]: Oversampling ratio */
+#define ADC_CFGR2_OVSR_SHIFT			2
+#define ADC_CFGR2_OVSR_MASK			(0x7 << ADC_CFGR2_OVSR_SHIFT)
+#define ADC_CFGR2_OVSR_VAL(x)			((x) << ADC_CFGR2_OVSR_SHIFT)
+
+#define ADC_CFGR2_OVSR_2x			ADC_CFGR2_OVSR_VAL(0)
+#define ADC_CFGR2_OVSR_4x			ADC_CFGR2_OVSR_VAL(1)
+#define ADC_CFGR2_OVSR_8x			ADC_CFGR2_OVSR_VAL(2)
+#define ADC_CFGR2_OVSR_16x			ADC_CFGR2_OVSR_VAL(3)
+#define ADC_CFGR2_OVSR_32x			ADC_CFGR2_OVSR_VAL(4)
+#define ADC_CFGR2_OVSR_64x			ADC_CFGR2_OVSR_VAL(5)
+#define ADC_CFGR2_OVSR_128x			ADC_CFGR2_OVSR_VAL(6)
+#define ADC_CFGR2_OVSR_256x			ADC_CFGR2_OVSR_VAL(7)
+
+/** OVSS[3:0]: Oversampling shift */
+#define ADC_CFGR2_OVSS_SHIFT			5
+#define ADC_CFGR2_OVSS_MASK			(0xf << ADC_CFGR2_OVSS_SHIFT)
+#define ADC_CFGR2_OVSS_VAL(x)			((x) << ADC_CFGR2_OVSS_SHIFT)
+
+/** TROVS: Triggered Regular Oversampling */
+#define ADC_CFGR2_TROVS				(1 << 9)
+
+/** ROVSM: Regular Oversampling mode */
+#define ADC_CFGR2_ROVSM				(1 << 10)
+
 
 /****************************************************************************/
 /* ADC_SMPRx ADC Sample Time Selection for Channels */
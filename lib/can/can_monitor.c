@@ -0,0 +1,362 @@
+/** @defgroup can_monitor_file CAN bus monitor
+ *
+ * @brief <b>Traffic, error counter and bus load statistics for CAN</b>
+ *
+ * Target independent instrumentation that works with any of the CAN drivers.
+ * The application reports frames from its receive and transmit complete
+ * paths, samples the error counters (eg can_get_error_counters() or
+ * fdcan_get_error_counters()) and may read a consistent snapshot at any
+ * time.
+ *
+ * Bus load is kept over a sliding window made of a ring of buckets, each
+ * holding the bus time consumed in its interval, in nominal bit times. The
+ * bit count of a frame is estimated from its format and length; stuff bits
+ * are not included, so the figures are a lower bound by up to ~20 %.
+ *
+ * LGPL License Terms @ref lgpl_license
+ */
+
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <libopencm3/cm3/cortex.h>
+#include <libopencm3/can/can_monitor.h>
+
+/**@{*/
+
+/*
+ * Frame lengths in bit times, including the intermission. Classic frames:
+ * SOF, identifier, control, data, CRC (15 + delimiter), ACK, EOF, IFS. FD
+ * frames are split at the bit rate switch points: arbitration and trailer
+ * run at the nominal rate, ESI, DLC, data and the 17/21 bit CRC with stuff
+ * count at the data rate.
+ */
+#define CAN_MONITOR_BITS_STD		47
+#define CAN_MONITOR_BITS_EXT		67
+#define CAN_MONITOR_FD_ARB_STD		17
+#define CAN_MONITOR_FD_ARB_EXT		36
+#define CAN_MONITOR_FD_TRAILER		13
+#define CAN_MONITOR_FD_DATA_SHORT	26
+#define CAN_MONITOR_FD_DATA_LONG	30
+
+static uint32_t can_monitor_frame_bits(const struct can_monitor *mon,
+				       uint8_t length, uint32_t flags)
+{
+	uint32_t data;
+
+	if (!(flags & CAN_MONITOR_FD)) {
+		return ((flags & CAN_MONITOR_EXT) ? CAN_MONITOR_BITS_EXT :
+			CAN_MONITOR_BITS_STD) + 8 * length;
+	}
+
+	data = 8 * length + ((length <= 16) ? CAN_MONITOR_FD_DATA_SHORT :
+			     CAN_MONITOR_FD_DATA_LONG);
+	if ((flags & CAN_MONITOR_BRS) && mon->data_bitrate > mon->bitrate) {
+		/* Express the fast phase in nominal bit times, rounded up */
+		data = (data * mon->bitrate + mon->data_bitrate - 1) /
+		       mon->data_bitrate;
+	}
+	return ((flags & CAN_MONITOR_EXT) ? CAN_MONITOR_FD_ARB_EXT :
+		CAN_MONITOR_FD_ARB_STD) + data + CAN_MONITOR_FD_TRAILER;
+}
+
+/* Bits over ticks as a load in 0.1 %, clamped to 100 % */
+static uint16_t can_monitor_load(const struct can_monitor *mon, uint32_t bits,
+				 uint32_t ticks)
+{
+	uint64_t capacity = (uint64_t)mon->bitrate * ticks;
+	uint64_t load;
+
+	if (!capacity) {
+		return 0;
+	}
+	load = (uint64_t)bits * 1000 * mon->tick_hz / capacity;
+	return (load > 1000) ? 1000 : load;
+}
+
+/* The error counter trend is taken once per complete window */
+static void can_monitor_window_done(struct can_monitor *mon)
+{
+	if (mon->window_bits > mon->peak_bits) {
+		mon->peak_bits = mon->window_bits;
+	}
+	mon->tec_trend = (int16_t)mon->tec - mon->tec_window;
+	mon->rec_trend = (int16_t)mon->rec - mon->rec_window;
+	mon->tec_window = mon->tec;
+	mon->rec_window = mon->rec;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Initialise a CAN bus monitor
+ *
+ * The window covers @p nbuckets * @p bucket_ticks ticks of the application
+ * time base, eg 10 buckets of 100 ticks at 1 kHz for a one second window
+ * that moves in 100 ms steps.
+ *
+ * Frames are counted per identifier class: the 11 bit identifier (the base
+ * identifier for extended frames) shifted right by @p class_shift selects
+ * the class, the last class also takes everything above. With a shift of 8
+ * there are eight classes of 256 identifiers each.
+ *
+ * @param[in] mon Monitor state.
+ * @param[in] bitrate Nominal bit rate in bit/s.
+ * @param[in] data_bitrate FD data phase bit rate in bit/s, 0 for classic CAN.
+ * @param[in] tick_hz Rate of the time base passed as @p now to the monitor.
+ * @param[in] buckets Storage for @p nbuckets window buckets.
+ * @param[in] nbuckets Number of buckets in the window, at least 1.
+ * @param[in] bucket_ticks Length of a bucket in ticks.
+ * @param[in] classes Storage for @p nclasses class counters, may be NULL.
+ * @param[in] nclasses Number of identifier classes.
+ * @param[in] class_shift Identifier to class shift.
+ */
+void can_monitor_init(struct can_monitor *mon, uint32_t bitrate,
+		      uint32_t data_bitrate, uint32_t tick_hz,
+		      uint32_t *buckets, uint8_t nbuckets,
+		      uint32_t bucket_ticks,
+		      struct can_monitor_class *classes, uint8_t nclasses,
+		      uint8_t class_shift)
+{
+	memset(mon, 0, sizeof(*mon));
+	mon->bitrate = bitrate;
+	mon->data_bitrate = data_bitrate;
+	mon->tick_hz = tick_hz;
+	mon->buckets = buckets;
+	mon->nbuckets = nbuckets;
+	mon->bucket_ticks = bucket_ticks;
+	mon->classes = classes;
+	mon->nclasses = classes ? nclasses : 0;
+	mon->class_shift = class_shift;
+	mon->residency_min = 0xFFFF;
+
+	memset(buckets, 0, nbuckets * sizeof(*buckets));
+	if (classes) {
+		memset(classes, 0, nclasses * sizeof(*classes));
+	}
+}
+
+/*
+ * Ticks since the start of the current bucket. A time stamp taken before an
+ * interrupt moved the window on is behind bucket_start, by less than the
+ * window; count it in the current bucket rather than as a wrapped gap of
+ * almost 2^32 ticks. Any other distance is a real gap, however long.
+ */
+static uint32_t can_monitor_elapsed(const struct can_monitor *mon,
+				    uint32_t now)
+{
+	uint32_t behind = mon->bucket_start - now;
+
+	if (behind < mon->nbuckets * mon->bucket_ticks) {
+		return 0;
+	}
+	return now - mon->bucket_start;
+}
+
+/* Move the window on to now, with interrupts masked by the caller */
+static void can_monitor_advance(struct can_monitor *mon, uint32_t now)
+{
+	uint32_t steps = can_monitor_elapsed(mon, now) / mon->bucket_ticks;
+
+	if (steps >= mon->nbuckets) {
+		can_monitor_window_done(mon);
+		memset(mon->buckets, 0, mon->nbuckets * sizeof(*mon->buckets));
+		mon->window_bits = 0;
+		mon->bucket = 0;
+		mon->bucket_start = now;
+		return;
+	}
+
+	while (steps--) {
+		if (++mon->bucket == mon->nbuckets) {
+			mon->bucket = 0;
+			can_monitor_window_done(mon);
+		}
+		mon->window_bits -= mon->buckets[mon->bucket];
+		mon->buckets[mon->bucket] = 0;
+		mon->bucket_start += mon->bucket_ticks;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Advance the bus load window
+ *
+ * Called from can_monitor_frame() and can_monitor_snapshot(); call it
+ * periodically as well so the window also moves while the bus is idle. The
+ * time base may wrap. After a gap longer than the whole window, the window
+ * restarts at @p now. A @p now less than a window behind the current
+ * bucket, as seen when the application and an interrupt race to report,
+ * leaves the window as it is.
+ *
+ * Interrupts are masked while the window moves, so this may be called from
+ * the application while the receive and transmit interrupts report frames.
+ *
+ * @param[in] mon Monitor state.
+ * @param[in] now Current time in ticks.
+ */
+void can_monitor_tick(struct can_monitor *mon, uint32_t now)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+
+	can_monitor_advance(mon, now);
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Account a frame seen on the bus
+ *
+ * Call for every received frame and for every frame whose transmission
+ * completed, from interrupt or thread context. Remote frames are reported
+ * with a @p length of 0.
+ *
+ * @param[in] mon Monitor state.
+ * @param[in] now Current time in ticks.
+ * @param[in] id Frame identifier.
+ * @param[in] length Payload length in bytes.
+ * @param[in] flags Any of @ref can_monitor_flags.
+ */
+void can_monitor_frame(struct can_monitor *mon, uint32_t now, uint32_t id,
+		       uint8_t length, uint32_t flags)
+{
+	uint32_t bits = can_monitor_frame_bits(mon, length, flags);
+	uint32_t mask = cm_mask_interrupts(1);
+
+	can_monitor_advance(mon, now);
+	mon->buckets[mon->bucket] += bits;
+	mon->window_bits += bits;
+
+	if (flags & CAN_MONITOR_TX) {
+		mon->frames_tx++;
+		mon->bytes_tx += length;
+	} else {
+		mon->frames_rx++;
+		mon->bytes_rx += length;
+	}
+
+	if (mon->nclasses) {
+		uint32_t cls = ((flags & CAN_MONITOR_EXT) ? id >> 18 : id) >>
+			       mon->class_shift;
+
+		if (cls >= mon->nclasses) {
+			cls = mon->nclasses - 1;
+		}
+		mon->classes[cls].frames++;
+		mon->classes[cls].bytes += length;
+	}
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Account the time a frame spent queued for transmission
+ *
+ * Both times come from the 16 bit CAN timestamp counter, eg the time the
+ * frame was written to a mailbox (from a receive timestamp or CAN_MSR free
+ * running counter) and its transmit timestamp (CAN_TDTxR TIME, or the
+ * FDCAN TX event timestamp). The counter may wrap once in between.
+ *
+ * @param[in] mon Monitor state.
+ * @param[in] queued Timestamp when the frame was queued.
+ * @param[in] sent Timestamp when the frame was sent.
+ */
+void can_monitor_residency(struct can_monitor *mon, uint16_t queued,
+			   uint16_t sent)
+{
+	uint16_t ticks = sent - queued;
+	uint32_t mask = cm_mask_interrupts(1);
+
+	mon->residency_count++;
+	mon->residency_sum += ticks;
+	if (ticks < mon->residency_min) {
+		mon->residency_min = ticks;
+	}
+	if (ticks > mon->residency_max) {
+		mon->residency_max = ticks;
+	}
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Record a sample of the error counters
+ *
+ * @param[in] mon Monitor state.
+ * @param[in] tec Transmit error counter.
+ * @param[in] rec Receive error counter.
+ */
+void can_monitor_errors(struct can_monitor *mon, uint8_t tec, uint8_t rec)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+
+	mon->tec = tec;
+	mon->rec = rec;
+	if (tec > mon->tec_peak) {
+		mon->tec_peak = tec;
+	}
+	if (rec > mon->rec_peak) {
+		mon->rec_peak = rec;
+	}
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Take a consistent snapshot of the monitor
+ *
+ * Interrupts are masked only while the counters are copied; the load is
+ * computed afterwards. The current load is taken over the older buckets
+ * plus the elapsed part of the current one.
+ *
+ * @param[in] mon Monitor state.
+ * @param[in] now Current time in ticks.
+ * @param[out] snap Snapshot.
+ */
+void can_monitor_snapshot(struct can_monitor *mon, uint32_t now,
+			  struct can_monitor_snapshot *snap)
+{
+	uint32_t window_bits, peak_bits, span, sum;
+	uint32_t mask = cm_mask_interrupts(1);
+
+	can_monitor_advance(mon, now);
+	window_bits = mon->window_bits;
+	peak_bits = mon->peak_bits;
+	span = (mon->nbuckets - 1) * mon->bucket_ticks +
+	       can_monitor_elapsed(mon, now);
+	sum = mon->residency_sum;
+	snap->frames_rx = mon->frames_rx;
+	snap->frames_tx = mon->frames_tx;
+	snap->bytes_rx = mon->bytes_rx;
+	snap->bytes_tx = mon->bytes_tx;
+	snap->tec = mon->tec;
+	snap->rec = mon->rec;
+	snap->tec_peak = mon->tec_peak;
+	snap->rec_peak = mon->rec_peak;
+	snap->tec_trend = mon->tec_trend;
+	snap->rec_trend = mon->rec_trend;
+	snap->residency_count = mon->residency_count;
+	snap->residency_min = mon->residency_min;
+	snap->residency_max = mon->residency_max;
+	cm_mask_interrupts(mask);
+
+	snap->load = can_monitor_load(mon, window_bits, span);
+	snap->load_peak = can_monitor_load(mon, peak_bits,
+					   mon->nbuckets * mon->bucket_ticks);
+	if (snap->residency_count) {
+		snap->residency_avg = sum / snap->residency_count;
+	} else {
+		snap->residency_min = 0;
+		snap->residency_avg = 0;
+	}
+}
+
+/**@}*/
@@ -0,0 +1,197 @@
+/** @defgroup crc_sw_file Software CRC
+ *
+ * @brief <b>Table driven CRC for parts without (a configurable) CRC unit</b>
+ *
+ * The algorithms match the presets of the STM32 CRC unit bit for bit, so
+ * checksums computed here and in hardware can be mixed freely. Each
+ * algorithm, descriptor and table, is generated by scripts/gencrctables
+ * into its own crc_sw_<name>.c, so only those an application names are
+ * linked from the library archive.
+ *
+ * LGPL License Terms @ref lgpl_license
+ */
+
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/crc/crc_sw.h>
+
+/**@{*/
+
+/*
+ * Reflected algorithms keep the CRC in the low bits of the register and
+ * shift right, normal ones keep it left aligned and shift left, so the same
+ * code serves every width.
+ */
+
+/* Byte swap a word loaded from memory, for the MSB first algorithms */
+static uint32_t crc_sw_swap(uint32_t w)
+{
+	return (w >> 24) | ((w >> 8) & 0xff00) | ((w << 8) & 0xff0000) |
+	       (w << 24);
+}
+
+static uint32_t crc_sw_update_reflected(const struct crc_sw_algo *algo,
+					uint32_t crc, const uint8_t *p,
+					size_t len)
+{
+	const uint32_t (*t)[256] = algo->table;
+	const uint32_t *w;
+
+	while (len && ((uintptr_t)p & 3)) {
+		crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+		len--;
+	}
+
+	w = (const uint32_t *)p;
+	if (algo->slices == 8) {
+		while (len >= 8) {
+			uint32_t lo = crc ^ *w++;
+			uint32_t hi = *w++;
+
+			crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^
+			      t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+			      t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^
+			      t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+			len -= 8;
+		}
+	}
+	while (len >= 4) {
+		uint32_t c = crc ^ *w++;
+
+		crc = t[3][c & 0xff] ^ t[2][(c >> 8) & 0xff] ^
+		      t[1][(c >> 16) & 0xff] ^ t[0][c >> 24];
+		len -= 4;
+	}
+
+	p = (const uint8_t *)w;
+	while (len--) {
+		crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+	}
+	return crc;
+}
+
+static uint32_t crc_sw_update_normal(const struct crc_sw_algo *algo,
+				     uint32_t crc, const uint8_t *p,
+				     size_t len)
+{
+	const uint32_t (*t)[256] = algo->table;
+	const uint32_t *w;
+
+	while (len && ((uintptr_t)p & 3)) {
+		crc = (crc << 8) ^ t[0][(crc >> 24) ^ *p++];
+		len--;
+	}
+
+	w = (const uint32_t *)p;
+	if (algo->slices == 8) {
+		while (len >= 8) {
+			uint32_t hi = crc ^ crc_sw_swap(*w++);
+			uint32_t lo = crc_sw_swap(*w++);
+
+			crc = t[7][hi >> 24] ^ t[6][(hi >> 16) & 0xff] ^
+			      t[5][(hi >> 8) & 0xff] ^ t[4][hi & 0xff] ^
+			      t[3][lo >> 24] ^ t[2][(lo >> 16) & 0xff] ^
+			      t[1][(lo >> 8) & 0xff] ^ t[0][lo & 0xff];
+			len -= 8;
+		}
+	}
+	while (len >= 4) {
+		uint32_t c = crc ^ crc_sw_swap(*w++);
+
+		crc = t[3][c >> 24] ^ t[2][(c >> 16) & 0xff] ^
+		      t[1][(c >> 8) & 0xff] ^ t[0][c & 0xff];
+		len -= 4;
+	}
+
+	p = (const uint8_t *)w;
+	while (len--) {
+		crc = (crc << 8) ^ t[0][(crc >> 24) ^ *p++];
+	}
+	return crc;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Start a software CRC calculation
+ *
+ * @param[in] algo Algorithm, eg &crc_sw_crc32.
+ * @returns Initial register value, to pass to crc_sw_update().
+ */
+uint32_t crc_sw_init(const struct crc_sw_algo *algo)
+{
+	if (algo->reflected) {
+		return algo->initial;
+	}
+	return algo->initial << (32 - algo->width);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Add bytes to a software CRC calculation
+ *
+ * @p data needs no particular alignment.
+ *
+ * @param[in] algo Algorithm, as given to crc_sw_init().
+ * @param[in] crc Register value from crc_sw_init() or a previous update.
+ * @param[in] data Bytes to add.
+ * @param[in] len Number of bytes.
+ * @returns New register value.
+ */
+uint32_t crc_sw_update(const struct crc_sw_algo *algo, uint32_t crc,
+		       const void *data, size_t len)
+{
+	if (algo->reflected) {
+		return crc_sw_update_reflected(algo, crc, data, len);
+	}
+	return crc_sw_update_normal(algo, crc, data, len);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Finish a software CRC calculation
+ *
+ * @param[in] algo Algorithm, as given to crc_sw_init().
+ * @param[in] crc Register value from the last crc_sw_update().
+ * @returns The CRC, in the low bits for widths below 32.
+ */
+uint32_t crc_sw_finalize(const struct crc_sw_algo *algo, uint32_t crc)
+{
+	uint32_t mask = (algo->width == 32) ? 0xFFFFFFFF :
+			((1U << algo->width) - 1);
+
+	if (!algo->reflected) {
+		crc >>= 32 - algo->width;
+	}
+	return (crc ^ algo->xor_out) & mask;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Calculate the CRC of a buffer in one go
+ *
+ * @param[in] algo Algorithm, eg &crc_sw_crc32.
+ * @param[in] data Bytes to checksum.
+ * @param[in] len Number of bytes.
+ * @returns The CRC, in the low bits for widths below 32.
+ */
+uint32_t crc_sw_calculate(const struct crc_sw_algo *algo, const void *data,
+			  size_t len)
+{
+	uint32_t crc = crc_sw_init(algo);
+
+	crc = crc_sw_update(algo, crc, data, len);
+	return crc_sw_finalize(algo, crc);
+}
+
+/**@}*/
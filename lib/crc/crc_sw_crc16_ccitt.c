@@ -0,0 +1,285 @@
+/* This file is part of the libopencm3 project.
+ *
+ * It was generated by scripts/gencrctables, do not edit.
+ *
+ * CRC-16/CCITT-FALSE: width 16, polynomial 0x1021, not reflected,
+ * initial 0xffff, final xor 0x0, slice-by-4.
+ */
+
+#include <libopencm3/crc/crc_sw.h>
+
+static const uint32_t crc_sw_table_crc16_ccitt[4][256] = {
+	{
+		0x00000000, 0x10210000, 0x20420000, 0x30630000,
+		0x40840000, 0x50a50000, 0x60c60000, 0x70e70000,
+		0x81080000, 0x91290000, 0xa14a0000, 0xb16b0000,
+		0xc18c0000, 0xd1ad0000, 0xe1ce0000, 0xf1ef0000,
+		0x12310000, 0x02100000, 0x32730000, 0x22520000,
+		0x52b50000, 0x42940000, 0x72f70000, 0x62d60000,
+		0x93390000, 0x83180000, 0xb37b0000, 0xa35a0000,
+		0xd3bd0000, 0xc39c0000, 0xf3ff0000, 0xe3de0000,
+		0x24620000, 0x34430000, 0x04200000, 0x14010000,
+		0x64e60000, 0x74c70000, 0x44a40000, 0x54850000,
+		0xa56a0000, 0xb54b0000, 0x85280000, 0x95090000,
+		0xe5ee0000, 0xf5cf0000, 0xc5ac0000, 0xd58d0000,
+		0x36530000, 0x26720000, 0x16110000, 0x06300000,
+		0x76d70000, 0x66f60000, 0x56950000, 0x46b40000,
+		0xb75b0000, 0xa77a0000, 0x97190000, 0x87380000,
+		0xf7df0000, 0xe7fe0000, 0xd79d0000, 0xc7bc0000,
+		0x48c40000, 0x58e50000, 0x68860000, 0x78a70000,
+		0x08400000, 0x18610000, 0x28020000, 0x38230000,
+		0xc9cc0000, 0xd9ed0000, 0xe98e0000, 0xf9af0000,
+		0x89480000, 0x99690000, 0xa90a0000, 0xb92b0000,
+		0x5af50000, 0x4ad40000, 0x7ab70000, 0x6a960000,
+		0x1a710000, 0x0a500000, 0x3a330000, 0x2a120000,
+		0xdbfd0000, 0xcbdc0000, 0xfbbf0000, 0xeb9e0000,
+		0x9b790000, 0x8b580000, 0xbb3b0000, 0xab1a0000,
+		0x6ca60000, 0x7c870000, 0x4ce40000, 0x5cc50000,
+		0x2c220000, 0x3c030000, 0x0c600000, 0x1c410000,
+		0xedae0000, 0xfd8f0000, 0xcdec0000, 0xddcd0000,
+		0xad2a0000, 0xbd0b0000, 0x8d680000, 0x9d490000,
+		0x7e970000, 0x6eb60000, 0x5ed50000, 0x4ef40000,
+		0x3e130000, 0x2e320000, 0x1e510000, 0x0e700000,
+		0xff9f0000, 0xefbe0000, 0xdfdd0000, 0xcffc0000,
+		0xbf1b0000, 0xaf3a0000, 0x9f590000, 0x8f780000,
+		0x91880000, 0x81a90000, 0xb1ca0000, 0xa1eb0000,
+		0xd10c0000, 0xc12d0000, 0xf14e0000, 0xe16f0000,
+		0x10800000, 0x00a10000, 0x30c20000, 0x20e30000,
+		0x50040000, 0x40250000, 0x70460000, 0x60670000,
+		0x83b90000, 0x93980000, 0xa3fb0000, 0xb3da0000,
+		0xc33d0000, 0xd31c0000, 0xe37f0000, 0xf35e0000,
+		0x02b10000, 0x12900000, 0x22f30000, 0x32d20000,
+		0x42350000, 0x52140000, 0x62770000, 0x72560000,
+		0xb5ea0000, 0xa5cb0000, 0x95a80000, 0x85890000,
+		0xf56e0000, 0xe54f0000, 0xd52c0000, 0xc50d0000,
+		0x34e20000, 0x24c30000, 0x14a00000, 0x04810000,
+		0x74660000, 0x64470000, 0x54240000, 0x44050000,
+		0xa7db0000, 0xb7fa0000, 0x87990000, 0x97b80000,
+		0xe75f0000, 0xf77e0000, 0xc71d0000, 0xd73c0000,
+		0x26d30000, 0x36f20000, 0x06910000, 0x16b00000,
+		0x66570000, 0x76760000, 0x46150000, 0x56340000,
+		0xd94c0000, 0xc96d0000, 0xf90e0000, 0xe92f0000,
+		0x99c80000, 0x89e90000, 0xb98a0000, 0xa9ab0000,
+		0x58440000, 0x48650000, 0x78060000, 0x68270000,
+		0x18c00000, 0x08e10000, 0x38820000, 0x28a30000,
+		0xcb7d0000, 0xdb5c0000, 0xeb3f0000, 0xfb1e0000,
+		0x8bf90000, 0x9bd80000, 0xabbb0000, 0xbb9a0000,
+		0x4a750000, 0x5a540000, 0x6a370000, 0x7a160000,
+		0x0af10000, 0x1ad00000, 0x2ab30000, 0x3a920000,
+		0xfd2e0000, 0xed0f0000, 0xdd6c0000, 0xcd4d0000,
+		0xbdaa0000, 0xad8b0000, 0x9de80000, 0x8dc90000,
+		0x7c260000, 0x6c070000, 0x5c640000, 0x4c450000,
+		0x3ca20000, 0x2c830000, 0x1ce00000, 0x0cc10000,
+		0xef1f0000, 0xff3e0000, 0xcf5d0000, 0xdf7c0000,
+		0xaf9b0000, 0xbfba0000, 0x8fd90000, 0x9ff80000,
+		0x6e170000, 0x7e360000, 0x4e550000, 0x5e740000,
+		0x2e930000, 0x3eb20000, 0x0ed10000, 0x1ef00000,
+	},
+	{
+		0x00000000, 0x33310000, 0x66620000, 0x55530000,
+		0xccc40000, 0xfff50000, 0xaaa60000, 0x99970000,
+		0x89a90000, 0xba980000, 0xefcb0000, 0xdcfa0000,
+		0x456d0000, 0x765c0000, 0x230f0000, 0x103e0000,
+		0x03730000, 0x30420000, 0x65110000, 0x56200000,
+		0xcfb70000, 0xfc860000, 0xa9d50000, 0x9ae40000,
+		0x8ada0000, 0xb9eb0000, 0xecb80000, 0xdf890000,
+		0x461e0000, 0x752f0000, 0x207c0000, 0x134d0000,
+		0x06e60000, 0x35d70000, 0x60840000, 0x53b50000,
+		0xca220000, 0xf9130000, 0xac400000, 0x9f710000,
+		0x8f4f0000, 0xbc7e0000, 0xe92d0000, 0xda1c0000,
+		0x438b0000, 0x70ba0000, 0x25e90000, 0x16d80000,
+		0x05950000, 0x36a40000, 0x63f70000, 0x50c60000,
+		0xc9510000, 0xfa600000, 0xaf330000, 0x9c020000,
+		0x8c3c0000, 0xbf0d0000, 0xea5e0000, 0xd96f0000,
+		0x40f80000, 0x73c90000, 0x269a0000, 0x15ab0000,
+		0x0dcc0000, 0x3efd0000, 0x6bae0000, 0x589f0000,
+		0xc1080000, 0xf2390000, 0xa76a0000, 0x945b0000,
+		0x84650000, 0xb7540000, 0xe2070000, 0xd1360000,
+		0x48a10000, 0x7b900000, 0x2ec30000, 0x1df20000,
+		0x0ebf0000, 0x3d8e0000, 0x68dd0000, 0x5bec0000,
+		0xc27b0000, 0xf14a0000, 0xa4190000, 0x97280000,
+		0x87160000, 0xb4270000, 0xe1740000, 0xd2450000,
+		0x4bd20000, 0x78e30000, 0x2db00000, 0x1e810000,
+		0x0b2a0000, 0x381b0000, 0x6d480000, 0x5e790000,
+		0xc7ee0000, 0xf4df0000, 0xa18c0000, 0x92bd0000,
+		0x82830000, 0xb1b20000, 0xe4e10000, 0xd7d00000,
+		0x4e470000, 0x7d760000, 0x28250000, 0x1b140000,
+		0x08590000, 0x3b680000, 0x6e3b0000, 0x5d0a0000,
+		0xc49d0000, 0xf7ac0000, 0xa2ff0000, 0x91ce0000,
+		0x81f00000, 0xb2c10000, 0xe7920000, 0xd4a30000,
+		0x4d340000, 0x7e050000, 0x2b560000, 0x18670000,
+		0x1b980000, 0x28a90000, 0x7dfa0000, 0x4ecb0000,
+		0xd75c0000, 0xe46d0000, 0xb13e0000, 0x820f0000,
+		0x92310000, 0xa1000000, 0xf4530000, 0xc7620000,
+		0x5ef50000, 0x6dc40000, 0x38970000, 0x0ba60000,
+		0x18eb0000, 0x2bda0000, 0x7e890000, 0x4db80000,
+		0xd42f0000, 0xe71e0000, 0xb24d0000, 0x817c0000,
+		0x91420000, 0xa2730000, 0xf7200000, 0xc4110000,
+		0x5d860000, 0x6eb70000, 0x3be40000, 0x08d50000,
+		0x1d7e0000, 0x2e4f0000, 0x7b1c0000, 0x482d0000,
+		0xd1ba0000, 0xe28b0000, 0xb7d80000, 0x84e90000,
+		0x94d70000, 0xa7e60000, 0xf2b50000, 0xc1840000,
+		0x58130000, 0x6b220000, 0x3e710000, 0x0d400000,
+		0x1e0d0000, 0x2d3c0000, 0x786f0000, 0x4b5e0000,
+		0xd2c90000, 0xe1f80000, 0xb4ab0000, 0x879a0000,
+		0x97a40000, 0xa4950000, 0xf1c60000, 0xc2f70000,
+		0x5b600000, 0x68510000, 0x3d020000, 0x0e330000,
+		0x16540000, 0x25650000, 0x70360000, 0x43070000,
+		0xda900000, 0xe9a10000, 0xbcf20000, 0x8fc30000,
+		0x9ffd0000, 0xaccc0000, 0xf99f0000, 0xcaae0000,
+		0x53390000, 0x60080000, 0x355b0000, 0x066a0000,
+		0x15270000, 0x26160000, 0x73450000, 0x40740000,
+		0xd9e30000, 0xead20000, 0xbf810000, 0x8cb00000,
+		0x9c8e0000, 0xafbf0000, 0xfaec0000, 0xc9dd0000,
+		0x504a0000, 0x637b0000, 0x36280000, 0x05190000,
+		0x10b20000, 0x23830000, 0x76d00000, 0x45e10000,
+		0xdc760000, 0xef470000, 0xba140000, 0x89250000,
+		0x991b0000, 0xaa2a0000, 0xff790000, 0xcc480000,
+		0x55df0000, 0x66ee0000, 0x33bd0000, 0x008c0000,
+		0x13c10000, 0x20f00000, 0x75a30000, 0x46920000,
+		0xdf050000, 0xec340000, 0xb9670000, 0x8a560000,
+		0x9a680000, 0xa9590000, 0xfc0a0000, 0xcf3b0000,
+		0x56ac0000, 0x659d0000, 0x30ce0000, 0x03ff0000,
+	},
+	{
+		0x00000000, 0x37300000, 0x6e600000, 0x59500000,
+		0xdcc00000, 0xebf00000, 0xb2a00000, 0x85900000,
+		0xa9a10000, 0x9e910000, 0xc7c10000, 0xf0f10000,
+		0x75610000, 0x42510000, 0x1b010000, 0x2c310000,
+		0x43630000, 0x74530000, 0x2d030000, 0x1a330000,
+		0x9fa30000, 0xa8930000, 0xf1c30000, 0xc6f30000,
+		0xeac20000, 0xddf20000, 0x84a20000, 0xb3920000,
+		0x36020000, 0x01320000, 0x58620000, 0x6f520000,
+		0x86c60000, 0xb1f60000, 0xe8a60000, 0xdf960000,
+		0x5a060000, 0x6d360000, 0x34660000, 0x03560000,
+		0x2f670000, 0x18570000, 0x41070000, 0x76370000,
+		0xf3a70000, 0xc4970000, 0x9dc70000, 0xaaf70000,
+		0xc5a50000, 0xf2950000, 0xabc50000, 0x9cf50000,
+		0x19650000, 0x2e550000, 0x77050000, 0x40350000,
+		0x6c040000, 0x5b340000, 0x02640000, 0x35540000,
+		0xb0c40000, 0x87f40000, 0xdea40000, 0xe9940000,
+		0x1dad0000, 0x2a9d0000, 0x73cd0000, 0x44fd0000,
+		0xc16d0000, 0xf65d0000, 0xaf0d0000, 0x983d0000,
+		0xb40c0000, 0x833c0000, 0xda6c0000, 0xed5c0000,
+		0x68cc0000, 0x5ffc0000, 0x06ac0000, 0x319c0000,
+		0x5ece0000, 0x69fe0000, 0x30ae0000, 0x079e0000,
+		0x820e0000, 0xb53e0000, 0xec6e0000, 0xdb5e0000,
+		0xf76f0000, 0xc05f0000, 0x990f0000, 0xae3f0000,
+		0x2baf0000, 0x1c9f0000, 0x45cf0000, 0x72ff0000,
+		0x9b6b0000, 0xac5b0000, 0xf50b0000, 0xc23b0000,
+		0x47ab0000, 0x709b0000, 0x29cb0000, 0x1efb0000,
+		0x32ca0000, 0x05fa0000, 0x5caa0000, 0x6b9a0000,
+		0xee0a0000, 0xd93a0000, 0x806a0000, 0xb75a0000,
+		0xd8080000, 0xef380000, 0xb6680000, 0x81580000,
+		0x04c80000, 0x33f80000, 0x6aa80000, 0x5d980000,
+		0x71a90000, 0x46990000, 0x1fc90000, 0x28f90000,
+		0xad690000, 0x9a590000, 0xc3090000, 0xf4390000,
+		0x3b5a0000, 0x0c6a0000, 0x553a0000, 0x620a0000,
+		0xe79a0000, 0xd0aa0000, 0x89fa0000, 0xbeca0000,
+		0x92fb0000, 0xa5cb0000, 0xfc9b0000, 0xcbab0000,
+		0x4e3b0000, 0x790b0000, 0x205b0000, 0x176b0000,
+		0x78390000, 0x4f090000, 0x16590000, 0x21690000,
+		0xa4f90000, 0x93c90000, 0xca990000, 0xfda90000,
+		0xd1980000, 0xe6a80000, 0xbff80000, 0x88c80000,
+		0x0d580000, 0x3a680000, 0x63380000, 0x54080000,
+		0xbd9c0000, 0x8aac0000, 0xd3fc0000, 0xe4cc0000,
+		0x615c0000, 0x566c0000, 0x0f3c0000, 0x380c0000,
+		0x143d0000, 0x230d0000, 0x7a5d0000, 0x4d6d0000,
+		0xc8fd0000, 0xffcd0000, 0xa69d0000, 0x91ad0000,
+		0xfeff0000, 0xc9cf0000, 0x909f0000, 0xa7af0000,
+		0x223f0000, 0x150f0000, 0x4c5f0000, 0x7b6f0000,
+		0x575e0000, 0x606e0000, 0x393e0000, 0x0e0e0000,
+		0x8b9e0000, 0xbcae0000, 0xe5fe0000, 0xd2ce0000,
+		0x26f70000, 0x11c70000, 0x48970000, 0x7fa70000,
+		0xfa370000, 0xcd070000, 0x94570000, 0xa3670000,
+		0x8f560000, 0xb8660000, 0xe1360000, 0xd6060000,
+		0x53960000, 0x64a60000, 0x3df60000, 0x0ac60000,
+		0x65940000, 0x52a40000, 0x0bf40000, 0x3cc40000,
+		0xb9540000, 0x8e640000, 0xd7340000, 0xe0040000,
+		0xcc350000, 0xfb050000, 0xa2550000, 0x95650000,
+		0x10f50000, 0x27c50000, 0x7e950000, 0x49a50000,
+		0xa0310000, 0x97010000, 0xce510000, 0xf9610000,
+		0x7cf10000, 0x4bc10000, 0x12910000, 0x25a10000,
+		0x09900000, 0x3ea00000, 0x67f00000, 0x50c00000,
+		0xd5500000, 0xe2600000, 0xbb300000, 0x8c000000,
+		0xe3520000, 0xd4620000, 0x8d320000, 0xba020000,
+		0x3f920000, 0x08a20000, 0x51f20000, 0x66c20000,
+		0x4af30000, 0x7dc30000, 0x24930000, 0x13a30000,
+		0x96330000, 0xa1030000, 0xf8530000, 0xcf630000,
+	},
+	{
+		0x00000000, 0x76b40000, 0xed680000, 0x9bdc0000,
+		0xcaf10000, 0xbc450000, 0x27990000, 0x512d0000,
+		0x85c30000, 0xf3770000, 0x68ab0000, 0x1e1f0000,
+		0x4f320000, 0x39860000, 0xa25a0000, 0xd4ee0000,
+		0x1ba70000, 0x6d130000, 0xf6cf0000, 0x807b0000,
+		0xd1560000, 0xa7e20000, 0x3c3e0000, 0x4a8a0000,
+		0x9e640000, 0xe8d00000, 0x730c0000, 0x05b80000,
+		0x54950000, 0x22210000, 0xb9fd0000, 0xcf490000,
+		0x374e0000, 0x41fa0000, 0xda260000, 0xac920000,
+		0xfdbf0000, 0x8b0b0000, 0x10d70000, 0x66630000,
+		0xb28d0000, 0xc4390000, 0x5fe50000, 0x29510000,
+		0x787c0000, 0x0ec80000, 0x95140000, 0xe3a00000,
+		0x2ce90000, 0x5a5d0000, 0xc1810000, 0xb7350000,
+		0xe6180000, 0x90ac0000, 0x0b700000, 0x7dc40000,
+		0xa92a0000, 0xdf9e0000, 0x44420000, 0x32f60000,
+		0x63db0000, 0x156f0000, 0x8eb30000, 0xf8070000,
+		0x6e9c0000, 0x18280000, 0x83f40000, 0xf5400000,
+		0xa46d0000, 0xd2d90000, 0x49050000, 0x3fb10000,
+		0xeb5f0000, 0x9deb0000, 0x06370000, 0x70830000,
+		0x21ae0000, 0x571a0000, 0xccc60000, 0xba720000,
+		0x753b0000, 0x038f0000, 0x98530000, 0xeee70000,
+		0xbfca0000, 0xc97e0000, 0x52a20000, 0x24160000,
+		0xf0f80000, 0x864c0000, 0x1d900000, 0x6b240000,
+		0x3a090000, 0x4cbd0000, 0xd7610000, 0xa1d50000,
+		0x59d20000, 0x2f660000, 0xb4ba0000, 0xc20e0000,
+		0x93230000, 0xe5970000, 0x7e4b0000, 0x08ff0000,
+		0xdc110000, 0xaaa50000, 0x31790000, 0x47cd0000,
+		0x16e00000, 0x60540000, 0xfb880000, 0x8d3c0000,
+		0x42750000, 0x34c10000, 0xaf1d0000, 0xd9a90000,
+		0x88840000, 0xfe300000, 0x65ec0000, 0x13580000,
+		0xc7b60000, 0xb1020000, 0x2ade0000, 0x5c6a0000,
+		0x0d470000, 0x7bf30000, 0xe02f0000, 0x969b0000,
+		0xdd380000, 0xab8c0000, 0x30500000, 0x46e40000,
+		0x17c90000, 0x617d0000, 0xfaa10000, 0x8c150000,
+		0x58fb0000, 0x2e4f0000, 0xb5930000, 0xc3270000,
+		0x920a0000, 0xe4be0000, 0x7f620000, 0x09d60000,
+		0xc69f0000, 0xb02b0000, 0x2bf70000, 0x5d430000,
+		0x0c6e0000, 0x7ada0000, 0xe1060000, 0x97b20000,
+		0x435c0000, 0x35e80000, 0xae340000, 0xd8800000,
+		0x89ad0000, 0xff190000, 0x64c50000, 0x12710000,
+		0xea760000, 0x9cc20000, 0x071e0000, 0x71aa0000,
+		0x20870000, 0x56330000, 0xcdef0000, 0xbb5b0000,
+		0x6fb50000, 0x19010000, 0x82dd0000, 0xf4690000,
+		0xa5440000, 0xd3f00000, 0x482c0000, 0x3e980000,
+		0xf1d10000, 0x87650000, 0x1cb90000, 0x6a0d0000,
+		0x3b200000, 0x4d940000, 0xd6480000, 0xa0fc0000,
+		0x74120000, 0x02a60000, 0x997a0000, 0xefce0000,
+		0xbee30000, 0xc8570000, 0x538b0000, 0x253f0000,
+		0xb3a40000, 0xc5100000, 0x5ecc0000, 0x28780000,
+		0x79550000, 0x0fe10000, 0x943d0000, 0xe2890000,
+		0x36670000, 0x40d30000, 0xdb0f0000, 0xadbb0000,
+		0xfc960000, 0x8a220000, 0x11fe0000, 0x674a0000,
+		0xa8030000, 0xdeb70000, 0x456b0000, 0x33df0000,
+		0x62f20000, 0x14460000, 0x8f9a0000, 0xf92e0000,
+		0x2dc00000, 0x5b740000, 0xc0a80000, 0xb61c0000,
+		0xe7310000, 0x91850000, 0x0a590000, 0x7ced0000,
+		0x84ea0000, 0xf25e0000, 0x69820000, 0x1f360000,
+		0x4e1b0000, 0x38af0000, 0xa3730000, 0xd5c70000,
+		0x01290000, 0x779d0000, 0xec410000, 0x9af50000,
+		0xcbd80000, 0xbd6c0000, 0x26b00000, 0x50040000,
+		0x9f4d0000, 0xe9f90000, 0x72250000, 0x04910000,
+		0x55bc0000, 0x23080000, 0xb8d40000, 0xce600000,
+		0x1a8e0000, 0x6c3a0000, 0xf7e60000, 0x81520000,
+		0xd07f0000, 0xa6cb0000, 0x3d170000, 0x4ba30000,
+	},
+};
+
+const struct crc_sw_algo crc_sw_crc16_ccitt = {
+	.width = 16,
+	.reflected = false,
+	.slices = 4,
+	.initial = 0xFFFF,
+	.xor_out = 0x0,
+	.table = crc_sw_table_crc16_ccitt,
+};
@@ -0,0 +1,285 @@
+/* This file is part of the libopencm3 project.
+ *
+ * It was generated by scripts/gencrctables, do not edit.
+ *
+ * CRC-16/MODBUS: width 16, polynomial 0x8005, reflected,
+ * initial 0xffff, final xor 0x0, slice-by-4.
+ */
+
+#include <libopencm3/crc/crc_sw.h>
+
+static const uint32_t crc_sw_table_crc16_modbus[4][256] = {
+	{
+		0x00000000, 0x0000c0c1, 0x0000c181, 0x00000140,
+		0x0000c301, 0x000003c0, 0x00000280, 0x0000c241,
+		0x0000c601, 0x000006c0, 0x00000780, 0x0000c741,
+		0x00000500, 0x0000c5c1, 0x0000c481, 0x00000440,
+		0x0000cc01, 0x00000cc0, 0x00000d80, 0x0000cd41,
+		0x00000f00, 0x0000cfc1, 0x0000ce81, 0x00000e40,
+		0x00000a00, 0x0000cac1, 0x0000cb81, 0x00000b40,
+		0x0000c901, 0x000009c0, 0x00000880, 0x0000c841,
+		0x0000d801, 0x000018c0, 0x00001980, 0x0000d941,
+		0x00001b00, 0x0000dbc1, 0x0000da81, 0x00001a40,
+		0x00001e00, 0x0000dec1, 0x0000df81, 0x00001f40,
+		0x0000dd01, 0x00001dc0, 0x00001c80, 0x0000dc41,
+		0x00001400, 0x0000d4c1, 0x0000d581, 0x00001540,
+		0x0000d701, 0x000017c0, 0x00001680, 0x0000d641,
+		0x0000d201, 0x000012c0, 0x00001380, 0x0000d341,
+		0x00001100, 0x0000d1c1, 0x0000d081, 0x00001040,
+		0x0000f001, 0x000030c0, 0x00003180, 0x0000f141,
+		0x00003300, 0x0000f3c1, 0x0000f281, 0x00003240,
+		0x00003600, 0x0000f6c1, 0x0000f781, 0x00003740,
+		0x0000f501, 0x000035c0, 0x00003480, 0x0000f441,
+		0x00003c00, 0x0000fcc1, 0x0000fd81, 0x00003d40,
+		0x0000ff01, 0x00003fc0, 0x00003e80, 0x0000fe41,
+		0x0000fa01, 0x00003ac0, 0x00003b80, 0x0000fb41,
+		0x00003900, 0x0000f9c1, 0x0000f881, 0x00003840,
+		0x00002800, 0x0000e8c1, 0x0000e981, 0x00002940,
+		0x0000eb01, 0x00002bc0, 0x00002a80, 0x0000ea41,
+		0x0000ee01, 0x00002ec0, 0x00002f80, 0x0000ef41,
+		0x00002d00, 0x0000edc1, 0x0000ec81, 0x00002c40,
+		0x0000e401, 0x000024c0, 0x00002580, 0x0000e541,
+		0x00002700, 0x0000e7c1, 0x0000e681, 0x00002640,
+		0x00002200, 0x0000e2c1, 0x0000e381, 0x00002340,
+		0x0000e101, 0x000021c0, 0x00002080, 0x0000e041,
+		0x0000a001, 0x000060c0, 0x00006180, 0x0000a141,
+		0x00006300, 0x0000a3c1, 0x0000a281, 0x00006240,
+		0x00006600, 0x0000a6c1, 0x0000a781, 0x00006740,
+		0x0000a501, 0x000065c0, 0x00006480, 0x0000a441,
+		0x00006c00, 0x0000acc1, 0x0000ad81, 0x00006d40,
+		0x0000af01, 0x00006fc0, 0x00006e80, 0x0000ae41,
+		0x0000aa01, 0x00006ac0, 0x00006b80, 0x0000ab41,
+		0x00006900, 0x0000a9c1, 0x0000a881, 0x00006840,
+		0x00007800, 0x0000b8c1, 0x0000b981, 0x00007940,
+		0x0000bb01, 0x00007bc0, 0x00007a80, 0x0000ba41,
+		0x0000be01, 0x00007ec0, 0x00007f80, 0x0000bf41,
+		0x00007d00, 0x0000bdc1, 0x0000bc81, 0x00007c40,
+		0x0000b401, 0x000074c0, 0x00007580, 0x0000b541,
+		0x00007700, 0x0000b7c1, 0x0000b681, 0x00007640,
+		0x00007200, 0x0000b2c1, 0x0000b381, 0x00007340,
+		0x0000b101, 0x000071c0, 0x00007080, 0x0000b041,
+		0x00005000, 0x000090c1, 0x00009181, 0x00005140,
+		0x00009301, 0x000053c0, 0x00005280, 0x00009241,
+		0x00009601, 0x000056c0, 0x00005780, 0x00009741,
+		0x00005500, 0x000095c1, 0x00009481, 0x00005440,
+		0x00009c01, 0x00005cc0, 0x00005d80, 0x00009d41,
+		0x00005f00, 0x00009fc1, 0x00009e81, 0x00005e40,
+		0x00005a00, 0x00009ac1, 0x00009b81, 0x00005b40,
+		0x00009901, 0x000059c0, 0x00005880, 0x00009841,
+		0x00008801, 0x000048c0, 0x00004980, 0x00008941,
+		0x00004b00, 0x00008bc1, 0x00008a81, 0x00004a40,
+		0x00004e00, 0x00008ec1, 0x00008f81, 0x00004f40,
+		0x00008d01, 0x00004dc0, 0x00004c80, 0x00008c41,
+		0x00004400, 0x000084c1, 0x00008581, 0x00004540,
+		0x00008701, 0x000047c0, 0x00004680, 0x00008641,
+		0x00008201, 0x000042c0, 0x00004380, 0x00008341,
+		0x00004100, 0x000081c1, 0x00008081, 0x00004040,
+	},
+	{
+		0x00000000, 0x00009001, 0x00006001, 0x0000f000,
+		0x0000c002, 0x00005003, 0x0000a003, 0x00003002,
+		0x0000c007, 0x00005006, 0x0000a006, 0x00003007,
+		0x00000005, 0x00009004, 0x00006004, 0x0000f005,
+		0x0000c00d, 0x0000500c, 0x0000a00c, 0x0000300d,
+		0x0000000f, 0x0000900e, 0x0000600e, 0x0000f00f,
+		0x0000000a, 0x0000900b, 0x0000600b, 0x0000f00a,
+		0x0000c008, 0x00005009, 0x0000a009, 0x00003008,
+		0x0000c019, 0x00005018, 0x0000a018, 0x00003019,
+		0x0000001b, 0x0000901a, 0x0000601a, 0x0000f01b,
+		0x0000001e, 0x0000901f, 0x0000601f, 0x0000f01e,
+		0x0000c01c, 0x0000501d, 0x0000a01d, 0x0000301c,
+		0x00000014, 0x00009015, 0x00006015, 0x0000f014,
+		0x0000c016, 0x00005017, 0x0000a017, 0x00003016,
+		0x0000c013, 0x00005012, 0x0000a012, 0x00003013,
+		0x00000011, 0x00009010, 0x00006010, 0x0000f011,
+		0x0000c031, 0x00005030, 0x0000a030, 0x00003031,
+		0x00000033, 0x00009032, 0x00006032, 0x0000f033,
+		0x00000036, 0x00009037, 0x00006037, 0x0000f036,
+		0x0000c034, 0x00005035, 0x0000a035, 0x00003034,
+		0x0000003c, 0x0000903d, 0x0000603d, 0x0000f03c,
+		0x0000c03e, 0x0000503f, 0x0000a03f, 0x0000303e,
+		0x0000c03b, 0x0000503a, 0x0000a03a, 0x0000303b,
+		0x00000039, 0x00009038, 0x00006038, 0x0000f039,
+		0x00000028, 0x00009029, 0x00006029, 0x0000f028,
+		0x0000c02a, 0x0000502b, 0x0000a02b, 0x0000302a,
+		0x0000c02f, 0x0000502e, 0x0000a02e, 0x0000302f,
+		0x0000002d, 0x0000902c, 0x0000602c, 0x0000f02d,
+		0x0000c025, 0x00005024, 0x0000a024, 0x00003025,
+		0x00000027, 0x00009026, 0x00006026, 0x0000f027,
+		0x00000022, 0x00009023, 0x00006023, 0x0000f022,
+		0x0000c020, 0x00005021, 0x0000a021, 0x00003020,
+		0x0000c061, 0x00005060, 0x0000a060, 0x00003061,
+		0x00000063, 0x00009062, 0x00006062, 0x0000f063,
+		0x00000066, 0x00009067, 0x00006067, 0x0000f066,
+		0x0000c064, 0x00005065, 0x0000a065, 0x00003064,
+		0x0000006c, 0x0000906d, 0x0000606d, 0x0000f06c,
+		0x0000c06e, 0x0000506f, 0x0000a06f, 0x0000306e,
+		0x0000c06b, 0x0000506a, 0x0000a06a, 0x0000306b,
+		0x00000069, 0x00009068, 0x00006068, 0x0000f069,
+		0x00000078, 0x00009079, 0x00006079, 0x0000f078,
+		0x0000c07a, 0x0000507b, 0x0000a07b, 0x0000307a,
+		0x0000c07f, 0x0000507e, 0x0000a07e, 0x0000307f,
+		0x0000007d, 0x0000907c, 0x0000607c, 0x0000f07d,
+		0x0000c075, 0x00005074, 0x0000a074, 0x00003075,
+		0x00000077, 0x00009076, 0x00006076, 0x0000f077,
+		0x00000072, 0x00009073, 0x00006073, 0x0000f072,
+		0x0000c070, 0x00005071, 0x0000a071, 0x00003070,
+		0x00000050, 0x00009051, 0x00006051, 0x0000f050,
+		0x0000c052, 0x00005053, 0x0000a053, 0x00003052,
+		0x0000c057, 0x00005056, 0x0000a056, 0x00003057,
+		0x00000055, 0x00009054, 0x00006054, 0x0000f055,
+		0x0000c05d, 0x0000505c, 0x0000a05c, 0x0000305d,
+		0x0000005f, 0x0000905e, 0x0000605e, 0x0000f05f,
+		0x0000005a, 0x0000905b, 0x0000605b, 0x0000f05a,
+		0x0000c058, 0x00005059, 0x0000a059, 0x00003058,
+		0x0000c049, 0x00005048, 0x0000a048, 0x00003049,
+		0x0000004b, 0x0000904a, 0x0000604a, 0x0000f04b,
+		0x0000004e, 0x0000904f, 0x0000604f, 0x0000f04e,
+		0x0000c04c, 0x0000504d, 0x0000a04d, 0x0000304c,
+		0x00000044, 0x00009045, 0x00006045, 0x0000f044,
+		0x0000c046, 0x00005047, 0x0000a047, 0x00003046,
+		0x0000c043, 0x00005042, 0x0000a042, 0x00003043,
+		0x00000041, 0x00009040, 0x00006040, 0x0000f041,
+	},
+	{
+		0x00000000, 0x0000c051, 0x0000c0a1, 0x000000f0,
+		0x0000c141, 0x00000110, 0x000001e0, 0x0000c1b1,
+		0x0000c281, 0x000002d0, 0x00000220, 0x0000c271,
+		0x000003c0, 0x0000c391, 0x0000c361, 0x00000330,
+		0x0000c501, 0x00000550, 0x000005a0, 0x0000c5f1,
+		0x00000440, 0x0000c411, 0x0000c4e1, 0x000004b0,
+		0x00000780, 0x0000c7d1, 0x0000c721, 0x00000770,
+		0x0000c6c1, 0x00000690, 0x00000660, 0x0000c631,
+		0x0000ca01, 0x00000a50, 0x00000aa0, 0x0000caf1,
+		0x00000b40, 0x0000cb11, 0x0000cbe1, 0x00000bb0,
+		0x00000880, 0x0000c8d1, 0x0000c821, 0x00000870,
+		0x0000c9c1, 0x00000990, 0x00000960, 0x0000c931,
+		0x00000f00, 0x0000cf51, 0x0000cfa1, 0x00000ff0,
+		0x0000ce41, 0x00000e10, 0x00000ee0, 0x0000ceb1,
+		0x0000cd81, 0x00000dd0, 0x00000d20, 0x0000cd71,
+		0x00000cc0, 0x0000cc91, 0x0000cc61, 0x00000c30,
+		0x0000d401, 0x00001450, 0x000014a0, 0x0000d4f1,
+		0x00001540, 0x0000d511, 0x0000d5e1, 0x000015b0,
+		0x00001680, 0x0000d6d1, 0x0000d621, 0x00001670,
+		0x0000d7c1, 0x00001790, 0x00001760, 0x0000d731,
+		0x00001100, 0x0000d151, 0x0000d1a1, 0x000011f0,
+		0x0000d041, 0x00001010, 0x000010e0, 0x0000d0b1,
+		0x0000d381, 0x000013d0, 0x00001320, 0x0000d371,
+		0x000012c0, 0x0000d291, 0x0000d261, 0x00001230,
+		0x00001e00, 0x0000de51, 0x0000dea1, 0x00001ef0,
+		0x0000df41, 0x00001f10, 0x00001fe0, 0x0000dfb1,
+		0x0000dc81, 0x00001cd0, 0x00001c20, 0x0000dc71,
+		0x00001dc0, 0x0000dd91, 0x0000dd61, 0x00001d30,
+		0x0000db01, 0x00001b50, 0x00001ba0, 0x0000dbf1,
+		0x00001a40, 0x0000da11, 0x0000dae1, 0x00001ab0,
+		0x00001980, 0x0000d9d1, 0x0000d921, 0x00001970,
+		0x0000d8c1, 0x00001890, 0x00001860, 0x0000d831,
+		0x0000e801, 0x00002850, 0x000028a0, 0x0000e8f1,
+		0x00002940, 0x0000e911, 0x0000e9e1, 0x000029b0,
+		0x00002a80, 0x0000ead1, 0x0000ea21, 0x00002a70,
+		0x0000ebc1, 0x00002b90, 0x00002b60, 0x0000eb31,
+		0x00002d00, 0x0000ed51, 0x0000eda1, 0x00002df0,
+		0x0000ec41, 0x00002c10, 0x00002ce0, 0x0000ecb1,
+		0x0000ef81, 0x00002fd0, 0x00002f20, 0x0000ef71,
+		0x00002ec0, 0x0000ee91, 0x0000ee61, 0x00002e30,
+		0x00002200, 0x0000e251, 0x0000e2a1, 0x000022f0,
+		0x0000e341, 0x00002310, 0x000023e0, 0x0000e3b1,
+		0x0000e081, 0x000020d0, 0x00002020, 0x0000e071,
+		0x000021c0, 0x0000e191, 0x0000e161, 0x00002130,
+		0x0000e701, 0x00002750, 0x000027a0, 0x0000e7f1,
+		0x00002640, 0x0000e611, 0x0000e6e1, 0x000026b0,
+		0x00002580, 0x0000e5d1, 0x0000e521, 0x00002570,
+		0x0000e4c1, 0x00002490, 0x00002460, 0x0000e431,
+		0x00003c00, 0x0000fc51, 0x0000fca1, 0x00003cf0,
+		0x0000fd41, 0x00003d10, 0x00003de0, 0x0000fdb1,
+		0x0000fe81, 0x00003ed0, 0x00003e20, 0x0000fe71,
+		0x00003fc0, 0x0000ff91, 0x0000ff61, 0x00003f30,
+		0x0000f901, 0x00003950, 0x000039a0, 0x0000f9f1,
+		0x00003840, 0x0000f811, 0x0000f8e1, 0x000038b0,
+		0x00003b80, 0x0000fbd1, 0x0000fb21, 0x00003b70,
+		0x0000fac1, 0x00003a90, 0x00003a60, 0x0000fa31,
+		0x0000f601, 0x00003650, 0x000036a0, 0x0000f6f1,
+		0x00003740, 0x0000f711, 0x0000f7e1, 0x000037b0,
+		0x00003480, 0x0000f4d1, 0x0000f421, 0x00003470,
+		0x0000f5c1, 0x00003590, 0x00003560, 0x0000f531,
+		0x00003300, 0x0000f351, 0x0000f3a1, 0x000033f0,
+		0x0000f241, 0x00003210, 0x000032e0, 0x0000f2b1,
+		0x0000f181, 0x000031d0, 0x00003120, 0x0000f171,
+		0x000030c0, 0x0000f091, 0x0000f061, 0x00003030,
+	},
+	{
+		0x00000000, 0x0000fc01, 0x0000b801, 0x00004400,
+		0x00003001, 0x0000cc00, 0x00008800, 0x00007401,
+		0x00006002, 0x00009c03, 0x0000d803, 0x00002402,
+		0x00005003, 0x0000ac02, 0x0000e802, 0x00001403,
+		0x0000c004, 0x00003c05, 0x00007805, 0x00008404,
+		0x0000f005, 0x00000c04, 0x00004804, 0x0000b405,
+		0x0000a006, 0x00005c07, 0x00001807, 0x0000e406,
+		0x00009007, 0x00006c06, 0x00002806, 0x0000d407,
+		0x0000c00b, 0x00003c0a, 0x0000780a, 0x0000840b,
+		0x0000f00a, 0x00000c0b, 0x0000480b, 0x0000b40a,
+		0x0000a009, 0x00005c08, 0x00001808, 0x0000e409,
+		0x00009008, 0x00006c09, 0x00002809, 0x0000d408,
+		0x0000000f, 0x0000fc0e, 0x0000b80e, 0x0000440f,
+		0x0000300e, 0x0000cc0f, 0x0000880f, 0x0000740e,
+		0x0000600d, 0x00009c0c, 0x0000d80c, 0x0000240d,
+		0x0000500c, 0x0000ac0d, 0x0000e80d, 0x0000140c,
+		0x0000c015, 0x00003c14, 0x00007814, 0x00008415,
+		0x0000f014, 0x00000c15, 0x00004815, 0x0000b414,
+		0x0000a017, 0x00005c16, 0x00001816, 0x0000e417,
+		0x00009016, 0x00006c17, 0x00002817, 0x0000d416,
+		0x00000011, 0x0000fc10, 0x0000b810, 0x00004411,
+		0x00003010, 0x0000cc11, 0x00008811, 0x00007410,
+		0x00006013, 0x00009c12, 0x0000d812, 0x00002413,
+		0x00005012, 0x0000ac13, 0x0000e813, 0x00001412,
+		0x0000001e, 0x0000fc1f, 0x0000b81f, 0x0000441e,
+		0x0000301f, 0x0000cc1e, 0x0000881e, 0x0000741f,
+		0x0000601c, 0x00009c1d, 0x0000d81d, 0x0000241c,
+		0x0000501d, 0x0000ac1c, 0x0000e81c, 0x0000141d,
+		0x0000c01a, 0x00003c1b, 0x0000781b, 0x0000841a,
+		0x0000f01b, 0x00000c1a, 0x0000481a, 0x0000b41b,
+		0x0000a018, 0x00005c19, 0x00001819, 0x0000e418,
+		0x00009019, 0x00006c18, 0x00002818, 0x0000d419,
+		0x0000c029, 0x00003c28, 0x00007828, 0x00008429,
+		0x0000f028, 0x00000c29, 0x00004829, 0x0000b428,
+		0x0000a02b, 0x00005c2a, 0x0000182a, 0x0000e42b,
+		0x0000902a, 0x00006c2b, 0x0000282b, 0x0000d42a,
+		0x0000002d, 0x0000fc2c, 0x0000b82c, 0x0000442d,
+		0x0000302c, 0x0000cc2d, 0x0000882d, 0x0000742c,
+		0x0000602f, 0x00009c2e, 0x0000d82e, 0x0000242f,
+		0x0000502e, 0x0000ac2f, 0x0000e82f, 0x0000142e,
+		0x00000022, 0x0000fc23, 0x0000b823, 0x00004422,
+		0x00003023, 0x0000cc22, 0x00008822, 0x00007423,
+		0x00006020, 0x00009c21, 0x0000d821, 0x00002420,
+		0x00005021, 0x0000ac20, 0x0000e820, 0x00001421,
+		0x0000c026, 0x00003c27, 0x00007827, 0x00008426,
+		0x0000f027, 0x00000c26, 0x00004826, 0x0000b427,
+		0x0000a024, 0x00005c25, 0x00001825, 0x0000e424,
+		0x00009025, 0x00006c24, 0x00002824, 0x0000d425,
+		0x0000003c, 0x0000fc3d, 0x0000b83d, 0x0000443c,
+		0x0000303d, 0x0000cc3c, 0x0000883c, 0x0000743d,
+		0x0000603e, 0x00009c3f, 0x0000d83f, 0x0000243e,
+		0x0000503f, 0x0000ac3e, 0x0000e83e, 0x0000143f,
+		0x0000c038, 0x00003c39, 0x00007839, 0x00008438,
+		0x0000f039, 0x00000c38, 0x00004838, 0x0000b439,
+		0x0000a03a, 0x00005c3b, 0x0000183b, 0x0000e43a,
+		0x0000903b, 0x00006c3a, 0x0000283a, 0x0000d43b,
+		0x0000c037, 0x00003c36, 0x00007836, 0x00008437,
+		0x0000f036, 0x00000c37, 0x00004837, 0x0000b436,
+		0x0000a035, 0x00005c34, 0x00001834, 0x0000e435,
+		0x00009034, 0x00006c35, 0x00002835, 0x0000d434,
+		0x00000033, 0x0000fc32, 0x0000b832, 0x00004433,
+		0x00003032, 0x0000cc33, 0x00008833, 0x00007432,
+		0x00006031, 0x00009c30, 0x0000d830, 0x00002431,
+		0x00005030, 0x0000ac31, 0x0000e831, 0x00001430,
+	},
+};
+
+const struct crc_sw_algo crc_sw_crc16_modbus = {
+	.width = 16,
+	.reflected = true,
+	.slices = 4,
+	.initial = 0xFFFF,
+	.xor_out = 0x0,
+	.table = crc_sw_table_crc16_modbus,
+};
@@ -0,0 +1,285 @@
+/* This file is part of the libopencm3 project.
+ *
+ * It was generated by scripts/gencrctables, do not edit.
+ *
+ * CRC-7/MMC (SD card commands): width 7, polynomial 0x9, not reflected,
+ * initial 0x0, final xor 0x0, slice-by-4.
+ */
+
+#include <libopencm3/crc/crc_sw.h>
+
+static const uint32_t crc_sw_table_crc7_mmc[4][256] = {
+	{
+		0x00000000, 0x12000000, 0x24000000, 0x36000000,
+		0x48000000, 0x5a000000, 0x6c000000, 0x7e000000,
+		0x90000000, 0x82000000, 0xb4000000, 0xa6000000,
+		0xd8000000, 0xca000000, 0xfc000000, 0xee000000,
+		0x32000000, 0x20000000, 0x16000000, 0x04000000,
+		0x7a000000, 0x68000000, 0x5e000000, 0x4c000000,
+		0xa2000000, 0xb0000000, 0x86000000, 0x94000000,
+		0xea000000, 0xf8000000, 0xce000000, 0xdc000000,
+		0x64000000, 0x76000000, 0x40000000, 0x52000000,
+		0x2c000000, 0x3e000000, 0x08000000, 0x1a000000,
+		0xf4000000, 0xe6000000, 0xd0000000, 0xc2000000,
+		0xbc000000, 0xae000000, 0x98000000, 0x8a000000,
+		0x56000000, 0x44000000, 0x72000000, 0x60000000,
+		0x1e000000, 0x0c000000, 0x3a000000, 0x28000000,
+		0xc6000000, 0xd4000000, 0xe2000000, 0xf0000000,
+		0x8e000000, 0x9c000000, 0xaa000000, 0xb8000000,
+		0xc8000000, 0xda000000, 0xec000000, 0xfe000000,
+		0x80000000, 0x92000000, 0xa4000000, 0xb6000000,
+		0x58000000, 0x4a000000, 0x7c000000, 0x6e000000,
+		0x10000000, 0x02000000, 0x34000000, 0x26000000,
+		0xfa000000, 0xe8000000, 0xde000000, 0xcc000000,
+		0xb2000000, 0xa0000000, 0x96000000, 0x84000000,
+		0x6a000000, 0x78000000, 0x4e000000, 0x5c000000,
+		0x22000000, 0x30000000, 0x06000000, 0x14000000,
+		0xac000000, 0xbe000000, 0x88000000, 0x9a000000,
+		0xe4000000, 0xf6000000, 0xc0000000, 0xd2000000,
+		0x3c000000, 0x2e000000, 0x18000000, 0x0a000000,
+		0x74000000, 0x66000000, 0x50000000, 0x42000000,
+		0x9e000000, 0x8c000000, 0xba000000, 0xa8000000,
+		0xd6000000, 0xc4000000, 0xf2000000, 0xe0000000,
+		0x0e000000, 0x1c000000, 0x2a000000, 0x38000000,
+		0x46000000, 0x54000000, 0x62000000, 0x70000000,
+		0x82000000, 0x90000000, 0xa6000000, 0xb4000000,
+		0xca000000, 0xd8000000, 0xee000000, 0xfc000000,
+		0x12000000, 0x00000000, 0x36000000, 0x24000000,
+		0x5a000000, 0x48000000, 0x7e000000, 0x6c000000,
+		0xb0000000, 0xa2000000, 0x94000000, 0x86000000,
+		0xf8000000, 0xea000000, 0xdc000000, 0xce000000,
+		0x20000000, 0x32000000, 0x04000000, 0x16000000,
+		0x68000000, 0x7a000000, 0x4c000000, 0x5e000000,
+		0xe6000000, 0xf4000000, 0xc2000000, 0xd0000000,
+		0xae000000, 0xbc000000, 0x8a000000, 0x98000000,
+		0x76000000, 0x64000000, 0x52000000, 0x40000000,
+		0x3e000000, 0x2c000000, 0x1a000000, 0x08000000,
+		0xd4000000, 0xc6000000, 0xf0000000, 0xe2000000,
+		0x9c000000, 0x8e000000, 0xb8000000, 0xaa000000,
+		0x44000000, 0x56000000, 0x60000000, 0x72000000,
+		0x0c000000, 0x1e000000, 0x28000000, 0x3a000000,
+		0x4a000000, 0x58000000, 0x6e000000, 0x7c000000,
+		0x02000000, 0x10000000, 0x26000000, 0x34000000,
+		0xda000000, 0xc8000000, 0xfe000000, 0xec000000,
+		0x92000000, 0x80000000, 0xb6000000, 0xa4000000,
+		0x78000000, 0x6a000000, 0x5c000000, 0x4e000000,
+		0x30000000, 0x22000000, 0x14000000, 0x06000000,
+		0xe8000000, 0xfa000000, 0xcc000000, 0xde000000,
+		0xa0000000, 0xb2000000, 0x84000000, 0x96000000,
+		0x2e000000, 0x3c000000, 0x0a000000, 0x18000000,
+		0x66000000, 0x74000000, 0x42000000, 0x50000000,
+		0xbe000000, 0xac000000, 0x9a000000, 0x88000000,
+		0xf6000000, 0xe4000000, 0xd2000000, 0xc0000000,
+		0x1c000000, 0x0e000000, 0x38000000, 0x2a000000,
+		0x54000000, 0x46000000, 0x70000000, 0x62000000,
+		0x8c000000, 0x9e000000, 0xa8000000, 0xba000000,
+		0xc4000000, 0xd6000000, 0xe0000000, 0xf2000000,
+	},
+	{
+		0x00000000, 0x16000000, 0x2c000000, 0x3a000000,
+		0x58000000, 0x4e000000, 0x74000000, 0x62000000,
+		0xb0000000, 0xa6000000, 0x9c000000, 0x8a000000,
+		0xe8000000, 0xfe000000, 0xc4000000, 0xd2000000,
+		0x72000000, 0x64000000, 0x5e000000, 0x48000000,
+		0x2a000000, 0x3c000000, 0x06000000, 0x10000000,
+		0xc2000000, 0xd4000000, 0xee000000, 0xf8000000,
+		0x9a000000, 0x8c000000, 0xb6000000, 0xa0000000,
+		0xe4000000, 0xf2000000, 0xc8000000, 0xde000000,
+		0xbc000000, 0xaa000000, 0x90000000, 0x86000000,
+		0x54000000, 0x42000000, 0x78000000, 0x6e000000,
+		0x0c000000, 0x1a000000, 0x20000000, 0x36000000,
+		0x96000000, 0x80000000, 0xba000000, 0xac000000,
+		0xce000000, 0xd8000000, 0xe2000000, 0xf4000000,
+		0x26000000, 0x30000000, 0x0a000000, 0x1c000000,
+		0x7e000000, 0x68000000, 0x52000000, 0x44000000,
+		0xda000000, 0xcc000000, 0xf6000000, 0xe0000000,
+		0x82000000, 0x94000000, 0xae000000, 0xb8000000,
+		0x6a000000, 0x7c000000, 0x46000000, 0x50000000,
+		0x32000000, 0x24000000, 0x1e000000, 0x08000000,
+		0xa8000000, 0xbe000000, 0x84000000, 0x92000000,
+		0xf0000000, 0xe6000000, 0xdc000000, 0xca000000,
+		0x18000000, 0x0e000000, 0x34000000, 0x22000000,
+		0x40000000, 0x56000000, 0x6c000000, 0x7a000000,
+		0x3e000000, 0x28000000, 0x12000000, 0x04000000,
+		0x66000000, 0x70000000, 0x4a000000, 0x5c000000,
+		0x8e000000, 0x98000000, 0xa2000000, 0xb4000000,
+		0xd6000000, 0xc0000000, 0xfa000000, 0xec000000,
+		0x4c000000, 0x5a000000, 0x60000000, 0x76000000,
+		0x14000000, 0x02000000, 0x38000000, 0x2e000000,
+		0xfc000000, 0xea000000, 0xd0000000, 0xc6000000,
+		0xa4000000, 0xb2000000, 0x88000000, 0x9e000000,
+		0xa6000000, 0xb0000000, 0x8a000000, 0x9c000000,
+		0xfe000000, 0xe8000000, 0xd2000000, 0xc4000000,
+		0x16000000, 0x00000000, 0x3a000000, 0x2c000000,
+		0x4e000000, 0x58000000, 0x62000000, 0x74000000,
+		0xd4000000, 0xc2000000, 0xf8000000, 0xee000000,
+		0x8c000000, 0x9a000000, 0xa0000000, 0xb6000000,
+		0x64000000, 0x72000000, 0x48000000, 0x5e000000,
+		0x3c000000, 0x2a000000, 0x10000000, 0x06000000,
+		0x42000000, 0x54000000, 0x6e000000, 0x78000000,
+		0x1a000000, 0x0c000000, 0x36000000, 0x20000000,
+		0xf2000000, 0xe4000000, 0xde000000, 0xc8000000,
+		0xaa000000, 0xbc000000, 0x86000000, 0x90000000,
+		0x30000000, 0x26000000, 0x1c000000, 0x0a000000,
+		0x68000000, 0x7e000000, 0x44000000, 0x52000000,
+		0x80000000, 0x96000000, 0xac000000, 0xba000000,
+		0xd8000000, 0xce000000, 0xf4000000, 0xe2000000,
+		0x7c000000, 0x6a000000, 0x50000000, 0x46000000,
+		0x24000000, 0x32000000, 0x08000000, 0x1e000000,
+		0xcc000000, 0xda000000, 0xe0000000, 0xf6000000,
+		0x94000000, 0x82000000, 0xb8000000, 0xae000000,
+		0x0e000000, 0x18000000, 0x22000000, 0x34000000,
+		0x56000000, 0x40000000, 0x7a000000, 0x6c000000,
+		0xbe000000, 0xa8000000, 0x92000000, 0x84000000,
+		0xe6000000, 0xf0000000, 0xca000000, 0xdc000000,
+		0x98000000, 0x8e000000, 0xb4000000, 0xa2000000,
+		0xc0000000, 0xd6000000, 0xec000000, 0xfa000000,
+		0x28000000, 0x3e000000, 0x04000000, 0x12000000,
+		0x70000000, 0x66000000, 0x5c000000, 0x4a000000,
+		0xea000000, 0xfc000000, 0xc6000000, 0xd0000000,
+		0xb2000000, 0xa4000000, 0x9e000000, 0x88000000,
+		0x5a000000, 0x4c000000, 0x76000000, 0x60000000,
+		0x02000000, 0x14000000, 0x2e000000, 0x38000000,
+	},
+	{
+		0x00000000, 0x5e000000, 0xbc000000, 0xe2000000,
+		0x6a000000, 0x34000000, 0xd6000000, 0x88000000,
+		0xd4000000, 0x8a000000, 0x68000000, 0x36000000,
+		0xbe000000, 0xe0000000, 0x02000000, 0x5c000000,
+		0xba000000, 0xe4000000, 0x06000000, 0x58000000,
+		0xd0000000, 0x8e000000, 0x6c000000, 0x32000000,
+		0x6e000000, 0x30000000, 0xd2000000, 0x8c000000,
+		0x04000000, 0x5a000000, 0xb8000000, 0xe6000000,
+		0x66000000, 0x38000000, 0xda000000, 0x84000000,
+		0x0c000000, 0x52000000, 0xb0000000, 0xee000000,
+		0xb2000000, 0xec000000, 0x0e000000, 0x50000000,
+		0xd8000000, 0x86000000, 0x64000000, 0x3a000000,
+		0xdc000000, 0x82000000, 0x60000000, 0x3e000000,
+		0xb6000000, 0xe8000000, 0x0a000000, 0x54000000,
+		0x08000000, 0x56000000, 0xb4000000, 0xea000000,
+		0x62000000, 0x3c000000, 0xde000000, 0x80000000,
+		0xcc000000, 0x92000000, 0x70000000, 0x2e000000,
+		0xa6000000, 0xf8000000, 0x1a000000, 0x44000000,
+		0x18000000, 0x46000000, 0xa4000000, 0xfa000000,
+		0x72000000, 0x2c000000, 0xce000000, 0x90000000,
+		0x76000000, 0x28000000, 0xca000000, 0x94000000,
+		0x1c000000, 0x42000000, 0xa0000000, 0xfe000000,
+		0xa2000000, 0xfc000000, 0x1e000000, 0x40000000,
+		0xc8000000, 0x96000000, 0x74000000, 0x2a000000,
+		0xaa000000, 0xf4000000, 0x16000000, 0x48000000,
+		0xc0000000, 0x9e000000, 0x7c000000, 0x22000000,
+		0x7e000000, 0x20000000, 0xc2000000, 0x9c000000,
+		0x14000000, 0x4a000000, 0xa8000000, 0xf6000000,
+		0x10000000, 0x4e000000, 0xac000000, 0xf2000000,
+		0x7a000000, 0x24000000, 0xc6000000, 0x98000000,
+		0xc4000000, 0x9a000000, 0x78000000, 0x26000000,
+		0xae000000, 0xf0000000, 0x12000000, 0x4c000000,
+		0x8a000000, 0xd4000000, 0x36000000, 0x68000000,
+		0xe0000000, 0xbe000000, 0x5c000000, 0x02000000,
+		0x5e000000, 0x00000000, 0xe2000000, 0xbc000000,
+		0x34000000, 0x6a000000, 0x88000000, 0xd6000000,
+		0x30000000, 0x6e000000, 0x8c000000, 0xd2000000,
+		0x5a000000, 0x04000000, 0xe6000000, 0xb8000000,
+		0xe4000000, 0xba000000, 0x58000000, 0x06000000,
+		0x8e000000, 0xd0000000, 0x32000000, 0x6c000000,
+		0xec000000, 0xb2000000, 0x50000000, 0x0e000000,
+		0x86000000, 0xd8000000, 0x3a000000, 0x64000000,
+		0x38000000, 0x66000000, 0x84000000, 0xda000000,
+		0x52000000, 0x0c000000, 0xee000000, 0xb0000000,
+		0x56000000, 0x08000000, 0xea000000, 0xb4000000,
+		0x3c000000, 0x62000000, 0x80000000, 0xde000000,
+		0x82000000, 0xdc000000, 0x3e000000, 0x60000000,
+		0xe8000000, 0xb6000000, 0x54000000, 0x0a000000,
+		0x46000000, 0x18000000, 0xfa000000, 0xa4000000,
+		0x2c000000, 0x72000000, 0x90000000, 0xce000000,
+		0x92000000, 0xcc000000, 0x2e000000, 0x70000000,
+		0xf8000000, 0xa6000000, 0x44000000, 0x1a000000,
+		0xfc000000, 0xa2000000, 0x40000000, 0x1e000000,
+		0x96000000, 0xc8000000, 0x2a000000, 0x74000000,
+		0x28000000, 0x76000000, 0x94000000, 0xca000000,
+		0x42000000, 0x1c000000, 0xfe000000, 0xa0000000,
+		0x20000000, 0x7e000000, 0x9c000000, 0xc2000000,
+		0x4a000000, 0x14000000, 0xf6000000, 0xa8000000,
+		0xf4000000, 0xaa000000, 0x48000000, 0x16000000,
+		0x9e000000, 0xc0000000, 0x22000000, 0x7c000000,
+		0x9a000000, 0xc4000000, 0x26000000, 0x78000000,
+		0xf0000000, 0xae000000, 0x4c000000, 0x12000000,
+		0x4e000000, 0x10000000, 0xf2000000, 0xac000000,
+		0x24000000, 0x7a000000, 0x98000000, 0xc6000000,
+	},
+	{
+		0x00000000, 0x06000000, 0x0c000000, 0x0a000000,
+		0x18000000, 0x1e000000, 0x14000000, 0x12000000,
+		0x30000000, 0x36000000, 0x3c000000, 0x3a000000,
+		0x28000000, 0x2e000000, 0x24000000, 0x22000000,
+		0x60000000, 0x66000000, 0x6c000000, 0x6a000000,
+		0x78000000, 0x7e000000, 0x74000000, 0x72000000,
+		0x50000000, 0x56000000, 0x5c000000, 0x5a000000,
+		0x48000000, 0x4e000000, 0x44000000, 0x42000000,
+		0xc0000000, 0xc6000000, 0xcc000000, 0xca000000,
+		0xd8000000, 0xde000000, 0xd4000000, 0xd2000000,
+		0xf0000000, 0xf6000000, 0xfc000000, 0xfa000000,
+		0xe8000000, 0xee000000, 0xe4000000, 0xe2000000,
+		0xa0000000, 0xa6000000, 0xac000000, 0xaa000000,
+		0xb8000000, 0xbe000000, 0xb4000000, 0xb2000000,
+		0x90000000, 0x96000000, 0x9c000000, 0x9a000000,
+		0x88000000, 0x8e000000, 0x84000000, 0x82000000,
+		0x92000000, 0x94000000, 0x9e000000, 0x98000000,
+		0x8a000000, 0x8c000000, 0x86000000, 0x80000000,
+		0xa2000000, 0xa4000000, 0xae000000, 0xa8000000,
+		0xba000000, 0xbc000000, 0xb6000000, 0xb0000000,
+		0xf2000000, 0xf4000000, 0xfe000000, 0xf8000000,
+		0xea000000, 0xec000000, 0xe6000000, 0xe0000000,
+		0xc2000000, 0xc4000000, 0xce000000, 0xc8000000,
+		0xda000000, 0xdc000000, 0xd6000000, 0xd0000000,
+		0x52000000, 0x54000000, 0x5e000000, 0x58000000,
+		0x4a000000, 0x4c000000, 0x46000000, 0x40000000,
+		0x62000000, 0x64000000, 0x6e000000, 0x68000000,
+		0x7a000000, 0x7c000000, 0x76000000, 0x70000000,
+		0x32000000, 0x34000000, 0x3e000000, 0x38000000,
+		0x2a000000, 0x2c000000, 0x26000000, 0x20000000,
+		0x02000000, 0x04000000, 0x0e000000, 0x08000000,
+		0x1a000000, 0x1c000000, 0x16000000, 0x10000000,
+		0x36000000, 0x30000000, 0x3a000000, 0x3c000000,
+		0x2e000000, 0x28000000, 0x22000000, 0x24000000,
+		0x06000000, 0x00000000, 0x0a000000, 0x0c000000,
+		0x1e000000, 0x18000000, 0x12000000, 0x14000000,
+		0x56000000, 0x50000000, 0x5a000000, 0x5c000000,
+		0x4e000000, 0x48000000, 0x42000000, 0x44000000,
+		0x66000000, 0x60000000, 0x6a000000, 0x6c000000,
+		0x7e000000, 0x78000000, 0x72000000, 0x74000000,
+		0xf6000000, 0xf0000000, 0xfa000000, 0xfc000000,
+		0xee000000, 0xe8000000, 0xe2000000, 0xe4000000,
+		0xc6000000, 0xc0000000, 0xca000000, 0xcc000000,
+		0xde000000, 0xd8000000, 0xd2000000, 0xd4000000,
+		0x96000000, 0x90000000, 0x9a000000, 0x9c000000,
+		0x8e000000, 0x88000000, 0x82000000, 0x84000000,
+		0xa6000000, 0xa0000000, 0xaa000000, 0xac000000,
+		0xbe000000, 0xb8000000, 0xb2000000, 0xb4000000,
+		0xa4000000, 0xa2000000, 0xa8000000, 0xae000000,
+		0xbc000000, 0xba000000, 0xb0000000, 0xb6000000,
+		0x94000000, 0x92000000, 0x98000000, 0x9e000000,
+		0x8c000000, 0x8a000000, 0x80000000, 0x86000000,
+		0xc4000000, 0xc2000000, 0xc8000000, 0xce000000,
+		0xdc000000, 0xda000000, 0xd0000000, 0xd6000000,
+		0xf4000000, 0xf2000000, 0xf8000000, 0xfe000000,
+		0xec000000, 0xea000000, 0xe0000000, 0xe6000000,
+		0x64000000, 0x62000000, 0x68000000, 0x6e000000,
+		0x7c000000, 0x7a000000, 0x70000000, 0x76000000,
+		0x54000000, 0x52000000, 0x58000000, 0x5e000000,
+		0x4c000000, 0x4a000000, 0x40000000, 0x46000000,
+		0x04000000, 0x02000000, 0x08000000, 0x0e000000,
+		0x1c000000, 0x1a000000, 0x10000000, 0x16000000,
+		0x34000000, 0x32000000, 0x38000000, 0x3e000000,
+		0x2c000000, 0x2a000000, 0x20000000, 0x26000000,
+	},
+};
+
+const struct crc_sw_algo crc_sw_crc7_mmc = {
+	.width = 7,
+	.reflected = false,
+	.slices = 4,
+	.initial = 0x0,
+	.xor_out = 0x0,
+	.table = crc_sw_table_crc7_mmc,
+};
@@ -36,12 +36,36 @@
 #include <libopencm3/ethernet/phy.h>
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/cm3/nvic.h>
+#include <libopencm3/cm3/cortex.h>
 
 /**@{*/
 
 uint32_t TxBD;
 uint32_t RxBD;
 
+/* Oldest descriptors still lent out: TX awaiting reclaim, RX to the user */
+static uint32_t TxRelBD;
+static uint32_t RxRelBD;
+
+static uint32_t eth_desc_size;
+static uint32_t eth_tx_bufsize;
+static uint32_t eth_rx_bufsize;
+static uint32_t eth_tx_ndesc;
+static uint32_t eth_tx_used;
+static uint32_t eth_tx_done;
+static uint32_t eth_rx_ndesc;
+static uint32_t eth_rx_held;
+static uint32_t eth_tx_ic_every;
+static uint32_t eth_tx_ic_count;
+static uint32_t eth_tx_flags;
+static uint32_t RxLastBD;
+static uint32_t eth_ptp_addend;
+
+static struct eth_timestamp eth_tx_ts;
+static bool eth_tx_ts_valid;
+
+static struct eth_stats eth_stats;
+
 /*---------------------------------------------------------------------------*/
 /** @brief Set MAC to the PHY
  *
@@ -78,6 +102,18 @@ void eth_desc_init(uint8_t *buf, uint32_t nTx, uint32_t nRx, uint32_t cTx,
 
 	memset(buf, 0, nTx * (cTx + sz) + nRx * (cRx + sz));
 
+	eth_desc_size = sz;
+	eth_tx_bufsize = cTx;
+	eth_rx_bufsize = cRx;
+	eth_tx_ndesc = nTx;
+	eth_tx_used = 0;
+	eth_tx_done = 0;
+	eth_rx_ndesc = nRx;
+	eth_rx_held = 0;
+	eth_tx_ic_count = 0;
+	eth_tx_ts_valid = false;
+	RxLastBD = 0;
+
 	/* enable / disable extended frames */
 	if (isext) {
 		ETH_DMABMR |= ETH_DMABMR_EDFE;
@@ -112,10 +148,198 @@ void eth_desc_init(uint8_t *buf, uint32_t nTx, uint32_t nRx, uint32_t cTx,
 	ETH_DES2(bd) = bd + sz;
 	ETH_DES3(bd) = RxBD;
 
+	TxRelBD = TxBD;
+	RxRelBD = RxBD;
 	ETH_DMARDLAR = (uint32_t) RxBD;
 	ETH_DMATDLAR = (uint32_t) TxBD;
 }
 
+/*---------------------------------------------------------------------------*/
+/** @brief Convert a subsecond register value to nanoseconds
+ *
+ * The subsecond counter rolls over at 10^9 with digital rollover, at 2^31
+ * otherwise.
+ */
+static uint32_t eth_ptp_to_ns(uint32_t subsec)
+{
+	subsec &= ETH_PTPTSLR_STSS;
+	if (ETH_PTPTSCR & ETH_PTPTSCR_TSSSR) {
+		return subsec;
+	}
+	return ((uint64_t)subsec * 1000000000) >> 31;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Convert nanoseconds to a subsecond register value
+ */
+static uint32_t eth_ptp_from_ns(uint32_t ns)
+{
+	if (ETH_PTPTSCR & ETH_PTPTSCR_TSSSR) {
+		return ns;
+	}
+	return ((uint64_t)ns << 31) / 1000000000;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Take back transmit descriptors the DMA is done with
+ *
+ * Descriptors pointed at user buffers by eth_tx_sg() get their own buffer
+ * back, and completed frames are counted for eth_tx_reclaim().
+ */
+static void eth_tx_clean(void)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+
+	while (eth_tx_used && !(ETH_DES0(TxRelBD) & ETH_TDES0_OWN)) {
+		uint32_t des0 = ETH_DES0(TxRelBD);
+
+		eth_stats.tx_bytes += ETH_DES1(TxRelBD) & ETH_TDES1_TBS1;
+		if ((des0 & ETH_TDES0_TTSS) && eth_desc_size == ETH_DES_EXT_SIZE) {
+			eth_tx_ts.sec = ETH_DES7(TxRelBD);
+			eth_tx_ts.nsec = eth_ptp_to_ns(ETH_DES6(TxRelBD));
+			eth_tx_ts_valid = true;
+		}
+		if (des0 & ETH_TDES0_LS) {
+			eth_tx_done++;
+			if (des0 & ETH_TDES0_ES) {
+				eth_stats.tx_errors++;
+			} else {
+				eth_stats.tx_frames++;
+			}
+		}
+		ETH_DES2(TxRelBD) = TxRelBD + eth_desc_size;
+		TxRelBD = ETH_DES3(TxRelBD);
+		eth_tx_used--;
+	}
+
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Build TDES0 for a frame about to be queued
+ *
+ * With TX coalescing, only every n-th frame and the frame that fills the
+ * ring request a completion interrupt. Timestamps are written back to
+ * TDES2/3 with standard descriptors, which would break the chain, so they
+ * are only taken with extended descriptors.
+ *
+ * @param[in] nfrags uint32_t Descriptors in the frame
+ * @param[in] flags uint32_t ETH_TDES0_CIC_* and ETH_TDES0_TTSE
+ * @returns uint32_t TDES0 value without FS, LS and OWN
+ */
+static uint32_t eth_tx_des0(uint32_t nfrags, uint32_t flags)
+{
+	uint32_t des0 = ETH_TDES0_TCH | (flags & ETH_TDES0_CIC);
+
+	if ((flags & ETH_TDES0_TTSE) && eth_desc_size == ETH_DES_EXT_SIZE) {
+		des0 |= ETH_TDES0_TTSE;
+	}
+
+	if (eth_tx_ic_every &&
+	    (++eth_tx_ic_count >= eth_tx_ic_every ||
+	     eth_tx_used + nfrags == eth_tx_ndesc)) {
+		eth_tx_ic_count = 0;
+		des0 |= ETH_TDES0_IC;
+	}
+	return des0;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Account descriptors handed to the DMA
+ *
+ * eth_tx_clean() may run from the interrupt handler.
+ */
+static void eth_tx_queued(uint32_t nfrags)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+
+	eth_tx_used += nfrags;
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Resume transmit DMA if it ran out of descriptors
+ */
+static void eth_tx_kick(void)
+{
+	if (ETH_DMASR & ETH_DMASR_TBUS) {
+		ETH_DMASR = ETH_DMASR_TBUS;
+		ETH_DMATPDR = 0;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Resume receive DMA if it ran out of descriptors
+ */
+static void eth_rx_kick(void)
+{
+	if (ETH_DMASR & ETH_DMASR_RBUS) {
+		eth_stats.rx_no_buffer++;
+		ETH_DMASR = ETH_DMASR_RBUS;
+		ETH_DMARPDR = 0;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Borrow the buffer of the next transmit descriptor
+ *
+ * The frame is built in place and sent by eth_tx_submit(), saving the copy
+ * done by eth_tx().
+ *
+ * @param[out] size uint32_t* Capacity of the buffer, may be NULL
+ * @returns uint8_t* Buffer to fill, NULL if no descriptor is free
+ */
+uint8_t *eth_tx_alloc(uint32_t *size)
+{
+	eth_tx_clean();
+	if (eth_tx_used == eth_tx_ndesc) {
+		return NULL;
+	}
+
+	if (size) {
+		*size = eth_tx_bufsize;
+	}
+	return (uint8_t *)(TxBD + eth_desc_size);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Transmit the frame built in the buffer from eth_tx_alloc()
+ *
+ * @param[in] n uint32_t Size of the packet
+ * @param[in] flags uint32_t Checksum insertion mode ETH_TDES0_CIC_*, and
+ *                  ETH_TDES0_TTSE to capture the transmit timestamp
+ * @returns bool true, if success
+ */
+bool eth_tx_submit_flags(uint32_t n, uint32_t flags)
+{
+	if (eth_tx_used == eth_tx_ndesc) {
+		eth_stats.tx_busy++;
+		return false;
+	}
+
+	ETH_DES1(TxBD) = n & ETH_TDES1_TBS1;
+	ETH_DES0(TxBD) = eth_tx_des0(1, flags) | ETH_TDES0_LS | ETH_TDES0_FS |
+			 ETH_TDES0_OWN;
+	TxBD = ETH_DES3(TxBD);
+	eth_tx_queued(1);
+
+	eth_tx_kick();
+	return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Transmit the frame built in the buffer from eth_tx_alloc()
+ *
+ * Checksums are inserted as set up by eth_enable_checksum_offload().
+ *
+ * @param[in] n uint32_t Size of the packet
+ * @returns bool true, if success
+ */
+bool eth_tx_submit(uint32_t n)
+{
+	return eth_tx_submit_flags(n, eth_tx_flags);
+}
+
 /*---------------------------------------------------------------------------*/
 /** @brief Transmit packet
  *
@@ -125,24 +349,128 @@ void eth_desc_init(uint8_t *buf, uint32_t nTx, uint32_t nRx, uint32_t cTx,
  */
 bool eth_tx(uint8_t *ppkt, uint32_t n)
 {
-	if (ETH_DES0(TxBD) & ETH_TDES0_OWN) {
+	uint8_t *buf = eth_tx_alloc(NULL);
+
+	if (!buf) {
+		eth_stats.tx_busy++;
 		return false;
 	}
 
-	memcpy((void *)ETH_DES2(TxBD), ppkt, n);
+	memcpy(buf, ppkt, n);
+	return eth_tx_submit(n);
+}
 
-	ETH_DES1(TxBD) = n & ETH_TDES1_TBS1;
-	ETH_DES0(TxBD) |= ETH_TDES0_LS | ETH_TDES0_FS | ETH_TDES0_OWN;
-	TxBD = ETH_DES3(TxBD);
+/*---------------------------------------------------------------------------*/
+/** @brief Transmit a frame gathered from several buffers
+ *
+ * Each fragment takes one descriptor, which is pointed straight at the user
+ * buffer. The buffers must stay untouched until the frame is reported done
+ * by eth_tx_reclaim().
+ *
+ * @param[in] frags struct eth_frag* Fragments of the frame, in order
+ * @param[in] nfrags uint32_t Number of fragments
+ * @param[in] flags uint32_t Checksum insertion mode ETH_TDES0_CIC_*, and
+ *                  ETH_TDES0_TTSE to capture the transmit timestamp
+ * @returns bool true, if the frame was queued, false if there are not
+ *               enough free descriptors
+ */
+bool eth_tx_sg_flags(const struct eth_frag *frags, uint32_t nfrags,
+		     uint32_t flags)
+{
+	uint32_t first = TxBD;
+	uint32_t bd = TxBD;
+	uint32_t ctrl, i;
 
-	if (ETH_DMASR & ETH_DMASR_TBUS) {
-		ETH_DMASR = ETH_DMASR_TBUS;
-		ETH_DMATPDR = 0;
+	eth_tx_clean();
+	if (nfrags == 0) {
+		return false;
+	}
+	if (eth_tx_ndesc - eth_tx_used < nfrags) {
+		eth_stats.tx_busy++;
+		return false;
+	}
+
+	ctrl = eth_tx_des0(nfrags, flags);
+	for (i = 0; i < nfrags; i++) {
+		uint32_t des0 = ctrl & (ETH_TDES0_TCH | ETH_TDES0_CIC);
+
+		if (i == 0) {
+			des0 |= ETH_TDES0_FS | (ctrl & ETH_TDES0_TTSE);
+		} else {
+			des0 |= ETH_TDES0_OWN;
+		}
+		if (i == nfrags - 1) {
+			des0 |= ETH_TDES0_LS | (ctrl & ETH_TDES0_IC);
+		}
+
+		ETH_DES1(bd) = frags[i].len & ETH_TDES1_TBS1;
+		ETH_DES2(bd) = (uint32_t)frags[i].data;
+		ETH_DES0(bd) = des0;
+		bd = ETH_DES3(bd);
 	}
 
+	/* Hand over the first descriptor last, so the DMA sees a whole chain */
+	ETH_DES0(first) |= ETH_TDES0_OWN;
+	TxBD = bd;
+	eth_tx_queued(nfrags);
+
+	eth_tx_kick();
 	return true;
 }
 
+/*---------------------------------------------------------------------------*/
+/** @brief Transmit a frame gathered from several buffers
+ *
+ * As eth_tx_sg_flags(), with checksums inserted as set up by
+ * eth_enable_checksum_offload().
+ *
+ * @param[in] frags struct eth_frag* Fragments of the frame, in order
+ * @param[in] nfrags uint32_t Number of fragments
+ * @returns bool true, if the frame was queued
+ */
+bool eth_tx_sg(const struct eth_frag *frags, uint32_t nfrags)
+{
+	return eth_tx_sg_flags(frags, nfrags, eth_tx_flags);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Read the timestamp of the last frame sent with ETH_TDES0_TTSE
+ *
+ * The timestamp is picked up when the frame is reclaimed, eg by
+ * eth_tx_reclaim(), and can be read once. Needs extended descriptors.
+ *
+ * @param[out] ts struct eth_timestamp* Transmit time
+ * @returns bool true, if a new timestamp was available
+ */
+bool eth_tx_get_timestamp(struct eth_timestamp *ts)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+	bool valid = eth_tx_ts_valid;
+
+	*ts = eth_tx_ts;
+	eth_tx_ts_valid = false;
+	cm_mask_interrupts(mask);
+	return valid;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Count the frames sent since the last call
+ *
+ * Frames complete in the order they were queued, so the count tells which
+ * buffers given to eth_tx_sg() may be reused.
+ *
+ * @returns uint32_t Number of frames whose transmission finished
+ */
+uint32_t eth_tx_reclaim(void)
+{
+	uint32_t done;
+
+	eth_tx_clean();
+	done = eth_tx_done;
+	eth_tx_done = 0;
+	return done;
+}
+
 /*---------------------------------------------------------------------------*/
 /** @brief Receive packet
  *
@@ -176,13 +504,176 @@ bool eth_rx(uint8_t *ppkt, uint32_t *len, uint32_t maxlen)
 		ETH_DES0(RxBD) = ETH_RDES0_OWN;
 		RxBD = ETH_DES3(RxBD);
 	}
+	RxRelBD = RxBD;
+	eth_rx_held = 0;
 
-	if (ETH_DMASR & ETH_DMASR_RBUS) {
-		ETH_DMASR = ETH_DMASR_RBUS;
-		ETH_DMARPDR = 0;
+	eth_rx_kick();
+
+	if (fs && ls && !overrun) {
+		eth_stats.rx_frames++;
+		return true;
 	}
+	if (ls) {
+		eth_stats.rx_dropped++;
+	}
+	return false;
+}
 
-	return fs && ls && !overrun;
+/*---------------------------------------------------------------------------*/
+/** @brief Give one held receive descriptor back to the DMA
+ *
+ * @returns uint32_t The status the descriptor had
+ */
+static uint32_t eth_rx_return(void)
+{
+	uint32_t des0 = ETH_DES0(RxRelBD);
+
+	ETH_DES0(RxRelBD) = ETH_RDES0_OWN;
+	RxRelBD = ETH_DES3(RxRelBD);
+	eth_rx_held--;
+	return des0;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Give dropped receive descriptors back to the DMA
+ *
+ * Dropped descriptors have their status cleared, and so never carry FS; the
+ * walk stops at the first frame still lent to the user.
+ */
+static void eth_rx_recycle(void)
+{
+	while (eth_rx_held && !(ETH_DES0(RxRelBD) & ETH_RDES0_FS)) {
+		eth_rx_return();
+	}
+	eth_rx_kick();
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Borrow the buffers of the next received frame
+ *
+ * The frame stays in the descriptor buffers until eth_rx_release(). Several
+ * frames may be held at once; they are released in the order received.
+ * Frames with errors or more than @p max fragments are dropped. The copying
+ * eth_rx() must not be used while frames are held.
+ *
+ * @param[out] frags struct eth_frag* Fragments of the frame, in order
+ * @param[in] max uint32_t Size of the @p frags array
+ * @returns uint32_t Number of fragments, 0 if no complete frame is waiting
+ */
+uint32_t eth_rx_get(struct eth_frag *frags, uint32_t max)
+{
+	for (;;) {
+		uint32_t avail = eth_rx_ndesc - eth_rx_held;
+		uint32_t bd = RxBD;
+		uint32_t last = RxBD;
+		uint32_t n = 0;
+		uint32_t des0 = 0;
+
+		while (n < avail) {
+			last = bd;
+			des0 = ETH_DES0(bd);
+			if (des0 & ETH_RDES0_OWN) {
+				/* Nothing, or the rest of the frame is pending */
+				return 0;
+			}
+			if (n < max) {
+				frags[n].data = (uint8_t *)ETH_DES2(bd);
+				frags[n].len = eth_rx_bufsize;
+			}
+			n++;
+			bd = ETH_DES3(bd);
+			if ((des0 & ETH_RDES0_LS) ||
+			    (n < avail && (ETH_DES0(bd) & ETH_RDES0_FS))) {
+				break;
+			}
+		}
+
+		if (!(des0 & ETH_RDES0_LS) && n == avail &&
+		    avail != eth_rx_ndesc) {
+			/* The frame may finish once held ones are released */
+			return 0;
+		}
+
+		if ((ETH_DES0(RxBD) & ETH_RDES0_FS) &&
+		    (des0 & (ETH_RDES0_LS | ETH_RDES0_ES)) == ETH_RDES0_LS &&
+		    n <= max) {
+			frags[n - 1].len = ((des0 & ETH_RDES0_FL) >>
+					    ETH_RDES0_FL_SHIFT) -
+					   (n - 1) * eth_rx_bufsize;
+			/* Status and timestamp live in the last descriptor */
+			RxLastBD = last;
+			RxBD = bd;
+			eth_rx_held += n;
+			eth_stats.rx_frames++;
+			eth_stats.rx_bytes += (des0 & ETH_RDES0_FL) >>
+					      ETH_RDES0_FL_SHIFT;
+			return n;
+		}
+
+		if (n == 0) {
+			return 0;
+		}
+
+		/* Broken or oversized frame, drop it */
+		if ((des0 & ETH_RDES0_ES) && (des0 & ETH_RDES0_LS)) {
+			eth_stats.rx_errors++;
+		} else {
+			eth_stats.rx_dropped++;
+		}
+		eth_rx_held += n;
+		while (n--) {
+			ETH_DES0(RxBD) = 0;
+			RxBD = ETH_DES3(RxBD);
+		}
+		eth_rx_recycle();
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Return the oldest frame from eth_rx_get() to the DMA
+ */
+void eth_rx_release(void)
+{
+	while (eth_rx_held && !(eth_rx_return() & ETH_RDES0_LS));
+
+	eth_rx_recycle();
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Get checksum and timestamp status of the last frame from eth_rx_get()
+ *
+ * Needs extended descriptors; the checksum status also needs
+ * eth_enable_checksum_offload() and the timestamp eth_ptp_init(). Only valid
+ * until the frame is released.
+ *
+ * @param[out] info struct eth_rx_info* Status of the frame
+ * @returns bool true, if extended status was available
+ */
+bool eth_rx_get_info(struct eth_rx_info *info)
+{
+	uint32_t des0, des4;
+
+	memset(info, 0, sizeof(*info));
+	if (!RxLastBD || eth_desc_size != ETH_DES_EXT_SIZE) {
+		return false;
+	}
+
+	des0 = ETH_DES0(RxLastBD);
+	if (des0 & ETH_RDES0_TSV) {
+		info->ts.sec = ETH_DES7(RxLastBD);
+		info->ts.nsec = eth_ptp_to_ns(ETH_DES6(RxLastBD));
+		info->has_ts = true;
+	}
+	if (!(des0 & ETH_RDES0_ESA)) {
+		return true;
+	}
+
+	des4 = ETH_DES4(RxLastBD);
+	info->status = des4;
+	info->checksum_ok = (des4 & (ETH_RDES4_IPV4PR | ETH_RDES4_IPV6PR)) &&
+			    !(des4 & (ETH_RDES4_IPHE | ETH_RDES4_IPPE |
+				      ETH_RDES4_IPCB));
+	return true;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -269,23 +760,282 @@ bool eth_irq_ack_pending(uint32_t reason)
 	return reason != 0;
 }
 
+/*---------------------------------------------------------------------------*/
+/** @brief Collect the missed frame counters of the DMA
+ *
+ * The counters clear on read.
+ */
+static void eth_stats_collect_missed(void)
+{
+	uint32_t reg = ETH_DMAMFBOCR;
+
+	eth_stats.rx_missed += (reg & ETH_DMAMFBOCR_MFC) >>
+			       ETH_DMAMFBOCR_MFC_SHIFT;
+	eth_stats.rx_overruns += (reg & ETH_DMAMFBOCR_MFA) >>
+				 ETH_DMAMFBOCR_MFA_SHIFT;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Set up interrupt driven operation
+ *
+ * Enables the receive, transmit and error interrupts handled by
+ * eth_irq_process(). Call after eth_desc_init(); the NVIC line has to be
+ * enabled by the application.
+ *
+ * Receive interrupts can be coalesced with the receive watchdog: when
+ * @p rx_watchdog is not zero, descriptors do not interrupt on completion;
+ * instead the interrupt fires @p rx_watchdog * 256 HCLK cycles after a frame
+ * arrived. Not available on STM32F1, where every frame interrupts.
+ *
+ * Transmit interrupts are requested every @p tx_batch frames, and when the
+ * ring becomes full. Use eth_tx_reclaim() for sooner completion reports.
+ *
+ * @param[in] rx_watchdog uint8_t RX watchdog timeout, 0 to interrupt on
+ *                        every frame
+ * @param[in] tx_batch uint32_t Frames per TX interrupt, 0 for none
+ */
+void eth_irq_setup(uint8_t rx_watchdog, uint32_t tx_batch)
+{
+	uint32_t bd = RxBD;
+	uint32_t i;
+
+#if defined(STM32F1)
+	rx_watchdog = 0;
+#else
+	ETH_DMARSWTR = rx_watchdog & ETH_DMARSWTR_RSWTC;
+#endif
+	for (i = 0; i < eth_rx_ndesc; i++) {
+		if (rx_watchdog) {
+			ETH_DES1(bd) |= ETH_RDES1_DIC;
+		} else {
+			ETH_DES1(bd) &= ~ETH_RDES1_DIC;
+		}
+		bd = ETH_DES3(bd);
+	}
+
+	eth_tx_ic_every = tx_batch;
+	eth_tx_ic_count = 0;
+
+	ETH_DMAIER = ETH_DMAIER_NISE | ETH_DMAIER_RIE |
+		     (tx_batch ? ETH_DMAIER_TIE : 0) |
+		     ETH_DMAIER_AISE | ETH_DMAIER_ROIE | ETH_DMAIER_TUIE |
+		     ETH_DMAIER_FBEIE;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Handle the Ethernet DMA interrupt
+ *
+ * Call from the Ethernet interrupt handler. Completed transmit descriptors
+ * are reclaimed, transmit underflows are recovered and errors counted.
+ * Received frames are left to eth_rx_get() or eth_rx().
+ *
+ * Buffer unavailable conditions are not acknowledged here; they are
+ * resolved, and counted, when descriptors are handed back to the DMA.
+ *
+ * @returns uint32_t ETH_DMASR flags that were pending, eg ETH_DMASR_RS
+ *                   to process received frames, ETH_DMASR_FBES if the DMA
+ *                   stopped on a bus error
+ */
+uint32_t eth_irq_process(void)
+{
+	uint32_t sr = ETH_DMASR;
+
+	ETH_DMASR = sr & (ETH_DMASR_TS | ETH_DMASR_TPSS | ETH_DMASR_TJTS |
+			  ETH_DMASR_ROS | ETH_DMASR_TUS | ETH_DMASR_RS |
+			  ETH_DMASR_RPSS | ETH_DMASR_RWTS | ETH_DMASR_ETS |
+			  ETH_DMASR_FBES | ETH_DMASR_ERS | ETH_DMASR_AIS |
+			  ETH_DMASR_NIS);
+
+	if (sr & ETH_DMASR_TS) {
+		eth_tx_clean();
+	}
+	if (sr & ETH_DMASR_TUS) {
+		eth_stats.tx_underflows++;
+		ETH_DMATPDR = 0;
+	}
+	if (sr & ETH_DMASR_ROS) {
+		eth_stats_collect_missed();
+	}
+	if (sr & ETH_DMASR_FBES) {
+		eth_stats.bus_errors++;
+	}
+
+	return sr;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Read the driver statistics
+ *
+ * @param[out] stats struct eth_stats* Copy of the counters
+ */
+void eth_get_stats(struct eth_stats *stats)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+
+	eth_stats_collect_missed();
+	*stats = eth_stats;
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Clear the driver statistics
+ */
+void eth_clear_stats(void)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+
+	(void)ETH_DMAMFBOCR;
+	memset(&eth_stats, 0, sizeof(eth_stats));
+	cm_mask_interrupts(mask);
+}
+
 /*---------------------------------------------------------------------------*/
 /** @brief Enable checksum offload feature
  *
- * This function will enable the Checksum offload feature for all of the
- * transmit descriptors. Note to use this feature, descriptors must be in
- * extended format.
+ * This function will enable the Checksum offload feature for all frames
+ * sent without explicit flags, and checksum checking of received frames.
+ * Frames sent with eth_tx_submit_flags() or eth_tx_sg_flags() choose the
+ * insertion mode themselves. The receive checksum status is reported by
+ * eth_rx_get_info().
+ *
+ * Except on F1, receive checksum offload (IPCO) is only allowed with the
+ * extended descriptors, so the descriptors must have been set up with
+ * eth_desc_init() for the extended format.
+ *
+ * @returns bool true, if enabled, false if the descriptors are not extended
  */
-void eth_enable_checksum_offload(void)
+bool eth_enable_checksum_offload(void)
 {
-	uint32_t tab = TxBD;
-	do {
-		ETH_DES0(tab) |= ETH_TDES0_CIC_IPPLPH;
-		tab = ETH_DES3(tab);
+#if !defined(STM32F1)
+	if (eth_desc_size != ETH_DES_EXT_SIZE) {
+		return false;
 	}
-	while (tab != TxBD);
+#endif
+
+	eth_tx_flags = ETH_TDES0_CIC_IPPLPH;
 
 	ETH_MACCR |= ETH_MACCR_IPCO;
+	return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Wait for a PTP time stamp control command to be taken
+ *
+ * @param[in] bits uint32_t ETH_PTPTSCR command bits to set and wait for
+ */
+static void eth_ptp_command(uint32_t bits)
+{
+	ETH_PTPTSCR |= bits;
+	while (ETH_PTPTSCR & bits);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Start the IEEE 1588 system time
+ *
+ * The time runs in fine update mode, clocked at about half of HCLK, so
+ * eth_ptp_adjust_freq() can trim its rate. All received frames are
+ * timestamped; transmitted frames when sent with ETH_TDES0_TTSE.
+ *
+ * Needs the extended descriptors set up by eth_desc_init(). With normal
+ * descriptors the MAC writes the receive timestamp over RDES2 and RDES3,
+ * the buffer and next descriptor addresses of the chained ring. F1 has
+ * only normal descriptors and cannot time stamp without it, so it is not
+ * supported there.
+ *
+ * @param[in] hclk uint32_t HCLK frequency in Hz
+ * @returns bool true, if started, false without extended descriptors
+ */
+bool eth_ptp_init(uint32_t hclk)
+{
+#if defined(STM32F1)
+	(void)hclk;
+	return false;
+#else
+	uint64_t units = 1000000000;
+	uint32_t ssinc;
+
+	if (eth_desc_size != ETH_DES_EXT_SIZE) {
+		return false;
+	}
+
+	ETH_MACIMR |= ETH_MACIMR_TSTIM;
+	ETH_PTPTSCR = ETH_PTPTSCR_TSE | ETH_PTPTSCR_TSFCU |
+		      ETH_PTPTSCR_TSSARFE | ETH_PTPTSCR_TSSSR;
+
+	/* Subsecond increment for a counter at just below HCLK / 2 */
+	ssinc = (units * 2 + hclk - 1) / hclk;
+	ETH_PTPSSIR = ssinc & ETH_PTPSSIR_STSSI;
+
+	/* The accumulator overflows at 2^32, once per increment */
+	eth_ptp_addend = ((units << 32) / ssinc) / hclk;
+	ETH_PTPTSAR = eth_ptp_addend;
+	eth_ptp_command(ETH_PTPTSCR_TTSARU);
+
+	ETH_PTPTSHUR = 0;
+	ETH_PTPTSLUR = 0;
+	eth_ptp_command(ETH_PTPTSCR_TSSTI);
+	return true;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Read the IEEE 1588 system time
+ *
+ * @param[out] ts struct eth_timestamp* Current time
+ */
+void eth_ptp_get_time(struct eth_timestamp *ts)
+{
+	uint32_t sec, subsec;
+
+	/* Reread if the seconds rolled over in between */
+	do {
+		sec = ETH_PTPTSHR;
+		subsec = ETH_PTPTSLR;
+	} while (sec != ETH_PTPTSHR);
+
+	ts->sec = sec;
+	ts->nsec = eth_ptp_to_ns(subsec);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Set the IEEE 1588 system time
+ *
+ * @param[in] ts struct eth_timestamp* New time
+ */
+void eth_ptp_set_time(const struct eth_timestamp *ts)
+{
+	ETH_PTPTSHUR = ts->sec;
+	ETH_PTPTSLUR = eth_ptp_from_ns(ts->nsec);
+	eth_ptp_command(ETH_PTPTSCR_TSSTI);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Step the IEEE 1588 system time
+ *
+ * @param[in] offset_ns int64_t Nanoseconds to add, negative to subtract
+ */
+void eth_ptp_adjust_time(int64_t offset_ns)
+{
+	uint64_t abs_ns = offset_ns < 0 ? -offset_ns : offset_ns;
+	uint32_t sign = offset_ns < 0 ? ETH_PTPTSLUR_TSUPNS : 0;
+
+	ETH_PTPTSHUR = abs_ns / 1000000000;
+	ETH_PTPTSLUR = sign | eth_ptp_from_ns(abs_ns % 1000000000);
+	eth_ptp_command(ETH_PTPTSCR_TSSTU);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Trim the rate of the IEEE 1588 system time
+ *
+ * @param[in] ppb int32_t Rate correction in parts per billion, relative to
+ *                the nominal rate set up by eth_ptp_init()
+ */
+void eth_ptp_adjust_freq(int32_t ppb)
+{
+	int64_t delta = ((int64_t)eth_ptp_addend * ppb) / 1000000000;
+
+	ETH_PTPTSAR = eth_ptp_addend + delta;
+	eth_ptp_command(ETH_PTPTSCR_TTSARU);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -370,6 +370,18 @@ void can_abort_transmit(uint32_t canport) {
 	CAN_ISR_SR_CMR_MR_SET(canport, CAN_CMR_AT);
 }
 
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Read Error Counters
+
+@param[in] canport Unsigned int32. CAN block register base address.
+@param[out] tec Unsigned int8 pointer. Transmit error counter.
+@param[out] rec Unsigned int8 pointer. Receive error counter.
+*/
+void can_get_error_counters(uint32_t canport, uint8_t *tec, uint8_t *rec) {
+	*tec = CAN_TXERR(canport);
+	*rec = CAN_RXERR(canport);
+}
+
 /*---------------------------------------------------------------------------*/
 /** @brief CAN Receive Message
 If no data is in the RX buffer, id and length are set to 0.
@@ -35,6 +35,9 @@ LGPL License Terms @ref lgpl_license
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
+#include <libopencm3/cm3/cortex.h>
+#include <libopencm3/cm3/sync.h>
 #include <libopencm3/stm32/can.h>
 #include <libopencm3/stm32/rcc.h>
 
@@ -317,6 +320,297 @@ void can_filter_id_list_32bit_init(uint32_t nr,
 	can_filter_init(nr, true, true, id1, id2, fifo, enable);
 }
 
+/* Filter compiler: entries use the 32-bit filter register layout, ID in bits
+ * 31:3, IDE, RTR. Standard IDs sit in bits 31:21, their bits 20:3 read zero.
+ */
+#define CAN_FILTER_STID			0xFFE00000
+#define CAN_FILTER_EXID			0xFFFFFFF8
+#define CAN_FILTER_STD_ZERO		0x001FFFF8
+#define CAN_FILTER_EXACT		0xFFFFFFFE
+
+static uint32_t can_filter_bits(uint32_t x)
+{
+	uint32_t n = 0;
+
+	while (x) {
+		x &= x - 1;
+		n++;
+	}
+	return n;
+}
+
+/* Number of identifiers an entry accepts, 64-bit so sums can't wrap. */
+static uint64_t can_filter_size(const struct can_filter_entry *e)
+{
+	bool ide_fixed = e->mask & CAN_TIxR_IDE;
+	uint64_t size = 0;
+
+	if (!(ide_fixed && (e->id & CAN_TIxR_IDE)) &&
+	    !(e->id & e->mask & CAN_FILTER_STD_ZERO)) {
+		size += 1 << (11 - can_filter_bits(e->mask & CAN_FILTER_STID));
+	}
+	if (!(ide_fixed && !(e->id & CAN_TIxR_IDE))) {
+		size += 1 << (29 - can_filter_bits(e->mask & CAN_FILTER_EXID));
+	}
+	return size;
+}
+
+static bool can_filter_is_std(const struct can_filter_entry *e)
+{
+	return (e->mask & CAN_TIxR_IDE) && !(e->id & CAN_TIxR_IDE);
+}
+
+/* Banks needed to hold the entries: exact standard IDs go four to a 16-bit
+ * list bank, other standard entries two to a 16-bit mask bank, exact
+ * extended IDs two to a 32-bit list bank and the rest one per 32-bit mask
+ * bank.
+ */
+static uint32_t can_filter_banks(const struct can_filter_entry *e, uint32_t n,
+				 uint32_t *cls)
+{
+	uint32_t i;
+
+	cls[0] = cls[1] = cls[2] = cls[3] = 0;
+	for (i = 0; i < n; i++) {
+		if (can_filter_is_std(&e[i])) {
+			cls[e[i].mask == CAN_FILTER_EXACT ? 0 : 1]++;
+		} else if (e[i].mask == CAN_FILTER_EXACT) {
+			cls[2]++;
+		} else {
+			cls[3]++;
+		}
+	}
+	/* An odd 16-bit mask bank takes one exact standard ID. */
+	i = (cls[1] & 1) && cls[0] ? cls[0] - 1 : cls[0];
+
+	return (cls[1] + 1) / 2 + (i + 3) / 4 + (cls[2] + 1) / 2 + cls[3];
+}
+
+/* 32-bit filter layout to the 16-bit one: STID, RTR, IDE, EXID[17:15]. */
+static uint32_t can_filter_to16(uint32_t x)
+{
+	return ((x >> 16) & 0xFFE0) | ((x & CAN_TIxR_RTR) << 3) |
+	       ((x & CAN_TIxR_IDE) << 1) | ((x >> 18) & 0x7);
+}
+
+/* Split an ID range into naturally aligned power of two blocks. */
+static bool can_filter_expand(const struct can_filter_rule *rule,
+			      struct can_filter_entry *work,
+			      uint32_t work_size, uint32_t *n)
+{
+	uint32_t max = rule->ext ? 0x1FFFFFFF : 0x7FF;
+	uint32_t id = rule->id & max;
+	uint32_t last = rule->id_last > max ? max : rule->id_last;
+	uint32_t k, shift = rule->ext ? CAN_TIxR_EXID_SHIFT :
+			    CAN_TIxR_STID_SHIFT;
+
+	if (last < id) {
+		last = id;
+	}
+	while (true) {
+		for (k = 0; k < 29; k++) {
+			if ((id & ((2u << k) - 1)) ||
+			    id + (2u << k) - 1 > last) {
+				break;
+			}
+		}
+		if (*n == work_size) {
+			return false;
+		}
+		work[*n].id = id << shift;
+		work[*n].mask = CAN_TIxR_IDE | CAN_TIxR_RTR;
+		if (shift + k < 32) {
+			work[*n].mask |= 0xFFFFFFFF << (shift + k);
+		}
+		if (rule->ext) {
+			work[*n].id |= CAN_TIxR_IDE;
+		} else {
+			work[*n].mask |= CAN_FILTER_STD_ZERO;
+		}
+		(*n)++;
+		if (id + (1u << k) - 1 >= last) {
+			return true;
+		}
+		id += 1u << k;
+	}
+}
+
+/* Drop entries covered by entry keep. */
+static uint32_t can_filter_absorb(struct can_filter_entry *e, uint32_t n,
+				  uint32_t keep)
+{
+	uint32_t i = 0;
+
+	while (i < n) {
+		if (i != keep && (e[i].mask & e[keep].mask) == e[keep].mask &&
+		    !((e[i].id ^ e[keep].id) & e[keep].mask)) {
+			e[i] = e[--n];
+			if (keep == n) {
+				keep = i;
+			}
+		} else {
+			i++;
+		}
+	}
+	return n;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Compile Filter Banks
+
+Program filter banks so they accept the given standard and extended ID ranges.
+Ranges are split into mask blocks and packed into the cheapest mix of 16-bit
+and 32-bit list and mask banks. When more banks would be needed than
+available, the pair of entries whose union adds the fewest identifiers is
+merged until everything fits, and the resulting false accepts are reported.
+
+The banks match data frames only. Banks from first_bank up to nbanks that are
+not needed are deactivated.
+
+@param[in] rules Identifier ranges to accept, left unchanged.
+@param[in] nrules Unsigned int32. Number of rules.
+@param[in] work Scratch storage, one entry per aligned block of each range.
+@param[in] work_size Unsigned int32. Number of entries in work.
+@param[in] first_bank Unsigned int32. First filter bank to use.
+@param[in] nbanks Unsigned int32. Number of filter banks available.
+@param[in] fifo Unsigned int32. FIFO id the banks are assigned to.
+@param[out] report Banks used and acceptance figures, NULL to ignore.
+@returns bool. false if work is too small or no bank is available.
+ */
+bool can_filter_compile(const struct can_filter_rule *rules, uint32_t nrules,
+			struct can_filter_entry *work, uint32_t work_size,
+			uint32_t first_bank, uint32_t nbanks, uint32_t fifo,
+			struct can_filter_report *report)
+{
+	struct can_filter_entry m, *e = work;
+	uint32_t cls[4], n = 0, i, j, best_i, best_j;
+	uint64_t best, cost, a, b, c, wanted = 0, accepted = 0;
+	uint32_t std[4], nstd = 0, ext[2], next = 0;
+	uint32_t nr = first_bank, spare;
+
+	for (i = 0; i < nrules; i++) {
+		if (!can_filter_expand(&rules[i], work, work_size, &n)) {
+			return false;
+		}
+	}
+	for (i = 0; i < n; i++) {
+		n = can_filter_absorb(e, n, i);
+	}
+	for (i = 0; i < n; i++) {
+		wanted += can_filter_size(&e[i]);
+	}
+
+	while (can_filter_banks(e, n, cls) > nbanks) {
+		if (n < 2) {
+			return false;
+		}
+		best = UINT64_MAX;
+		best_i = 0;
+		best_j = 1;
+		for (i = 0; i < n; i++) {
+			a = can_filter_size(&e[i]);
+			for (j = i + 1; j < n; j++) {
+				m.mask = e[i].mask & e[j].mask &
+					 ~(e[i].id ^ e[j].id);
+				b = can_filter_size(&e[j]);
+				m.id = e[i].id & m.mask;
+				c = can_filter_size(&m);
+				cost = c > a + b ? c - a - b : 0;
+				if (cost < best) {
+					best = cost;
+					best_i = i;
+					best_j = j;
+				}
+			}
+		}
+		e[best_i].mask &= e[best_j].mask & ~(e[best_i].id ^ e[best_j].id);
+		e[best_i].id &= e[best_i].mask;
+		e[best_j] = e[--n];
+		n = can_filter_absorb(e, n, best_i);
+	}
+
+	/* Odd 16-bit mask bank: move one exact standard ID into it. */
+	spare = n;
+	for (i = 0; i < n && (cls[1] & 1); i++) {
+		if (can_filter_is_std(&e[i]) && e[i].mask == CAN_FILTER_EXACT) {
+			spare = i;
+			break;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		accepted += can_filter_size(&e[i]);
+		if (!can_filter_is_std(&e[i]) ||
+		    (e[i].mask == CAN_FILTER_EXACT && i != spare)) {
+			continue;
+		}
+		std[nstd++] = (can_filter_to16(e[i].mask) << 16) |
+			      can_filter_to16(e[i].id);
+		if (nstd == 2) {
+			can_filter_init(nr++, false, false, std[0], std[1],
+					fifo, true);
+			nstd = 0;
+		}
+	}
+	if (nstd) {
+		can_filter_init(nr++, false, false, std[0], std[0], fifo, true);
+		nstd = 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (can_filter_is_std(&e[i])) {
+			if (e[i].mask != CAN_FILTER_EXACT || i == spare) {
+				continue;
+			}
+			std[nstd++] = can_filter_to16(e[i].id);
+			if (nstd == 4) {
+				can_filter_init(nr++, false, true,
+						(std[0] << 16) | std[1],
+						(std[2] << 16) | std[3],
+						fifo, true);
+				nstd = 0;
+			}
+		} else if (e[i].mask == CAN_FILTER_EXACT) {
+			ext[next++] = e[i].id;
+			if (next == 2) {
+				can_filter_init(nr++, true, true, ext[0],
+						ext[1], fifo, true);
+				next = 0;
+			}
+		} else {
+			can_filter_init(nr++, true, false, e[i].id, e[i].mask,
+					fifo, true);
+		}
+	}
+	if (nstd) {
+		/* Pad the list by repeating its first ID. */
+		for (i = nstd; i < 4; i++) {
+			std[i] = std[0];
+		}
+		can_filter_init(nr++, false, true, (std[0] << 16) | std[1],
+				(std[2] << 16) | std[3], fifo, true);
+	}
+	if (next) {
+		can_filter_init(nr++, true, true, ext[0], ext[0], fifo, true);
+	}
+
+	/* Deactivate the banks left over. */
+	CAN_FMR(CAN1) |= CAN_FMR_FINIT;
+	for (i = nr; i < first_bank + nbanks; i++) {
+		CAN_FA1R(CAN1) &= ~(1 << i);
+	}
+	CAN_FMR(CAN1) &= ~CAN_FMR_FINIT;
+
+	if (report) {
+		report->banks = nr - first_bank;
+		/* At most all 2^29 + 2^11 identifiers, unless entries overlap */
+		report->accepted = accepted > 0xFFFFFFFF ? 0xFFFFFFFF : accepted;
+		cost = accepted > wanted ? accepted - wanted : 0;
+		report->false_accepts = cost > 0xFFFFFFFF ? 0xFFFFFFFF : cost;
+	}
+	return true;
+}
+
 /*---------------------------------------------------------------------------*/
 /** @brief CAN Enable IRQ
 
@@ -339,6 +633,84 @@ void can_disable_irq(uint32_t canport, uint32_t irq)
 	CAN_IER(canport) &= ~irq;
 }
 
+static const uint32_t can_mbox[3] = {CAN_MBOX0, CAN_MBOX1, CAN_MBOX2};
+
+static void can_mbox_write(uint32_t canport, uint32_t mailbox,
+			   const struct can_frame *frame)
+{
+	uint32_t tir, data[2];
+
+	if (frame->ext) {
+		tir = (frame->id << CAN_TIxR_EXID_SHIFT) | CAN_TIxR_IDE;
+	} else {
+		tir = frame->id << CAN_TIxR_STID_SHIFT;
+	}
+	if (frame->rtr) {
+		tir |= CAN_TIxR_RTR;
+	}
+
+	/* The payload is word aligned, this becomes two word loads. */
+	memcpy(data, frame->data, sizeof(data));
+
+	CAN_TIxR(canport, mailbox) = tir;
+	/* Only the DLC, TGT stays as the application set it up */
+	CAN_TDTxR(canport, mailbox) = (CAN_TDTxR(canport, mailbox) &
+				       ~CAN_TDTxR_DLC_MASK) |
+				      (frame->length & CAN_TDTxR_DLC_MASK);
+	CAN_TDLxR(canport, mailbox) = data[0];
+	CAN_TDHxR(canport, mailbox) = data[1];
+	CAN_TIxR(canport, mailbox) = tir | CAN_TIxR_TXRQ;
+}
+
+static void can_fifo_read(uint32_t canport, uint32_t fifo_id,
+			  struct can_frame *frame)
+{
+	uint32_t rir = CAN_RIxR(canport, fifo_id);
+	uint32_t rdtr = CAN_RDTxR(canport, fifo_id);
+	uint32_t data[2];
+
+	frame->ext = rir & CAN_RIxR_IDE;
+	if (frame->ext) {
+		frame->id = (rir >> CAN_RIxR_EXID_SHIFT) & CAN_RIxR_EXID_MASK;
+	} else {
+		frame->id = (rir >> CAN_RIxR_STID_SHIFT) & CAN_RIxR_STID_MASK;
+	}
+	frame->rtr = rir & CAN_RIxR_RTR;
+	frame->fmi = (rdtr & CAN_RDTxR_FMI_MASK) >> CAN_RDTxR_FMI_SHIFT;
+	frame->length = rdtr & CAN_RDTxR_DLC_MASK;
+	frame->timestamp = (rdtr & CAN_RDTxR_TIME_MASK) >> CAN_RDTxR_TIME_SHIFT;
+
+	data[0] = CAN_RDLxR(canport, fifo_id);
+	data[1] = CAN_RDHxR(canport, fifo_id);
+	memcpy(frame->data, data, sizeof(data));
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Transmit Frame
+
+Each mailbox register is written with a single 32-bit store.
+
+@param[in] canport Unsigned int32. CAN block register base @ref can_reg_base.
+@param[in] frame Frame to send.
+@returns int 0, 1 or 2 on success and depending on which outgoing mailbox got
+selected. -1 if no mailbox was available and no transmission got queued.
+ */
+int can_transmit_frame(uint32_t canport, const struct can_frame *frame)
+{
+	uint32_t tsr = CAN_TSR(canport);
+	int ret;
+
+	if (!(tsr & (CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2))) {
+		return -1;
+	}
+
+	/* CODE holds the number of the next empty mailbox. */
+	ret = (tsr & CAN_TSR_CODE_MASK) >> CAN_TSR_CODE_SHIFT;
+	can_mbox_write(canport, can_mbox[ret], frame);
+
+	return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 /** @brief CAN Transmit Message
 
@@ -354,87 +726,17 @@ selected. -1 if no mailbox was available and no transmission got queued.
 int can_transmit(uint32_t canport, uint32_t id, bool ext, bool rtr,
 		 uint8_t length, uint8_t *data)
 {
-	int ret = 0;
-	uint32_t mailbox = 0;
-	union {
-		uint8_t data8[4];
-		uint32_t data32;
-	} tdlxr, tdhxr;
-
-	/* Check which transmit mailbox is empty if any. */
-	if ((CAN_TSR(canport) & CAN_TSR_TME0) == CAN_TSR_TME0) {
-		ret = 0;
-		mailbox = CAN_MBOX0;
-	} else if ((CAN_TSR(canport) & CAN_TSR_TME1) == CAN_TSR_TME1) {
-		ret = 1;
-		mailbox = CAN_MBOX1;
-	} else if ((CAN_TSR(canport) & CAN_TSR_TME2) == CAN_TSR_TME2) {
-		ret = 2;
-		mailbox = CAN_MBOX2;
-	} else {
-		ret = -1;
-	}
-
-	/* If we have no empty mailbox return with an error. */
-	if (ret == -1) {
-		return ret;
-	}
+	struct can_frame frame = {
+		.id = id,
+		.ext = ext,
+		.rtr = rtr,
+		.length = length,
+	};
 
-	if (ext) {
-		/* Set extended ID. */
-		CAN_TIxR(canport, mailbox) = (id << CAN_TIxR_EXID_SHIFT) |
-			CAN_TIxR_IDE;
-	} else {
-		/* Set standard ID. */
-		CAN_TIxR(canport, mailbox) = id << CAN_TIxR_STID_SHIFT;
-	}
-
-	/* Set/clear remote transmission request bit. */
-	if (rtr) {
-		CAN_TIxR(canport, mailbox) |= CAN_TIxR_RTR; /* Set */
-	}
-
-	/* Set the DLC. */
-	CAN_TDTxR(canport, mailbox) &= ~CAN_TDTxR_DLC_MASK;
-	CAN_TDTxR(canport, mailbox) |= (length & CAN_TDTxR_DLC_MASK);
-
-	switch (length) {
-	case 8:
-		tdhxr.data8[3] = data[7];
-		/* fall through */
-	case 7:
-		tdhxr.data8[2] = data[6];
-		/* fall through */
-	case 6:
-		tdhxr.data8[1] = data[5];
-		/* fall through */
-	case 5:
-		tdhxr.data8[0] = data[4];
-		/* fall through */
-	case 4:
-		tdlxr.data8[3] = data[3];
-		/* fall through */
-	case 3:
-		tdlxr.data8[2] = data[2];
-		/* fall through */
-	case 2:
-		tdlxr.data8[1] = data[1];
-		/* fall through */
-	case 1:
-		tdlxr.data8[0] = data[0];
-		/* fall through */
-	default:
-		break;
-	}
-	/* Set the data. */
-
-	CAN_TDLxR(canport, mailbox) = tdlxr.data32;
-	CAN_TDHxR(canport, mailbox) = tdhxr.data32;
-
-	/* Request transmission. */
-	CAN_TIxR(canport, mailbox) |= CAN_TIxR_TXRQ;
+	/* Byte wise copy, the alignment of the input buffer is unknown. */
+	memcpy(frame.data, data, length < 8 ? length : 8);
 
-	return ret;
+	return can_transmit_frame(canport, &frame);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -445,10 +747,32 @@ int can_transmit(uint32_t canport, uint32_t id, bool ext, bool rtr,
  */
 void can_fifo_release(uint32_t canport, uint8_t fifo)
 {
+	/* Plain store, FULL and FOVR are cleared by writing 1. */
 	if (fifo == 0) {
-		CAN_RF0R(canport) |= CAN_RF1R_RFOM1;
+		CAN_RF0R(canport) = CAN_RF0R_RFOM0;
 	} else {
-		CAN_RF1R(canport) |= CAN_RF1R_RFOM1;
+		CAN_RF1R(canport) = CAN_RF1R_RFOM1;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Receive Frame
+
+Each mailbox register is read with a single 32-bit load. All 8 data bytes are
+copied regardless of the frame length.
+
+@param[in] canport Unsigned int32. CAN block register base @ref can_reg_base.
+@param[in] fifo Unsigned int8. FIFO id.
+@param[in] release bool. Release the FIFO automatically after coping data out.
+@param[out] frame Received frame.
+ */
+void can_receive_frame(uint32_t canport, uint8_t fifo, bool release,
+		       struct can_frame *frame)
+{
+	can_fifo_read(canport, fifo ? CAN_FIFO1 : CAN_FIFO0, frame);
+
+	if (release) {
+		can_fifo_release(canport, fifo);
 	}
 }
 
@@ -471,80 +795,420 @@ void can_receive(uint32_t canport, uint8_t fifo, bool release, uint32_t *id,
 		 bool *ext, bool *rtr, uint8_t *fmi, uint8_t *length,
 		 uint8_t *data, uint16_t *timestamp)
 {
-	uint32_t fifo_id = 0;
-	union {
-		uint8_t data8[4];
-		uint32_t data32;
-	} rdlxr, rdhxr;
-	const uint32_t fifoid_array[2] = {CAN_FIFO0, CAN_FIFO1};
-
-	fifo_id = fifoid_array[fifo];
-
-	/* Get type of CAN ID and CAN ID. */
-	if (CAN_RIxR(canport, fifo_id) & CAN_RIxR_IDE) {
-		*ext = true;
-		/* Get extended CAN ID. */
-		*id = (CAN_RIxR(canport, fifo_id) >> CAN_RIxR_EXID_SHIFT) &
-			CAN_RIxR_EXID_MASK;
-	} else {
-		*ext = false;
-		/* Get standard CAN ID. */
-		*id = (CAN_RIxR(canport, fifo_id) >> CAN_RIxR_STID_SHIFT) &
-			CAN_RIxR_STID_MASK;
-	}
-
-	/* Get remote transmit flag. */
-	if (CAN_RIxR(canport, fifo_id) & CAN_RIxR_RTR) {
-		*rtr = true;
-	} else {
-		*rtr = false;
-	}
+	struct can_frame frame;
 
-	/* Get filter match ID. */
-	*fmi = ((CAN_RDTxR(canport, fifo_id) & CAN_RDTxR_FMI_MASK) >>
-		CAN_RDTxR_FMI_SHIFT);
-
-	/* Get data length. */
-	*length = CAN_RDTxR(canport, fifo_id) & CAN_RDTxR_DLC_MASK;
-	/* accelerate reception by copying the CAN data from the controller
-	 * memory to the fast internal RAM
-	 */
+	can_receive_frame(canport, fifo, release, &frame);
 
+	*id = frame.id;
+	*ext = frame.ext;
+	*rtr = frame.rtr;
+	*fmi = frame.fmi;
+	*length = frame.length;
 	if (timestamp) {
-		*timestamp = (CAN_RDTxR(canport, fifo_id) &
-			CAN_RDTxR_TIME_MASK) >> CAN_RDTxR_TIME_SHIFT;
-	}
-
-	rdlxr.data32 = CAN_RDLxR(canport, fifo_id);
-	rdhxr.data32 = CAN_RDHxR(canport, fifo_id);
-	/* */
-	/* Get data.
-	 * Byte wise copy is needed because we do not know the alignment
-	 * of the input buffer.
-	 * Here copying 8 bytes unconditionally is faster than using loop
-	 *
+		*timestamp = frame.timestamp;
+	}
+
+	/*
 	 * It is OK to copy all 8 bytes because the upper layer must be
 	 * prepared for data length bigger expected.
 	 * In contrary the driver has no information about the intended size.
-	 * This could be different if the max length would be handed over
-	 * to the function, but it is not the case
 	 */
-	data[0] = rdlxr.data8[0];
-	data[1] = rdlxr.data8[1];
-	data[2] = rdlxr.data8[2];
-	data[3] = rdlxr.data8[3];
-	data[4] = rdhxr.data8[0];
-	data[5] = rdhxr.data8[1];
-	data[6] = rdhxr.data8[2];
-	data[7] = rdhxr.data8[3];
-
-	/* Release the FIFO. */
-	if (release) {
-		can_fifo_release(canport, fifo);
+	memcpy(data, frame.data, sizeof(frame.data));
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Receive Burst
+
+Drain all frames pending in a FIFO, up to max, releasing each one.
+
+@param[in] canport Unsigned int32. CAN block register base @ref can_reg_base.
+@param[in] fifo Unsigned int8. FIFO id.
+@param[out] frames Array receiving the frames.
+@param[in] max Unsigned int32. Size of the frames array.
+@returns Unsigned int32. Number of frames stored.
+ */
+uint32_t can_receive_burst(uint32_t canport, uint8_t fifo,
+			   struct can_frame *frames, uint32_t max)
+{
+	uint32_t fifo_id = fifo ? CAN_FIFO1 : CAN_FIFO0;
+	volatile uint32_t *rfr = fifo ? &CAN_RF1R(canport) : &CAN_RF0R(canport);
+	uint32_t n = 0;
+
+	/* Bit positions of RF0R and RF1R are identical. */
+	while (n < max && (*rfr & CAN_RF0R_FMP0_MASK)) {
+		can_fifo_read(canport, fifo_id, &frames[n++]);
+		*rfr = CAN_RF0R_RFOM0;
+		/* The next frame is visible once the mailbox is released. */
+		while (*rfr & CAN_RF0R_RFOM0);
 	}
+
+	return n;
 }
 
 bool can_available_mailbox(uint32_t canport)
 {
 	return CAN_TSR(canport) & (CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2);
 }
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Read Error Counters
+
+Both counters are taken from a single read of CAN_ESR.
+
+@param[in] canport Unsigned int32. CAN block register base @ref can_reg_base.
+@param[out] tec Unsigned int8 pointer. Transmit error counter, low 8 bits.
+@param[out] rec Unsigned int8 pointer. Receive error counter.
+ */
+void can_get_error_counters(uint32_t canport, uint8_t *tec, uint8_t *rec)
+{
+	uint32_t esr = CAN_ESR(canport);
+
+	*tec = (esr & CAN_ESR_TEC_MASK) >> CAN_ESR_TEC_SHIFT;
+	*rec = (esr & CAN_ESR_REC_MASK) >> CAN_ESR_REC_SHIFT;
+}
+
+/* Per mailbox flags in CAN_TSR, the RQCP/TXOK/ABRQ groups are 8 bits apart. */
+#define CAN_TSR_TME(i)			(CAN_TSR_TME0 << (i))
+#define CAN_TSR_RQCP(i)			(CAN_TSR_RQCP0 << (8 * (i)))
+#define CAN_TSR_TXOK(i)			(CAN_TSR_TXOK0 << (8 * (i)))
+#define CAN_TSR_ABRQ(i)			(CAN_TSR_ABRQ0 << (8 * (i)))
+#define CAN_TSR_TME_ALL			(CAN_TSR_TME0 | CAN_TSR_TME1 | \
+					 CAN_TSR_TME2)
+
+/* Bus arbitration key of a frame, a lower key wins arbitration.
+ *
+ * The key lays out the arbitration field as it appears on the wire: base ID,
+ * RTR/SRR, IDE, extended ID and RTR of extended frames.
+ */
+static uint32_t can_frame_key(const struct can_frame *frame)
+{
+	if (frame->ext) {
+		return ((frame->id >> 18) << 21) | (3 << 19) |
+		       ((frame->id & 0x3FFFF) << 1) | (frame->rtr ? 1 : 0);
+	}
+	return (frame->id << 21) | (frame->rtr ? (1 << 20) : 0);
+}
+
+/* Insert a frame into the TX queue, which is sorted on descending key so the
+ * next frame to send is always the last one. New frames go behind queued
+ * frames of the same priority, preempted frames (front) in front of them.
+ */
+static void can_buf_enqueue(struct can_buf *buf, const struct can_frame *frame,
+			    bool front)
+{
+	uint32_t key = can_frame_key(frame);
+	uint16_t i = buf->tx_count;
+
+	while (i > 0) {
+		uint32_t k = can_frame_key(&buf->tx[i - 1]);
+
+		if (k > key || (front && k == key)) {
+			break;
+		}
+		buf->tx[i] = buf->tx[i - 1];
+		i--;
+	}
+	buf->tx[i] = *frame;
+	buf->tx_count++;
+}
+
+/* Account for finished mailboxes, refill empty mailboxes from the queue and
+ * preempt the lowest priority mailbox if the queue holds a frame that would
+ * win arbitration against it. Must run with interrupts masked.
+ */
+static void can_buf_tx_service(struct can_buf *buf)
+{
+	uint32_t canport = buf->canport;
+	uint32_t tsr = CAN_TSR(canport);
+	uint32_t key;
+	int i, victim;
+
+	for (i = 0; i < 3; i++) {
+		if (!(tsr & CAN_TSR_RQCP(i))) {
+			continue;
+		}
+		if (tsr & CAN_TSR_TXOK(i)) {
+			buf->stats.tx_frames++;
+		} else if (buf->aborting & (1 << i)) {
+			can_buf_enqueue(buf, &buf->mbox[i], true);
+			buf->stats.tx_requeued++;
+		} else {
+			buf->stats.tx_errors++;
+		}
+		buf->aborting &= ~(1 << i);
+		/* Clears TXOK, ALST and TERR as well. */
+		CAN_TSR(canport) = CAN_TSR_RQCP(i);
+	}
+
+	for (i = 0; i < 3 && buf->tx_count; i++) {
+		if (tsr & CAN_TSR_TME(i)) {
+			buf->tx_count--;
+			buf->mbox[i] = buf->tx[buf->tx_count];
+			buf->mbox_key[i] = can_frame_key(&buf->mbox[i]);
+			can_mbox_write(canport, can_mbox[i], &buf->mbox[i]);
+		}
+	}
+
+	/*
+	 * With TXFP cleared the hardware sends the pending mailbox with the
+	 * lowest identifier first, but a frame still waiting in the queue
+	 * cannot take part. Abort the weakest mailbox if it blocks a stronger
+	 * frame; the abort completes through the TX interrupt above.
+	 */
+	if (!buf->tx_count || buf->aborting || buf->tx_count >= buf->tx_size ||
+	    (CAN_TSR(canport) & CAN_TSR_TME_ALL)) {
+		return;
+	}
+	victim = 0;
+	for (i = 1; i < 3; i++) {
+		if (buf->mbox_key[i] > buf->mbox_key[victim]) {
+			victim = i;
+		}
+	}
+	key = can_frame_key(&buf->tx[buf->tx_count - 1]);
+	if (buf->mbox_key[victim] > key) {
+		buf->aborting = 1 << victim;
+		CAN_TSR(canport) = CAN_TSR_ABRQ(victim);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered Layer Initialize
+
+Set up software queues for a CAN block and enable the transmit mailbox empty,
+FIFO message pending, FIFO overrun and error interrupts. The application has to
+enable the CAN interrupts in the NVIC and call the handlers below from them.
+
+The block has to be initialized with can_init() and txfp false, so pending
+mailboxes are sent in identifier order. Do not mix can_transmit() or
+can_receive() with the buffered layer on the same block.
+
+@param[in] buf Pointer to the buffered layer state.
+@param[in] canport Unsigned int32. CAN block register base @ref can_reg_base.
+@param[in] tx Storage for the TX queue.
+@param[in] tx_size Unsigned int16. Number of frames in tx, at least 1.
+@param[in] rx0 Storage for the FIFO 0 ring, NULL if unused.
+@param[in] rx0_size Unsigned int16. Number of frames in rx0, one stays free.
+@param[in] rx1 Storage for the FIFO 1 ring, NULL if unused.
+@param[in] rx1_size Unsigned int16. Number of frames in rx1, one stays free.
+ */
+void can_buf_init(struct can_buf *buf, uint32_t canport,
+		  struct can_frame *tx, uint16_t tx_size,
+		  struct can_frame *rx0, uint16_t rx0_size,
+		  struct can_frame *rx1, uint16_t rx1_size)
+{
+	uint32_t irq = CAN_IER_TMEIE | CAN_IER_ERRIE | CAN_IER_LECIE |
+		       CAN_IER_BOFIE | CAN_IER_EPVIE | CAN_IER_EWGIE;
+
+	memset(buf, 0, sizeof(*buf));
+	buf->canport = canport;
+	buf->tx = tx;
+	buf->tx_size = tx_size;
+	buf->rx[0].frames = rx0;
+	buf->rx[0].size = rx0 ? rx0_size : 0;
+	buf->rx[1].frames = rx1;
+	buf->rx[1].size = rx1 ? rx1_size : 0;
+
+	if (rx0) {
+		irq |= CAN_IER_FMPIE0 | CAN_IER_FOVIE0;
+	}
+	if (rx1) {
+		irq |= CAN_IER_FMPIE1 | CAN_IER_FOVIE1;
+	}
+	can_enable_irq(canport, irq);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered Transmit
+
+Queue a frame for transmission. The frame is loaded into a mailbox as soon as
+one is free, or earlier if it outranks a frame already sitting in a mailbox.
+
+@param[in] buf Pointer to the buffered layer state.
+@param[in] frame Frame to send, copied into the queue.
+@returns bool. false if the TX queue is full.
+ */
+bool can_buf_transmit(struct can_buf *buf, const struct can_frame *frame)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+	/* Keep a slot for a frame coming back from a preempted mailbox. */
+	bool ok = buf->tx_count + (buf->aborting ? 1 : 0) < buf->tx_size;
+
+	if (ok) {
+		can_buf_enqueue(buf, frame, false);
+		can_buf_tx_service(buf);
+	} else {
+		buf->stats.tx_dropped++;
+	}
+	cm_mask_interrupts(mask);
+
+	return ok;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered Receive
+
+Take the oldest frame out of the ring of a FIFO.
+
+@param[in] buf Pointer to the buffered layer state.
+@param[in] fifo Unsigned int8. FIFO id.
+@param[out] frame Received frame.
+@returns bool. false if the ring is empty.
+ */
+bool can_buf_receive(struct can_buf *buf, uint8_t fifo,
+		     struct can_frame *frame)
+{
+	struct can_rx_ring *ring = &buf->rx[fifo];
+	uint16_t tail = ring->tail;
+
+	if (tail == ring->head) {
+		return false;
+	}
+	*frame = ring->frames[tail];
+	__dmb();
+	if (++tail == ring->size) {
+		tail = 0;
+	}
+	ring->tail = tail;
+
+	return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered Frames Waiting For Transmission
+
+@param[in] buf Pointer to the buffered layer state.
+@returns Unsigned int16. Frames queued, not counting loaded mailboxes.
+ */
+uint16_t can_buf_tx_pending(struct can_buf *buf)
+{
+	return buf->tx_count;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered Frames Waiting To Be Read
+
+@param[in] buf Pointer to the buffered layer state.
+@param[in] fifo Unsigned int8. FIFO id.
+@returns Unsigned int16. Frames in the ring of the FIFO.
+ */
+uint16_t can_buf_rx_pending(struct can_buf *buf, uint8_t fifo)
+{
+	struct can_rx_ring *ring = &buf->rx[fifo];
+	uint16_t head = ring->head;
+	uint16_t tail = ring->tail;
+
+	return head >= tail ? head - tail : ring->size - tail + head;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered TX Interrupt Handler
+
+Call from the transmit interrupt of the CAN block.
+
+@param[in] buf Pointer to the buffered layer state.
+ */
+void can_buf_tx_isr(struct can_buf *buf)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+
+	can_buf_tx_service(buf);
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered RX Interrupt Handler
+
+Call from the FIFO 0 or FIFO 1 receive interrupt of the CAN block. Drains the
+hardware FIFO completely into the ring, frames that do not fit are counted and
+dropped.
+
+@param[in] buf Pointer to the buffered layer state.
+@param[in] fifo Unsigned int8. FIFO id.
+ */
+void can_buf_rx_isr(struct can_buf *buf, uint8_t fifo)
+{
+	uint32_t canport = buf->canport;
+	uint32_t fifo_id = fifo ? CAN_FIFO1 : CAN_FIFO0;
+	volatile uint32_t *rfr = fifo ? &CAN_RF1R(canport) : &CAN_RF0R(canport);
+	struct can_rx_ring *ring = &buf->rx[fifo];
+	uint16_t next;
+
+	/* Bit positions of RF0R and RF1R are identical. */
+	if (*rfr & CAN_RF0R_FOVR0) {
+		buf->stats.rx_overruns[fifo]++;
+		*rfr = CAN_RF0R_FOVR0;
+	}
+
+	while (*rfr & CAN_RF0R_FMP0_MASK) {
+		next = ring->head + 1;
+		if (next >= ring->size) {
+			next = 0;
+		}
+		if (next == ring->tail) {
+			buf->stats.rx_dropped[fifo]++;
+		} else {
+			can_fifo_read(canport, fifo_id,
+				      &ring->frames[ring->head]);
+			__dmb();
+			ring->head = next;
+			buf->stats.rx_frames[fifo]++;
+		}
+		*rfr = CAN_RF0R_RFOM0;
+		while (*rfr & CAN_RF0R_RFOM0);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered Status Change / Error Interrupt Handler
+
+Call from the SCE interrupt of the CAN block. Counts protocol errors and
+transitions into error warning, error passive and bus off.
+
+@param[in] buf Pointer to the buffered layer state.
+ */
+void can_buf_sce_isr(struct can_buf *buf)
+{
+	uint32_t canport = buf->canport;
+	uint32_t esr = CAN_ESR(canport);
+	uint32_t raised = esr & ~buf->esr;
+
+	if (esr & CAN_ESR_LEC_MASK) {
+		buf->stats.bus_errors++;
+		/* LEC is writable, clear it to catch the next error. */
+		CAN_ESR(canport) = 0;
+	}
+	if (raised & CAN_ESR_EWGF) {
+		buf->stats.error_warning++;
+	}
+	if (raised & CAN_ESR_EPVF) {
+		buf->stats.error_passive++;
+	}
+	if (raised & CAN_ESR_BOFF) {
+		buf->stats.bus_off++;
+	}
+	buf->esr = esr & (CAN_ESR_EWGF | CAN_ESR_EPVF | CAN_ESR_BOFF);
+
+	CAN_MSR(canport) = CAN_MSR_ERRI;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief CAN Buffered Combined Interrupt Handler
+
+For devices that route all CAN events to a single interrupt.
+
+@param[in] buf Pointer to the buffered layer state.
+ */
+void can_buf_isr(struct can_buf *buf)
+{
+	can_buf_tx_isr(buf);
+	if (buf->rx[0].frames) {
+		can_buf_rx_isr(buf, 0);
+	}
+	if (buf->rx[1].frames) {
+		can_buf_rx_isr(buf, 1);
+	}
+	if (CAN_MSR(buf->canport) & CAN_MSR_ERRI) {
+		can_buf_sce_isr(buf);
+	}
+}
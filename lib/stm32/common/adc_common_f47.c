@@ -31,6 +31,18 @@ LGPL License Terms @ref lgpl_license
 
 /**@{*/
 
+/* Sampling time selections in ADC clock cycles */
+static const uint16_t adc_sample_cycles[8] = {
+	3, 15, 28, 56, 84, 112, 144, 480
+};
+
+/* Sampling plus conversion time, one clock per bit of resolution */
+static uint32_t adc_conversion_cycles(uint8_t time, uint32_t resolution)
+{
+	return adc_sample_cycles[time & 7] + 12 -
+	       2 * ((resolution & ADC_CR1_RES_MASK) >> ADC_CR1_RES_SHIFT);
+}
+
 /*---------------------------------------------------------------------------*/
 /** @brief ADC Set the Sample Time for a Single Channel
 
@@ -98,7 +110,7 @@ The various modes possible are described in the reference manual.
 */
 void adc_set_multi_mode(uint32_t mode)
 {
-	ADC_CCR |= mode;
+	ADC_CCR = (ADC_CCR & ~ADC_CCR_MULTI_MASK) | mode;
 }
 
 
@@ -121,4 +133,144 @@ void adc_disable_vbat_sensor(void)
 	ADC_CCR &= ~ADC_CCR_VBATE;
 }
 
+/*---------------------------------------------------------------------------*/
+/** @brief ADC Compute the Interleave Delay
+
+Conversions of @p nadcs interleaved ADCs are spaced evenly over the conversion
+time of one ADC, the sampling time plus one clock per bit, within the 5 to 20
+clocks the DELAY field allows. The hardware stretches the delay to the
+sampling time + 2 clocks if sampling phases would overlap.
+
+@param[in] nadcs Unsigned int8. 2 for dual, 3 for triple interleaved mode.
+@param[in] time Unsigned int8. Sampling time selection from @ref adc_sample_rg
+@param[in] resolution Unsigned int32. Resolution, ADC_CR1_RES_xBIT
+@returns Unsigned int32. Delay in ADC clock cycles.
+*/
+
+uint32_t adc_interleave_delay(uint8_t nadcs, uint8_t time, uint32_t resolution)
+{
+	uint32_t conv = adc_conversion_cycles(time, resolution);
+	uint32_t delay = (conv + nadcs - 1) / nadcs;
+
+	if (delay < 5) {
+		return 5;
+	}
+	return delay > 20 ? 20 : delay;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief ADC Set up Dual or Triple Interleaved Acquisition
+
+ADC1 and ADC2, and ADC3 for triple mode, continuously convert one channel,
+staggered by adc_interleave_delay(). Their results are read from the common
+data register by DMA mode 2, two samples per word, and delivered in
+conversion order through @p acq as with adc_acq_init(). The ADCs must be off.
+
+@param[out] acq Acquisition state.
+@param[in] nadcs Unsigned int8. 2 for dual, 3 for triple interleaved mode.
+@param[in] channel Unsigned int8. ADC Channel integer from @ref adc_channel
+@param[in] time Unsigned int8. Sampling time selection from @ref adc_sample_rg
+@param[in] resolution Unsigned int32. Resolution, ADC_CR1_RES_xBIT
+@param[in] adcclk Unsigned int32. ADC clock in Hz, after the prescaler.
+@param[in] buf Unsigned int16 *. Ring of 2 * @p nsamples samples.
+@param[in] nsamples Unsigned int32. Samples per ring half, even.
+@param[in] block Called with each completed ring half.
+@param[in] arg Argument for @p block.
+@returns Unsigned int32. Resulting sample rate in samples per second.
+*/
+
+uint32_t adc_interleave_init(struct adc_acq *acq, uint8_t nadcs,
+			     uint8_t channel, uint8_t time, uint32_t resolution,
+			     uint32_t adcclk, uint16_t *buf, uint32_t nsamples,
+			     adc_acq_block_callback block, void *arg)
+{
+	static const uint32_t adcs[3] = { ADC1, ADC2, ADC3 };
+	uint32_t smp = adc_sample_cycles[time & 7];
+	uint32_t conv, delay, period;
+	uint8_t i;
+
+	for (i = 0; i < nadcs; i++) {
+		adc_set_resolution(adcs[i], resolution);
+		adc_set_sample_time(adcs[i], channel, time);
+		adc_set_regular_sequence(adcs[i], 1, &channel);
+		adc_disable_scan_mode(adcs[i]);
+		adc_set_continuous_conversion_mode(adcs[i]);
+		adc_disable_external_trigger_regular(adcs[i]);
+		adc_disable_dma(adcs[i]);
+	}
+
+	delay = adc_interleave_delay(nadcs, time, resolution);
+	ADC_CCR = (ADC_CCR & ~(ADC_CCR_MULTI_MASK | ADC_CCR_DMA_MASK |
+			       ADC_CCR_DDS | ADC_CCR_DELAY_MASK)) |
+		  (nadcs == 3 ? ADC_CCR_MULTI_TRIPLE_INTERLEAVED :
+				ADC_CCR_MULTI_DUAL_INTERLEAVED) |
+		  ADC_CCR_DMA_MODE_2 | ADC_CCR_DDS |
+		  ((delay - 5) << ADC_CCR_DELAY_SHIFT);
+
+	acq->adc = ADC1;
+	acq->buf = buf;
+	acq->nscans = nsamples;
+	acq->nchannels = 1;
+	acq->block = block;
+	acq->arg = arg;
+	acq->blocks = 0;
+	acq->overruns = 0;
+
+	/* Each ADC converts once per period, one start every (stretched) delay */
+	conv = adc_conversion_cycles(time, resolution);
+	if (delay < smp + 2) {
+		delay = smp + 2;
+	}
+	period = nadcs * delay > conv ? nadcs * delay : conv;
+	return (uint64_t)adcclk * nadcs / period;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief ADC Start Interleaved Acquisition
+
+@p start must set up a circular transfer of n half words, ie n / 2 words,
+from ADC_CDR (not ADC_DR) with half and full transfer interrupts, which call
+adc_acq_dma_isr(). The ADCs are then powered and ADC1 started; the slaves
+follow.
+
+@param[in] acq Acquisition state, from adc_interleave_init().
+@param[in] start Starts the DMA transfer.
+*/
+
+void adc_interleave_start(struct adc_acq *acq, adc_acq_dma_callback start)
+{
+	bool triple = (ADC_CCR & ADC_CCR_MULTI_MASK) ==
+		      ADC_CCR_MULTI_TRIPLE_INTERLEAVED;
+
+	start(ADC1, acq->buf, 2 * acq->nscans);
+	if (triple) {
+		adc_power_on(ADC3);
+	}
+	adc_power_on(ADC2);
+	adc_power_on(ADC1);
+	adc_start_conversion_regular(ADC1);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief ADC Stop Interleaved Acquisition
+
+Powers the ADCs off and returns them to independent mode.
+
+@param[in] acq Acquisition state.
+*/
+
+void adc_interleave_stop(struct adc_acq *acq)
+{
+	bool triple = (ADC_CCR & ADC_CCR_MULTI_MASK) ==
+		      ADC_CCR_MULTI_TRIPLE_INTERLEAVED;
+
+	(void)acq;
+	adc_power_off(ADC1);
+	adc_power_off(ADC2);
+	if (triple) {
+		adc_power_off(ADC3);
+	}
+	ADC_CCR &= ~(ADC_CCR_MULTI_MASK | ADC_CCR_DMA_MASK | ADC_CCR_DDS);
+}
+
 /**@}*/
\ No newline at end of file
@@ -0,0 +1,58 @@
+/** @addtogroup adc_file ADC peripheral API
+@ingroup peripheral_apis
+
+Regular group oversampling, common to the STM32G4 and STM32L4 ADC.
+
+LGPL License Terms @ref lgpl_license
+ */
+
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**@{*/
+
+#include <libopencm3/stm32/adc.h>
+
+/**
+ * Enable oversampling of the regular group
+ * Each result is the sum of @p ratio conversions shifted right by @p shift,
+ * up to 16 bits, which trades sample rate for resolution without CPU or
+ * DMA load. The ADC must be idle.
+ * @param[in] adc ADC block register address base
+ * @param[in] ratio ADC_CFGR2_OVSR_2x .. ADC_CFGR2_OVSR_256x
+ * @param[in] shift Right shift of the sum, 0 to 8
+ * @sa adc_disable_regular_oversampling
+ */
+void adc_enable_regular_oversampling(uint32_t adc, uint32_t ratio,
+				     uint8_t shift)
+{
+	ADC_CFGR2(adc) = (ADC_CFGR2(adc) &
+			  ~(ADC_CFGR2_OVSR_MASK | ADC_CFGR2_OVSS_MASK)) |
+			 ratio | ADC_CFGR2_OVSS_VAL(shift) | ADC_CFGR2_ROVSE;
+}
+
+/**
+ * Disable oversampling of the regular group
+ * @param[in] adc ADC block register address base
+ * @sa adc_enable_regular_oversampling
+ */
+void adc_disable_regular_oversampling(uint32_t adc)
+{
+	ADC_CFGR2(adc) &= ~ADC_CFGR2_ROVSE;
+}
+
+/**@}*/
@@ -0,0 +1,71 @@
+/** @addtogroup adc_file ADC peripheral API
+@ingroup peripheral_apis
+
+Acquisition engine helpers shared by the v1 and v2 "multi" ADC. The
+sequence setup in adc_acq_init(), adc_acq_start() and adc_acq_stop() is
+peripheral specific and lives in adc_common_v1_multi.c and
+adc_common_v2_multi.c.
+
+LGPL License Terms @ref lgpl_license
+ */
+
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**@{*/
+
+#include <libopencm3/stm32/adc.h>
+
+/**
+ * @brief ADC Deliver a Completed Buffer Half
+ *
+ * Call from the DMA half transfer (@p full false) and transfer complete
+ * (@p full true) interrupts of the acquisition stream.
+ *
+ * @param[in] acq Acquisition state
+ * @param[in] full Second half completed
+ */
+void adc_acq_dma_isr(struct adc_acq *acq, bool full)
+{
+	uint32_t half = acq->nscans * acq->nchannels;
+
+	acq->blocks++;
+	if (acq->block) {
+		acq->block(acq->buf + (full ? half : 0), acq->nscans, acq->arg);
+	}
+}
+
+/**
+ * @brief ADC Check an Acquisition for Overrun
+ *
+ * An overrun, a conversion not read by DMA in time, stops the DMA requests.
+ * Stop the DMA stream and call adc_acq_start() again to recover.
+ *
+ * @param[in] acq Acquisition state
+ * @returns true if an overrun occurred; it is counted and cleared
+ */
+bool adc_acq_overrun(struct adc_acq *acq)
+{
+	if (!adc_get_overrun_flag(acq->adc)) {
+		return false;
+	}
+	adc_clear_overrun_flag(acq->adc);
+	acq->overruns++;
+	return true;
+}
+
+/**@}*/
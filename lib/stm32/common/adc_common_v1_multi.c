@@ -357,4 +357,92 @@ void adc_disable_temperature_sensor(void)
 	ADC_CCR &= ~ADC_CCR_TSVREFE;
 }
 
+/*---------------------------------------------------------------------------*/
+/** @brief ADC Set up a Continuous Acquisition
+
+Configures the regular sequence with per channel sample times for one scan
+per trigger, with DMA requests for every conversion, so a whole buffer of
+scans is sampled without CPU involvement. The ADC must be powered and idle.
+
+@param[out] acq Acquisition state.
+@param[in] adc Unsigned int32. ADC block register address base @ref
+adc_reg_base
+@param[in] channels Channels in scan order, 1 to 16.
+@param[in] nchannels Unsigned int8. Number of channels.
+@param[in] buf Unsigned int16 *. Buffer of 2 * @p nscans * @p nchannels samples.
+@param[in] nscans Unsigned int32. Scans per buffer half, ie per callback.
+@param[in] block Called with each completed buffer half.
+@param[in] arg Argument for @p block.
+*/
+
+void adc_acq_init(struct adc_acq *acq, uint32_t adc,
+		  const struct adc_acq_channel *channels, uint8_t nchannels,
+		  uint16_t *buf, uint32_t nscans, adc_acq_block_callback block,
+		  void *arg)
+{
+	uint8_t seq[16];
+	uint8_t i;
+
+	acq->adc = adc;
+	acq->buf = buf;
+	acq->nscans = nscans;
+	acq->nchannels = nchannels;
+	acq->block = block;
+	acq->arg = arg;
+	acq->blocks = 0;
+	acq->overruns = 0;
+
+	for (i = 0; i < nchannels && i < 16; i++) {
+		seq[i] = channels[i].channel;
+		adc_set_sample_time(adc, channels[i].channel,
+				    channels[i].sample_time);
+	}
+	adc_set_regular_sequence(adc, i, seq);
+	adc_enable_scan_mode(adc);
+	adc_set_single_conversion_mode(adc);
+	adc_eoc_after_group(adc);
+	adc_set_dma_continue(adc);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief ADC Start a Continuous Acquisition
+
+Starts the circular DMA transfer through @p start, then arms the trigger.
+Each trigger, typically a timer TRGO or compare event, converts one scan.
+Also used to restart after an overrun.
+
+@param[in] acq Acquisition state.
+@param[in] trigger Unsigned int32. Trigger identifier
+@ref adc_trigger_regular
+@param[in] polarity Unsigned int32. Trigger polarity @ref
+adc_trigger_polarity_regular
+@param[in] start Starts the DMA transfer.
+*/
+
+void adc_acq_start(struct adc_acq *acq, uint32_t trigger, uint32_t polarity,
+		   adc_acq_dma_callback start)
+{
+	uint32_t adc = acq->adc;
+
+	adc_disable_external_trigger_regular(adc);
+	/* Re-arm DMA requests, they stop on overrun */
+	adc_disable_dma(adc);
+	adc_clear_overrun_flag(adc);
+	start(adc, acq->buf, 2 * acq->nscans * acq->nchannels);
+	adc_enable_dma(adc);
+	adc_enable_external_trigger_regular(adc, trigger, polarity);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief ADC Stop a Continuous Acquisition
+
+@param[in] acq Acquisition state.
+*/
+
+void adc_acq_stop(struct adc_acq *acq)
+{
+	adc_disable_external_trigger_regular(acq->adc);
+	adc_disable_dma(acq->adc);
+}
+
 /**@}*/
@@ -129,5 +129,99 @@ void adc_set_regular_sequence(uint32_t adc, uint8_t length, uint8_t channel[])
 	ADC_SQR4(adc) = reg32_4;
 }
 
+/**
+ * @brief ADC Set up a Continuous Acquisition
+ *
+ * Configures the regular sequence with per channel sample times for one scan
+ * per trigger, with circular DMA requests, so a whole buffer of scans is
+ * sampled without CPU involvement. The ADC must be enabled and idle.
+ *
+ * @param[out] acq Acquisition state
+ * @param[in] adc ADC block register address base @ref adc_reg_base
+ * @param[in] channels Channels in scan order, 1 to 16
+ * @param[in] nchannels Number of channels
+ * @param[in] buf Buffer of 2 * @p nscans * @p nchannels samples
+ * @param[in] nscans Scans per buffer half, ie per callback
+ * @param[in] block Called with each completed buffer half
+ * @param[in] arg Argument for @p block
+ */
+void adc_acq_init(struct adc_acq *acq, uint32_t adc,
+		  const struct adc_acq_channel *channels, uint8_t nchannels,
+		  uint16_t *buf, uint32_t nscans, adc_acq_block_callback block,
+		  void *arg)
+{
+	uint8_t seq[16];
+	uint8_t i;
+
+	acq->adc = adc;
+	acq->buf = buf;
+	acq->nscans = nscans;
+	acq->nchannels = nchannels;
+	acq->block = block;
+	acq->arg = arg;
+	acq->blocks = 0;
+	acq->overruns = 0;
+
+	for (i = 0; i < nchannels && i < 16; i++) {
+		seq[i] = channels[i].channel;
+		adc_set_sample_time(adc, channels[i].channel,
+				    channels[i].sample_time);
+	}
+	adc_set_regular_sequence(adc, i, seq);
+	adc_set_single_conversion_mode(adc);
+	adc_enable_dma_circular_mode(adc);
+}
+
+/* Stop regular conversions and wait for the ADC to be idle */
+static void adc_acq_halt(uint32_t adc)
+{
+	if (ADC_CR(adc) & ADC_CR_ADSTART) {
+		ADC_CR(adc) |= ADC_CR_ADSTP;
+		while (ADC_CR(adc) & ADC_CR_ADSTART);
+	}
+}
+
+/**
+ * @brief ADC Start a Continuous Acquisition
+ *
+ * Starts the circular DMA transfer through @p start, then arms the trigger.
+ * Each trigger, typically a timer TRGO or compare event, converts one scan.
+ * Also used to restart after an overrun.
+ *
+ * @param[in] acq Acquisition state
+ * @param[in] trigger External trigger selection, ADC_CFGR1_EXTSEL_VAL(x)
+ * @param[in] polarity Trigger polarity, @ref adc_cfgr1_exten
+ * @param[in] start Starts the DMA transfer
+ */
+void adc_acq_start(struct adc_acq *acq, uint32_t trigger, uint32_t polarity,
+		   adc_acq_dma_callback start)
+{
+	uint32_t adc = acq->adc;
+
+	adc_acq_halt(adc);
+	/* Re-arm DMA requests, they stop on overrun */
+	adc_disable_dma(adc);
+	adc_clear_overrun_flag(adc);
+	start(adc, acq->buf, 2 * acq->nscans * acq->nchannels);
+	adc_enable_dma(adc);
+
+	ADC_CFGR1(adc) = (ADC_CFGR1(adc) &
+			  ~(ADC_CFGR1_EXTSEL_MASK | ADC_CFGR1_EXTEN_MASK)) |
+			 trigger | polarity;
+	adc_start_conversion_regular(adc);
+}
+
+/**
+ * @brief ADC Stop a Continuous Acquisition
+ *
+ * @param[in] acq Acquisition state
+ */
+void adc_acq_stop(struct adc_acq *acq)
+{
+	adc_acq_halt(acq->adc);
+	ADC_CFGR1(acq->adc) &= ~ADC_CFGR1_EXTEN_MASK;
+	adc_disable_dma(acq->adc);
+}
+
 /**@}*/
 
@@ -38,6 +38,33 @@ LGPL License Terms @ref lgpl_license
 
 #include <libopencm3/stm32/cordic.h>
 
+#define CORDIC_CSR_CONFIG_MASK  (CORDIC_CSR_ARGSIZE | CORDIC_CSR_RESSIZE | \
+                                 CORDIC_CSR_NARGS | CORDIC_CSR_NRES | \
+                                 CORDIC_CSR_SCALE_MASK | \
+                                 CORDIC_CSR_PRECISION_MASK | \
+                                 CORDIC_CSR_FUNC_MASK)
+
+#define CORDIC_CONFIG(func, prec) \
+        (((func) << CORDIC_CSR_FUNC_SHIFT) | \
+         ((prec) << CORDIC_CSR_PRECISION_SHIFT))
+
+/* 16 bit arguments and results, both packed in one word */
+#define CORDIC_CONFIG_Q15(func) \
+        (CORDIC_CONFIG(func, CORDIC_CSR_PRECISION_ITER_20) | \
+         CORDIC_CSR_ARGSIZE | CORDIC_CSR_RESSIZE)
+
+#define CORDIC_CONFIG_Q31(func) \
+        CORDIC_CONFIG(func, CORDIC_CSR_PRECISION_ITER_28)
+
+/* Apply a configuration in one write, or none if it is already set */
+static void cordic_set_config(uint32_t config) {
+        uint32_t csr = CORDIC_CSR;
+
+        if ((csr & CORDIC_CSR_CONFIG_MASK) != config) {
+                CORDIC_CSR = (csr & ~CORDIC_CSR_CONFIG_MASK) | config;
+        }
+}
+
 
 /** @brief Read CORDIC result ready flag
  *
@@ -294,13 +321,8 @@ uint32_t cordic_read_32bit_result(void) {
  *
  */
 void cordic_configure_for_cos_16bit(void) {
-        cordic_set_function(CORDIC_CSR_FUNC_COS);
-        cordic_set_precision(CORDIC_CSR_PRECISION_ITER_20);
-        cordic_set_argument_width_16bit();
-        cordic_set_result_width_16bit();
-        cordic_set_number_of_arguments_1();
-        cordic_set_number_of_results_1();
         /* scale is not applicable for cos */
+        cordic_set_config(CORDIC_CONFIG_Q15(CORDIC_CSR_FUNC_COS));
 }
 
 /** @brief Configure cordic for 32 bit cosine
@@ -309,13 +331,8 @@ void cordic_configure_for_cos_16bit(void) {
  *
  */
 void cordic_configure_for_cos_32bit(void) {
-        cordic_set_function(CORDIC_CSR_FUNC_COS);
-        cordic_set_precision(CORDIC_CSR_PRECISION_ITER_28);
-        cordic_set_argument_width_32bit();
-        cordic_set_result_width_32bit();
-        cordic_set_number_of_arguments_1();
-        cordic_set_number_of_results_1();
-        /* scale is not applicable for cos  */
+        /* scale is not applicable for cos */
+        cordic_set_config(CORDIC_CONFIG_Q31(CORDIC_CSR_FUNC_COS));
 }
 
 /** @brief Configure cordic for 16 bit sine
@@ -324,13 +341,8 @@ void cordic_configure_for_cos_32bit(void) {
  *
  */
 void cordic_configure_for_sin_16bit(void) {
-        cordic_set_function(CORDIC_CSR_FUNC_SIN);
-        cordic_set_precision(CORDIC_CSR_PRECISION_ITER_20);
-        cordic_set_argument_width_16bit();
-        cordic_set_result_width_16bit();
-        cordic_set_number_of_arguments_1();
-        cordic_set_number_of_results_1();
-        /* scale is not applicable for sin  */
+        /* scale is not applicable for sin */
+        cordic_set_config(CORDIC_CONFIG_Q15(CORDIC_CSR_FUNC_SIN));
 }
 
 /** @brief Configure cordic for 32 bit sine
@@ -339,13 +351,8 @@ void cordic_configure_for_sin_16bit(void) {
  *
  */
 void cordic_configure_for_sin_32bit(void) {
-        cordic_set_function(CORDIC_CSR_FUNC_SIN);
-        cordic_set_precision(CORDIC_CSR_PRECISION_ITER_28);
-        cordic_set_argument_width_32bit();
-        cordic_set_result_width_32bit();
-        cordic_set_number_of_arguments_1();
-        cordic_set_number_of_results_1();
-        /* scale is not applicable for sin  */
+        /* scale is not applicable for sin */
+        cordic_set_config(CORDIC_CONFIG_Q31(CORDIC_CSR_FUNC_SIN));
 }
 
 /** @brief Compute 16 bit cosine using CORDIC (blocking)
@@ -485,3 +492,212 @@ void cordic_sin_32bit_async(int32_t x) {
         cordic_configure_for_sin_32bit();
         cordic_write_32bit_argument((uint32_t) x);
 }
+
+/** @brief Configure cordic for 16 bit sine and cosine
+ *
+ * Each argument word holds the angle in the lower and the modulus in the
+ * upper 16 bits; each result word holds the cosine in the lower and the sine
+ * in the upper 16 bits. Configuration is skipped if already set.
+ *
+ */
+void cordic_configure_sincos_q15(void) {
+        cordic_set_config(CORDIC_CONFIG_Q15(CORDIC_CSR_FUNC_COS));
+}
+
+/** @brief Configure cordic for 32 bit sine and cosine
+ *
+ * Arguments are written as angle, modulus; results read as cosine, sine.
+ * Configuration is skipped if already set.
+ *
+ */
+void cordic_configure_sincos_q31(void) {
+        cordic_set_config(CORDIC_CONFIG_Q31(CORDIC_CSR_FUNC_COS) |
+                          CORDIC_CSR_NARGS | CORDIC_CSR_NRES);
+}
+
+/** @brief Configure cordic for 16 bit phase and modulus
+ *
+ * Each argument word holds x in the lower and y in the upper 16 bits; each
+ * result word holds atan2(y, x)/pi in the lower and the modulus in the upper
+ * 16 bits. Configuration is skipped if already set.
+ *
+ */
+void cordic_configure_phase_q15(void) {
+        cordic_set_config(CORDIC_CONFIG_Q15(CORDIC_CSR_FUNC_PHASE));
+}
+
+/** @brief Configure cordic for 16 bit square root
+ *
+ * Arguments and results use the lower 16 bits of each word.
+ * Configuration is skipped if already set.
+ * @param[in] scale Scaling factor n, 0 to 2, see the reference manual for
+ * the input range of each.
+ *
+ */
+void cordic_configure_sqrt_q15(uint8_t scale) {
+        cordic_set_config(CORDIC_CONFIG_Q15(CORDIC_CSR_FUNC_SQRT) |
+                          ((scale << CORDIC_CSR_SCALE_SHIFT) &
+                           CORDIC_CSR_SCALE_MASK));
+}
+
+/** @brief Compute 16 bit sine and cosine of an array (blocking)
+ *
+ * Configures the peripheral once and keeps the next argument queued while
+ * each result is read, so the CORDIC never waits for the CPU.
+ * Computes 32767*sin(x/32767*pi) and 32767*cos(x/32767*pi).
+ * @param[in] angle arguments
+ * @param[out] sin sine results, may be NULL
+ * @param[out] cos cosine results, may be NULL
+ * @param[in] n number of arguments
+ *
+ */
+void cordic_sincos_q15_array(const int16_t *angle, int16_t *sin,
+                             int16_t *cos, uint32_t n) {
+        uint32_t i, r;
+
+        if (n == 0) {
+                return;
+        }
+
+        cordic_configure_sincos_q15();
+        CORDIC_WDATA = 0x7FFF0000 | (uint16_t)angle[0];
+        for (i = 0; i < n; i++) {
+                if (i + 1 < n) {
+                        CORDIC_WDATA = 0x7FFF0000 | (uint16_t)angle[i + 1];
+                }
+                r = CORDIC_RDATA;
+                if (cos) {
+                        cos[i] = r;
+                }
+                if (sin) {
+                        sin[i] = r >> 16;
+                }
+        }
+}
+
+/** @brief Compute 32 bit sine and cosine of an array (blocking)
+ *
+ * As cordic_sincos_q15_array() with 32 bit arguments and results.
+ * @param[in] angle arguments
+ * @param[out] sin sine results, may be NULL
+ * @param[out] cos cosine results, may be NULL
+ * @param[in] n number of arguments
+ *
+ */
+void cordic_sincos_q31_array(const int32_t *angle, int32_t *sin,
+                             int32_t *cos, uint32_t n) {
+        uint32_t i;
+        int32_t c, s;
+
+        if (n == 0) {
+                return;
+        }
+
+        cordic_configure_sincos_q31();
+        CORDIC_WDATA = angle[0];
+        CORDIC_WDATA = 0x7FFFFFFF;
+        for (i = 0; i < n; i++) {
+                if (i + 1 < n) {
+                        CORDIC_WDATA = angle[i + 1];
+                        CORDIC_WDATA = 0x7FFFFFFF;
+                }
+                c = CORDIC_RDATA;
+                s = CORDIC_RDATA;
+                if (cos) {
+                        cos[i] = c;
+                }
+                if (sin) {
+                        sin[i] = s;
+                }
+        }
+}
+
+/** @brief Compute 16 bit phase and modulus of an array (blocking)
+ *
+ * Computes 32767*atan2(y, x)/pi and sqrt(x*x + y*y), configuring the
+ * peripheral once. The modulus saturates for |(x, y)| > 1.
+ * @param[in] x x coordinates
+ * @param[in] y y coordinates
+ * @param[out] phase phase results, may be NULL
+ * @param[out] modulus modulus results, may be NULL
+ * @param[in] n number of points
+ *
+ */
+void cordic_phase_modulus_q15_array(const int16_t *x, const int16_t *y,
+                                    int16_t *phase, int16_t *modulus,
+                                    uint32_t n) {
+        uint32_t i, r;
+
+        if (n == 0) {
+                return;
+        }
+
+        cordic_configure_phase_q15();
+        CORDIC_WDATA = (uint32_t)(uint16_t)y[0] << 16 | (uint16_t)x[0];
+        for (i = 0; i < n; i++) {
+                if (i + 1 < n) {
+                        CORDIC_WDATA = (uint32_t)(uint16_t)y[i + 1] << 16 |
+                                       (uint16_t)x[i + 1];
+                }
+                r = CORDIC_RDATA;
+                if (phase) {
+                        phase[i] = r;
+                }
+                if (modulus) {
+                        modulus[i] = r >> 16;
+                }
+        }
+}
+
+/** @brief Compute 16 bit square roots of an array (blocking)
+ *
+ * The results are scaled by 2^-scale, see cordic_configure_sqrt_q15().
+ * @param[in] x arguments
+ * @param[out] out results
+ * @param[in] n number of arguments
+ * @param[in] scale scaling factor, 0 to 2
+ *
+ */
+void cordic_sqrt_q15_array(const int16_t *x, int16_t *out, uint32_t n,
+                           uint8_t scale) {
+        uint32_t i;
+
+        if (n == 0) {
+                return;
+        }
+
+        cordic_configure_sqrt_q15(scale);
+        CORDIC_WDATA = (uint16_t)x[0];
+        for (i = 0; i < n; i++) {
+                if (i + 1 < n) {
+                        CORDIC_WDATA = (uint16_t)x[i + 1];
+                }
+                out[i] = CORDIC_RDATA;
+        }
+}
+
+/** @brief Stream arguments and results by DMA
+ *
+ * Configure the function first, e.g. with cordic_configure_sincos_q15().
+ * @p start sets up the DMA streams from @p in to CORDIC_WDATA and from
+ * CORDIC_RDATA to @p out (these are part specific), then the CORDIC DMA
+ * requests are enabled. Call cordic_stop_dma() when the read stream
+ * completes.
+ * @param[in] in argument words, packed as for the configured function
+ * @param[out] out result words
+ * @param[in] n number of words in @p in and in @p out
+ * @param[in] start starts the DMA transfers
+ *
+ */
+void cordic_start_dma(const uint32_t *in, uint32_t *out, uint32_t n,
+                      cordic_dma_callback start) {
+        start(in, out, n);
+        CORDIC_CSR |= CORDIC_CSR_DMAWEN | CORDIC_CSR_DMAREN;
+}
+
+/** @brief Disable both CORDIC DMA requests
+ *
+ */
+void cordic_stop_dma(void) {
+        CORDIC_CSR &= ~(CORDIC_CSR_DMAWEN | CORDIC_CSR_DMAREN);
+}
@@ -112,5 +112,209 @@ void crc_set_initial(uint32_t initial)
 	CRC_INIT = initial;
 }
 
-/**@}*/
+/*---------------------------------------------------------------------------*/
+/* Streaming API
+ *
+ * The unit takes 8, 16 and 32 bit writes to CRC_DR, processing the most
+ * significant byte first. Feeding bytes in memory order therefore means byte
+ * swapping each little endian word, and reflected input is done per byte
+ * (REV_IN_BYTE) so that it stays the same whatever the access size.
+ */
+
+const struct crc_config crc_config_crc32 = {
+	.polynomial = 0x04C11DB7,
+	.polysize = CRC_CR_POLYSIZE_32,
+	.initial = 0xFFFFFFFF,
+	.reflect_in = true,
+	.reflect_out = true,
+	.xor_out = 0xFFFFFFFF,
+};
+
+const struct crc_config crc_config_crc32_mpeg2 = {
+	.polynomial = 0x04C11DB7,
+	.polysize = CRC_CR_POLYSIZE_32,
+	.initial = 0xFFFFFFFF,
+	.reflect_in = false,
+	.reflect_out = false,
+	.xor_out = 0,
+};
+
+const struct crc_config crc_config_crc16_ccitt = {
+	.polynomial = 0x1021,
+	.polysize = CRC_CR_POLYSIZE_16,
+	.initial = 0xFFFF,
+	.reflect_in = false,
+	.reflect_out = false,
+	.xor_out = 0,
+};
+
+const struct crc_config crc_config_crc16_modbus = {
+	.polynomial = 0x8005,
+	.polysize = CRC_CR_POLYSIZE_16,
+	.initial = 0xFFFF,
+	.reflect_in = true,
+	.reflect_out = true,
+	.xor_out = 0,
+};
+
+const struct crc_config crc_config_crc8 = {
+	.polynomial = 0x07,
+	.polysize = CRC_CR_POLYSIZE_8,
+	.initial = 0,
+	.reflect_in = false,
+	.reflect_out = false,
+	.xor_out = 0,
+};
+
+static uint32_t crc_width(uint32_t polysize)
+{
+	switch (polysize) {
+	case CRC_CR_POLYSIZE_7:
+		return 7;
+	case CRC_CR_POLYSIZE_8:
+		return 8;
+	case CRC_CR_POLYSIZE_16:
+		return 16;
+	default:
+		return 32;
+	}
+}
+
+static uint32_t crc_swap_word(uint32_t w)
+{
+	return (w >> 24) | ((w >> 8) & 0xff00) | ((w << 8) & 0xff0000) |
+	       (w << 24);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Start a streaming CRC calculation
+
+ Programs polynomial, size, initial value and input reflection from
+ @p config, and resets the unit. Output reflection and the final xor are
+ applied by crc_stream_finalize(), as the unit can only reverse a full
+ 32 bit result.
+
+ @param[in] config CRC algorithm, eg &crc_config_crc32.
+ */
+void crc_stream_init(const struct crc_config *config)
+{
+	crc_set_polysize(config->polysize);
+	crc_set_polynomial(config->polynomial);
+	crc_set_initial(config->initial);
+	crc_set_reverse_input(config->reflect_in ? CRC_CR_REV_IN_BYTE :
+			      CRC_CR_REV_IN_NONE);
+	crc_reverse_output_disable();
+	crc_reset();
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Add bytes to a streaming CRC calculation
+
+ @p data needs no particular alignment: an unaligned head and the tail are
+ written bytewise, everything in between a word at a time.
+
+ @param[in] data Bytes to add.
+ @param[in] len Number of bytes.
+ */
+void crc_stream_update(const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	const uint32_t *words;
+
+	/* Back from crc_stream_update_dma() */
+	if ((CRC_CR & CRC_CR_REV_IN) == CRC_CR_REV_IN_WORD) {
+		crc_set_reverse_input(CRC_CR_REV_IN_BYTE);
+	}
 
+	while (len && ((uintptr_t)p & 3)) {
+		CRC_DR8 = *p++;
+		len--;
+	}
+
+	words = (const uint32_t *)p;
+	while (len >= 4) {
+		CRC_DR = crc_swap_word(*words++);
+		len -= 4;
+	}
+
+	p = (const uint8_t *)words;
+	while (len--) {
+		CRC_DR8 = *p++;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Add bytes to a streaming CRC calculation using DMA
+
+ The unaligned head and the tail (at most three bytes each) are written by
+ the CPU, the aligned words in between are handed to @p start for a DMA
+ memory to memory transfer into CRC_DR. As DMA cannot byte swap, this is only
+ possible for algorithms with reflected input, where the unit is switched to
+ word reversal for the duration.
+
+ Nothing is done when the current algorithm has plain input; use
+ crc_stream_update() instead.
+
+ Once @p start returns, the caller must wait for the DMA transfer to complete
+ before touching the unit again, and then add the remaining
+ len - (return value) bytes starting at data + (return value) with
+ crc_stream_update() before finalizing.
+
+ @param[in] data Bytes to add.
+ @param[in] len Number of bytes.
+ @param[in] start Starts the DMA transfer.
+ @returns Number of bytes consumed so far, 0 if DMA can't be used.
+ */
+size_t crc_stream_update_dma(const void *data, size_t len,
+			     crc_dma_callback start)
+{
+	const uint8_t *p = data;
+	size_t head = (4 - ((uintptr_t)p & 3)) & 3;
+
+	uint32_t rev_in = CRC_CR & CRC_CR_REV_IN;
+
+	if ((rev_in != CRC_CR_REV_IN_BYTE && rev_in != CRC_CR_REV_IN_WORD) ||
+	    len < head + 4) {
+		return 0;
+	}
+
+	crc_stream_update(p, head);
+	len -= head;
+
+	/*
+	 * Reversing the whole little endian word puts the first byte, bit
+	 * reversed, in the top byte: the same as byte reversal of the
+	 * swapped word. crc_stream_update() switches back.
+	 */
+	crc_set_reverse_input(CRC_CR_REV_IN_WORD);
+	start((const uint32_t *)(p + head), len / 4);
+
+	return head + (len & ~(size_t)3);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Finish a streaming CRC calculation
+
+ @param[in] config The same algorithm as given to crc_stream_init().
+ @returns The CRC, in the low bits for polynomials shorter than 32 bits.
+ */
+uint32_t crc_stream_finalize(const struct crc_config *config)
+{
+	uint32_t width = crc_width(config->polysize);
+	uint32_t mask = (width == 32) ? 0xFFFFFFFF : ((1U << width) - 1);
+	uint32_t crc = CRC_DR & mask;
+	uint32_t i;
+
+	if (config->reflect_out) {
+		uint32_t rev = 0;
+
+		for (i = 0; i < width; i++) {
+			rev = (rev << 1) | ((crc >> i) & 1);
+		}
+		crc = rev;
+	}
+
+	return (crc ^ config->xor_out) & mask;
+}
+
+/**@}*/
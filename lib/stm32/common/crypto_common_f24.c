@@ -32,10 +32,18 @@
 
 /**@{*/
 
+#include <stddef.h>
 #include <libopencm3/stm32/crypto.h>
 
 #define CRYP_CR_ALGOMODE_MASK	((1 << 19) | CRYP_CR_ALGOMODE)
 
+/* Session whose key is in the key registers, NULL if unknown */
+static struct crypto_session *crypto_loaded;
+
+static crypto_done_callback crypto_dma_done;
+static void *crypto_dma_arg;
+static volatile bool crypto_dma_running;
+
 /**
  * @brief Wait, if the Controller is busy
  */
@@ -54,6 +62,7 @@ void crypto_set_key(enum crypto_keysize keysize, uint64_t key[])
 	int i;
 
 	crypto_wait_busy();
+	crypto_loaded = NULL;
 
 	CRYP_CR = (CRYP_CR & ~CRYP_CR_KEYSIZE) |
 		  (keysize << CRYP_CR_KEYSIZE_SHIFT);
@@ -66,7 +75,7 @@ void crypto_set_key(enum crypto_keysize keysize, uint64_t key[])
 /**
  * @brief Set Initialization Vector
  *
- * @param[in] iv uint64_t[] Initialization vector (array of 4 items)
+ * @param[in] iv uint64_t[] Initialization vector (array of 2 items, IV0 first)
 
  * @note Cryptographic controller must be in disabled state
  */
@@ -76,8 +85,9 @@ void crypto_set_iv(uint64_t iv[])
 
 	crypto_wait_busy();
 
-	for (i = 0; i < 4; i++) {
-		CRYP_IVR(i) = iv[i];
+	for (i = 0; i < 2; i++) {
+		CRYP_IVW(2 * i) = iv[i] >> 32;
+		CRYP_IVW(2 * i + 1) = iv[i];
 	}
 }
 
@@ -99,7 +109,8 @@ void crypto_set_datatype(enum crypto_datatype datatype)
  */
 void crypto_set_algorithm(enum crypto_mode mode)
 {
-	mode &= ~CRYP_CR_ALGOMODE_MASK;
+	mode &= CRYP_CR_ALGOMODE_MASK | CRYP_CR_ALGODIR;
+	crypto_loaded = NULL;
 
 	if ((mode == DECRYPT_AES_ECB) || (mode == DECRYPT_AES_CBC)) {
 		/* Unroll keys for the AES encoder for the user automatically */
@@ -112,7 +123,7 @@ void crypto_set_algorithm(enum crypto_mode mode)
 		/* module switches to DISABLE automatically */
 	}
 	/* set algo mode */
-	CRYP_CR = (CRYP_CR & ~CRYP_CR_ALGOMODE_MASK) | mode;
+	CRYP_CR = (CRYP_CR & ~(CRYP_CR_ALGOMODE_MASK | CRYP_CR_ALGODIR)) | mode;
 
 	/* flush buffers */
 	CRYP_CR |= CRYP_CR_FFLUSH;
@@ -172,4 +183,166 @@ uint32_t crypto_process_block(uint32_t *inp, uint32_t *outp, uint32_t length)
 	return wr;
 }
 
+/* Big endian word from bytes, as the key and IV registers take them */
+static uint32_t crypto_load_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+	       ((uint32_t)p[2] << 8) | p[3];
+}
+
+/**
+ * @brief Set up a cipher session
+ *
+ * Nothing is written to the controller until the session is started.
+ *
+ * @param[out] s Session to set up.
+ * @param[in] mode Mode of execution, @ref crypto_mode or (on F42xx/F43xx)
+ *                 @ref crypto_mode_mac
+ * @param[in] keysize enum crypto_keysize Size of the key.
+ * @param[in] key uint8_t* Key, 16, 24 or 32 bytes as in the standard, ie
+ *                most significant byte first
+ * @param[in] datatype enum crypto_datatype Swapping of the data words.
+ */
+void crypto_session_init(struct crypto_session *s, uint32_t mode,
+			 enum crypto_keysize keysize, const uint8_t *key,
+			 enum crypto_datatype datatype)
+{
+	uint32_t words = 4 + 2 * keysize;
+	uint32_t i;
+
+	if (crypto_loaded == s) {
+		crypto_loaded = NULL;
+	}
+
+	mode &= CRYP_CR_ALGOMODE_MASK | CRYP_CR_ALGODIR;
+	s->cr = mode | (keysize << CRYP_CR_KEYSIZE_SHIFT) |
+		(datatype << CRYP_CR_DATATYPE_SHIFT);
+	s->prepare = (mode == DECRYPT_AES_ECB) || (mode == DECRYPT_AES_CBC);
+
+	for (i = 0; i < 8; i++) {
+		s->key[i] = 0;
+	}
+	for (i = 0; i < words; i++) {
+		s->key[8 - words + i] = crypto_load_be32(key + 4 * i);
+	}
+}
+
+/**
+ * @brief Load a session without enabling the controller
+ *
+ * The key is only loaded, and prepared for AES ECB/CBC decryption, if
+ * another session was used since. Only for modes needing one phase, ie
+ * other than GCM/CCM, the controller can be enabled right after; see
+ * crypto_session_start().
+ *
+ * @param[in] s Session to load.
+ * @param[in] iv uint8_t* IV, 16 bytes most significant first (8 for DES),
+ *               or NULL to continue from the current chaining value
+ */
+void crypto_session_load(struct crypto_session *s, const uint8_t *iv)
+{
+	uint32_t i;
+
+	crypto_wait_busy();
+	CRYP_CR &= ~CRYP_CR_CRYPEN;
+
+	if (crypto_loaded != s) {
+		for (i = 0; i < 8; i++) {
+			CRYP_KEYW(i) = s->key[i];
+		}
+		if (s->prepare) {
+			CRYP_CR = (s->cr & CRYP_CR_KEYSIZE) |
+				  CRYP_CR_ALGOMODE_AES_PREP | CRYP_CR_CRYPEN;
+			crypto_wait_busy();
+		}
+		crypto_loaded = s;
+	}
+
+	CRYP_CR = s->cr;
+	if (iv) {
+		for (i = 0; i < 4; i++) {
+			CRYP_IVW(i) = crypto_load_be32(iv + 4 * i);
+		}
+	}
+	CRYP_CR |= CRYP_CR_FFLUSH;
+}
+
+/**
+ * @brief Load a session and enable the controller
+ *
+ * @param[in] s Session to start.
+ * @param[in] iv uint8_t* IV as for crypto_session_load(), NULL to continue
+ */
+void crypto_session_start(struct crypto_session *s, const uint8_t *iv)
+{
+	crypto_session_load(s, iv);
+	crypto_start();
+}
+
+/**
+ * @brief Forget which key is loaded
+ *
+ * Needed when the key registers were written behind the sessions' back.
+ */
+void crypto_session_invalidate(void)
+{
+	crypto_loaded = NULL;
+}
+
+/**
+ * @brief Process words by DMA
+ *
+ * The controller must be started. @p start sets up both DMA streams, then
+ * the controller's DMA requests are enabled. Call crypto_dma_isr() from the
+ * transfer complete interrupt of the output stream; it calls @p done.
+ *
+ * @param[in] in uint32_t* Input words.
+ * @param[out] out uint32_t* Output words.
+ * @param[in] n uint32_t Number of words, a multiple of the block size.
+ * @param[in] start Starts the DMA transfers.
+ * @param[in] done Completion callback, may be NULL.
+ * @param[in] arg Argument for @p done.
+ * @returns bool true, if started; false if a DMA operation is running
+ */
+bool crypto_process_dma(const uint32_t *in, uint32_t *out, uint32_t n,
+			crypto_dma_callback start, crypto_done_callback done,
+			void *arg)
+{
+	if (crypto_dma_running) {
+		return false;
+	}
+
+	crypto_dma_done = done;
+	crypto_dma_arg = arg;
+	crypto_dma_running = true;
+
+	start(in, out, n);
+	CRYP_DMACR = CRYP_DMACR_DIEN | CRYP_DMACR_DOEN;
+	return true;
+}
+
+/**
+ * @brief Finish a DMA operation
+ *
+ * Call from the transfer complete interrupt of the output DMA stream.
+ */
+void crypto_dma_isr(void)
+{
+	CRYP_DMACR = 0;
+	crypto_dma_running = false;
+	if (crypto_dma_done) {
+		crypto_dma_done(crypto_dma_arg);
+	}
+}
+
+/**
+ * @brief Tell if a DMA operation is running
+ *
+ * @returns bool true, until crypto_dma_isr() was called
+ */
+bool crypto_dma_busy(void)
+{
+	return crypto_dma_running;
+}
+
 /**@}*/
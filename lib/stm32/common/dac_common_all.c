@@ -124,6 +124,7 @@ LGPL License Terms @ref lgpl_license
 /**@{*/
 
 #include <libopencm3/stm32/dac.h>
+#include <libopencm3/stm32/timer.h>
 
 /** @brief DAC Channel Enable.
 
@@ -483,5 +484,155 @@ void dac_software_trigger(uint32_t dac, int channel)
 		break;
 	}
 }
+
+/* Data holding register for the stream's channel(s) and alignment */
+static uint32_t dac_stream_reg(struct dac_stream *s)
+{
+	volatile uint32_t *reg[3][3] = {
+		{ &DAC_DHR8R1(s->dac), &DAC_DHR12R1(s->dac), &DAC_DHR12L1(s->dac) },
+		{ &DAC_DHR8R2(s->dac), &DAC_DHR12R2(s->dac), &DAC_DHR12L2(s->dac) },
+		{ &DAC_DHR8RD(s->dac), &DAC_DHR12RD(s->dac), &DAC_DHR12LD(s->dac) },
+	};
+
+	return (uint32_t)reg[s->channel - 1][s->align];
+}
+
+/** @brief Set up Continuous DAC Output.
+
+Output is double buffered: while the DMA plays one half of @p buf, @p refill
+is asked for the other. For both channels, each sample is a 32 bit word as
+taken by the dual data holding registers, ie channel 1 in the lower half
+word, or lower byte for 8 bit data; otherwise samples are 16 bit.
+
+@param[out] s Stream state.
+@param[in] dac the base address of the DAC. @ref dac_reg_base
+@param[in] channel @ref dac_channel_id, DAC_CHANNEL_BOTH for packed output.
+@param[in] align enum ::dac_align. Alignment and size of the samples.
+@param[in] buf Buffer of 2 * @p n samples, filled before starting.
+@param[in] n Samples per buffer half.
+@param[in] refill Called with each played buffer half, may be NULL to loop
+the buffer as a fixed waveform.
+@param[in] arg Argument for @p refill.
+*/
+void dac_stream_init(struct dac_stream *s, uint32_t dac, int channel,
+		     enum dac_align align, void *buf, uint32_t n,
+		     dac_stream_refill_callback refill, void *arg)
+{
+	s->dac = dac;
+	s->channel = channel;
+	s->align = align;
+	s->buf = buf;
+	s->n = n;
+	s->refill = refill;
+	s->arg = arg;
+	s->halves = 0;
+	s->underruns = 0;
+}
+
+/** @brief Start Continuous DAC Output.
+
+Sets @p timer, normally TIM6 or TIM7, to trigger a conversion @p rate times
+per second, selects it as trigger of the stream's channel(s), starts the DMA
+through @p start and then the timer. Only channel 1 requests DMA for dual
+output. Also used to restart after an underrun.
+
+@param[in] s Stream state.
+@param[in] timer Timer register address base @ref tim_reg_base
+@param[in] timer_clock Timer input clock in Hz.
+@param[in] rate Samples per second.
+@param[in] trigger @ref dac_trig1_sel value for the timer, or for dual
+output @ref dac_trig1_sel and @ref dac_trig2_sel values OR-ed.
+@param[in] start Starts the DMA transfer.
+@returns the rate achieved, 0 if out of range and nothing was started.
+*/
+uint32_t dac_stream_start(struct dac_stream *s, uint32_t timer,
+			  uint32_t timer_clock, uint32_t rate,
+			  uint32_t trigger, dac_stream_dma_callback start)
+{
+	int dma_channel = s->channel == DAC_CHANNEL2 ? DAC_CHANNEL2 :
+						       DAC_CHANNEL1;
+	uint32_t mask = 0;
+
+	timer_disable_counter(timer);
+	rate = timer_set_update_rate(timer, timer_clock, rate);
+	if (rate == 0) {
+		return 0;
+	}
+
+	dac_dma_disable(s->dac, DAC_CHANNEL_BOTH);
+	if (s->channel & DAC_CHANNEL1) {
+		mask |= DAC_CR_TSEL1_MASK;
+	}
+	if (s->channel & DAC_CHANNEL2) {
+		mask |= DAC_CR_TSEL2_MASK;
+	}
+	DAC_CR(s->dac) = (DAC_CR(s->dac) & ~mask) | trigger;
+	dac_trigger_enable(s->dac, s->channel);
+	dac_enable(s->dac, s->channel);
+
+	DAC_SR(s->dac) = DAC_SR_DMAUDR1 | DAC_SR_DMAUDR2;
+	start(dac_stream_reg(s), s->buf, 2 * s->n);
+	dac_dma_enable(s->dac, dma_channel);
+	DAC_CR(s->dac) |= dma_channel == DAC_CHANNEL1 ? DAC_CR_DMAUDRIE1 :
+							DAC_CR_DMAUDRIE2;
+
+	timer_enable_counter(timer);
+	return rate;
+}
+
+/** @brief Stop Continuous DAC Output.
+
+The outputs keep the last sample.
+
+@param[in] s Stream state.
+@param[in] timer Timer register address base @ref tim_reg_base
+*/
+void dac_stream_stop(struct dac_stream *s, uint32_t timer)
+{
+	timer_disable_counter(timer);
+	DAC_CR(s->dac) &= ~(DAC_CR_DMAUDRIE1 | DAC_CR_DMAUDRIE2);
+	dac_dma_disable(s->dac, DAC_CHANNEL_BOTH);
+}
+
+/** @brief Refill a Played Buffer Half.
+
+Call from the DMA half transfer (@p full false) and transfer complete
+(@p full true) interrupts of the stream.
+
+@param[in] s Stream state.
+@param[in] full Second half played.
+*/
+void dac_stream_dma_isr(struct dac_stream *s, bool full)
+{
+	uint32_t size = s->channel == DAC_CHANNEL_BOTH ? 4 : 2;
+
+	s->halves++;
+	if (s->refill) {
+		s->refill((uint8_t *)s->buf + (full ? s->n * size : 0), s->n,
+			  s->arg);
+	}
+}
+
+/** @brief Handle a DAC Underrun.
+
+Call from the DAC (often shared with TIM6) interrupt. A trigger that found
+the previous DMA request unserved stops the DMA requests; the stream must
+then be stopped, including its DMA stream, and started again.
+
+@param[in] s Stream state.
+@returns true if an underrun occurred; it is counted and cleared.
+*/
+bool dac_stream_isr(struct dac_stream *s)
+{
+	uint32_t sr = DAC_SR(s->dac) & (DAC_SR_DMAUDR1 | DAC_SR_DMAUDR2);
+
+	if (!sr) {
+		return false;
+	}
+	DAC_SR(s->dac) = sr;
+	s->underruns++;
+	return true;
+}
+
 /**@}*/
 
@@ -14,5 +14,313 @@
 /**@{*/
 
 #include <libopencm3/stm32/dcmi.h>
+#include <libopencm3/stm32/dma.h>
+
+/* DMA transfers are limited to 65535 items, kept a multiple of the burst */
+#define DCMI_CHUNK_MAX		65532
+
+/* Point the DMA stream at the start of the current frame and enable it */
+static void dcmi_arm(struct dcmi_capture *c)
+{
+	uint8_t *frame = c->frames[c->cur];
+
+	dma_disable_stream(c->dma, c->stream);
+	while (DMA_SCR(c->dma, c->stream) & DMA_SxCR_EN);
+
+	dma_clear_interrupt_flags(c->dma, c->stream, DMA_TCIF | DMA_TEIF |
+				  DMA_DMEIF | DMA_FEIF);
+	dma_set_memory_address(c->dma, c->stream, (uint32_t)frame);
+	if (c->nchunks > 1) {
+		dma_set_memory_address_1(c->dma, c->stream,
+					 (uint32_t)(frame + 4 * c->chunk));
+		dma_set_initial_target(c->dma, c->stream, 0);
+	}
+	dma_set_number_of_data(c->dma, c->stream, c->chunk);
+	c->done = 0;
+	c->overflow = false;
+	dma_enable_stream(c->dma, c->stream);
+}
+
+/* Bytes written to the current frame by the DMA, which must be stopped */
+static uint32_t dcmi_received(struct dcmi_capture *c)
+{
+	uint8_t *frame = c->frames[c->cur];
+	uint8_t *chunk;
+	uint32_t len;
+
+	/* Full: the DMA was stopped on a target it had not started */
+	if (c->done >= c->nchunks) {
+		return c->frame_size;
+	}
+	if (DMA_SCR(c->dma, c->stream) & DMA_SxCR_CT) {
+		chunk = (uint8_t *)DMA_SM1AR(c->dma, c->stream);
+	} else {
+		chunk = (uint8_t *)DMA_SM0AR(c->dma, c->stream);
+	}
+	len = (uint32_t)(chunk - frame) +
+	      4 * (c->chunk - dma_get_number_of_data(c->dma, c->stream));
+	return len < c->frame_size ? len : c->frame_size;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DCMI Capture Setup
+
+Sets up the DMA stream, DMA2 stream 1 or 7 channel 1, to move 32 bit words
+from DCMI_DR into the frame buffers, in double buffer mode so that frames
+larger than one DMA transfer are received in chunks, the idle chunk being
+moved along from dcmi_dma_isr(). The DMA is stopped once a frame buffer is
+full, so a frame larger than expected, or a missed end of frame, never
+writes past it; the frame is dropped as an error. With two frame buffers, one is captured
+into while the other, last completed, is handed to @p frame: continuous
+capture without tearing and without copying, as long as the application is
+done with it by the end of the next frame.
+
+The application calls dcmi_isr() and dcmi_dma_isr() from its DCMI and DMA
+stream interrupt handlers, with both interrupts enabled in the NVIC, and
+sets up the DCMI pins and clocks.
+
+@param[out] c Capture state.
+@param[in] dma DMA controller base address.
+@param[in] stream DMA stream.
+@param[in] channel DMA channel selection, DMA_SxCR_CHSEL_*.
+@param[in] frame0 First frame buffer, word aligned.
+@param[in] frame1 Second frame buffer, or NULL for a single one.
+@param[in] frame_size Bytes per frame buffer, at least one whole frame. The
+usable size is rounded down to equal transfers of a multiple of 16 bytes,
+see c->frame_size; VGA at 2 bytes per pixel fits exactly.
+@param[in] frame Called with each captured frame, may be NULL.
+@param[in] event Called with line and VSYNC events, may be NULL.
+@param[in] arg Argument for the callbacks.
+*/
+void dcmi_capture_init(struct dcmi_capture *c, uint32_t dma, uint8_t stream,
+		       uint32_t channel, void *frame0, void *frame1,
+		       uint32_t frame_size, dcmi_frame_callback frame,
+		       dcmi_event_callback event, void *arg)
+{
+	uint32_t words = frame_size / 4;
+	uint32_t nchunks = (words + DCMI_CHUNK_MAX - 1) / DCMI_CHUNK_MAX;
+
+	/* Equal chunks, a multiple of the 4 word burst, within the buffer */
+	c->nchunks = nchunks;
+	c->chunk = (words / nchunks) & ~3;
+	c->frame_size = 4 * c->chunk * nchunks;
+
+	c->dma = dma;
+	c->stream = stream;
+	c->frames[0] = frame0;
+	c->frames[1] = frame1;
+	c->nframes = frame1 ? 2 : 1;
+	c->cur = 0;
+	c->frame = frame;
+	c->event = event;
+	c->arg = arg;
+	c->captured = 0;
+	c->errors = 0;
+
+	DCMI_CR = 0;
+	dma_stream_reset(dma, stream);
+	dma_channel_select(dma, stream, channel);
+	dma_set_transfer_mode(dma, stream, DMA_SxCR_DIR_PERIPHERAL_TO_MEM);
+	dma_set_priority(dma, stream, DMA_SxCR_PL_HIGH);
+	dma_set_peripheral_address(dma, stream, (uint32_t)&DCMI_DR);
+	dma_set_peripheral_size(dma, stream, DMA_SxCR_PSIZE_32BIT);
+	dma_set_memory_size(dma, stream, DMA_SxCR_MSIZE_32BIT);
+	dma_enable_memory_increment_mode(dma, stream);
+	dma_enable_fifo_mode(dma, stream);
+	dma_set_fifo_threshold(dma, stream, DMA_SxFCR_FTH_4_4_FULL);
+	dma_set_memory_burst(dma, stream, DMA_SxCR_MBURST_INCR4);
+	if (nchunks > 1) {
+		dma_enable_double_buffer_mode(dma, stream);
+	}
+	dma_enable_transfer_complete_interrupt(dma, stream);
+	dma_enable_transfer_error_interrupt(dma, stream);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DCMI Set Crop Window
+
+Takes effect from the next frame captured.
+
+@param[in] x Pixel clocks to skip at the start of each line.
+@param[in] y Lines to skip at the start of each frame.
+@param[in] width Pixel clocks captured per line; 2 per pixel for RGB565
+and YCbCr in 8 bit mode.
+@param[in] height Lines captured.
+*/
+void dcmi_set_crop(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+	DCMI_CWSTRT = (y & DCMI_CWSTRT_VST_MASK) << DCMI_CWSTRT_VST_SHIFT |
+		      (x & DCMI_CWSTRT_HOFFCNT_MASK) <<
+		      DCMI_CWSTRT_HOFFCNT_SHIFT;
+	DCMI_CWSIZE = ((height - 1) & DCMI_CWSIZE_VLINE_MASK) <<
+		      DCMI_CWSIZE_VLINE_SHIFT |
+		      ((width - 1) & DCMI_CWSIZE_CAPCNT_MASK) <<
+		      DCMI_CWSIZE_CAPCNT_SHIFT;
+	DCMI_CR |= DCMI_CR_CROP;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DCMI Disable Crop Window
+*/
+void dcmi_disable_crop(void)
+{
+	DCMI_CR &= ~DCMI_CR_CROP;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DCMI Start Capture
+
+Capture begins with the next frame.
+
+@param[in] c Capture state.
+@param[in] cr DCMI_CR settings: polarities, DCMI_CR_ESS, DCMI_CR_JPEG, data
+width, frame rate control, and DCMI_CR_CM for a single snapshot rather than
+continuous capture. The crop window set is kept.
+@param[in] events DCMI_IER_LINE and/or DCMI_IER_VSYNC for the event callback.
+*/
+void dcmi_capture_start(struct dcmi_capture *c, uint32_t cr, uint32_t events)
+{
+	DCMI_CR = (DCMI_CR & DCMI_CR_CROP) | (cr & ~DCMI_CR_CAPTURE);
+	DCMI_ICR = DCMI_ICR_LINE | DCMI_ICR_VSYNC | DCMI_ICR_ERR |
+		   DCMI_ICR_OVR | DCMI_ICR_FRAME;
+	DCMI_IER = (events & (DCMI_IER_LINE | DCMI_IER_VSYNC)) |
+		   DCMI_IER_ERR | DCMI_IER_OVR | DCMI_IER_FRAME;
+	DCMI_CR |= DCMI_CR_EN;
+	dcmi_arm(c);
+	DCMI_CR |= DCMI_CR_CAPTURE;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DCMI Capture Next Snapshot
+
+In snapshot mode, captures the next frame, into the frame buffer not handed
+out last when there are two.
+
+@param[in] c Capture state.
+*/
+void dcmi_capture_snapshot(struct dcmi_capture *c)
+{
+	dcmi_arm(c);
+	DCMI_CR |= DCMI_CR_CAPTURE;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DCMI Stop Capture
+
+@param[in] c Capture state.
+*/
+void dcmi_capture_stop(struct dcmi_capture *c)
+{
+	DCMI_CR &= ~DCMI_CR_CAPTURE;
+	/* Capture stops at the end of the frame being received */
+	while (DCMI_CR & DCMI_CR_CAPTURE);
+	DCMI_IER = 0;
+	DCMI_CR &= ~DCMI_CR_EN;
+	dma_disable_stream(c->dma, c->stream);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DCMI Interrupt Handler
+
+At the end of a frame, stops the DMA once the DCMI FIFO is empty, hands the
+frame to the frame callback and, unless in snapshot mode, starts the DMA over
+in the other frame buffer; blanking gives the time for this. On an overrun or
+synchronisation error, capture restarts from the next frame. Line and VSYNC
+events are passed on to the event callback.
+
+@param[in] c Capture state.
+*/
+void dcmi_isr(struct dcmi_capture *c)
+{
+	uint32_t mis = DCMI_MIS;
+	uint8_t *frame;
+	uint32_t len;
+
+	DCMI_ICR = mis;
+
+	if (mis & (DCMI_MIS_OVR | DCMI_MIS_ERR)) {
+		c->errors++;
+		DCMI_CR &= ~DCMI_CR_CAPTURE;
+		dcmi_arm(c);
+		DCMI_CR |= DCMI_CR_CAPTURE;
+		mis &= ~DCMI_MIS_FRAME;
+	}
+
+	if (mis & DCMI_MIS_FRAME) {
+		while (DCMI_SR & DCMI_SR_FNE);
+		dma_disable_stream(c->dma, c->stream);
+		while (DMA_SCR(c->dma, c->stream) & DMA_SxCR_EN);
+
+		frame = c->frames[c->cur];
+		len = dcmi_received(c);
+		if (c->overflow) {
+			/* Dropped, captured again into the same buffer */
+			if (!(DCMI_CR & DCMI_CR_CM)) {
+				dcmi_arm(c);
+			}
+		} else {
+			c->captured++;
+			c->cur = (c->cur + 1) % c->nframes;
+			if (!(DCMI_CR & DCMI_CR_CM)) {
+				dcmi_arm(c);
+			}
+			if (c->frame) {
+				c->frame(frame, len, c->arg);
+			}
+		}
+	}
+
+	mis &= DCMI_MIS_LINE | DCMI_MIS_VSYNC;
+	if (mis && c->event) {
+		c->event(mis, c->arg);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DCMI DMA Interrupt Handler
+
+On each completed chunk, points the DMA target just finished at the chunk
+after the one now being received, if there is one; once the frame buffer is
+full, stops the DMA. Data received past the end meanwhile only went to the
+current frame, which is then dropped.
+
+@param[in] c Capture state.
+*/
+void dcmi_dma_isr(struct dcmi_capture *c)
+{
+	uint32_t addr;
+
+	if (dma_get_interrupt_flag(c->dma, c->stream, DMA_TEIF)) {
+		dma_clear_interrupt_flags(c->dma, c->stream, DMA_TEIF);
+		c->errors++;
+	}
+	if (!dma_get_interrupt_flag(c->dma, c->stream, DMA_TCIF)) {
+		return;
+	}
+	dma_clear_interrupt_flags(c->dma, c->stream, DMA_TCIF);
+
+	if (++c->done >= c->nchunks) {
+		dma_disable_stream(c->dma, c->stream);
+		while (DMA_SCR(c->dma, c->stream) & DMA_SxCR_EN);
+		/* The idle target, parked in this frame, was already used */
+		if (c->nchunks > 1 &&
+		    dma_get_number_of_data(c->dma, c->stream) != c->chunk) {
+			c->overflow = true;
+			c->errors++;
+		}
+		return;
+	}
+	if (c->done + 1 >= c->nchunks) {
+		/* No chunk left, the idle target keeps a used one */
+		return;
+	}
+
+	addr = (uint32_t)(c->frames[c->cur] + 4 * c->chunk * (c->done + 1));
+	if (dma_get_target(c->dma, c->stream)) {
+		dma_set_memory_address(c->dma, c->stream, addr);
+	} else {
+		dma_set_memory_address_1(c->dma, c->stream, addr);
+	}
+}
 
 /**@}*/
\ No newline at end of file
@@ -26,8 +26,325 @@
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <libopencm3/stm32/common/dma2d_common_f47.h>
+#include <libopencm3/cm3/cortex.h>
+#include <libopencm3/stm32/dma2d.h>
+#include <stddef.h>
 
 /**@{*/
 
+#define DMA2D_CR_IRQS		(DMA2D_CR_CEIE | DMA2D_CR_CTCIE | \
+				 DMA2D_CR_CAEIE | DMA2D_CR_TCIE | \
+				 DMA2D_CR_TEIE)
+#define DMA2D_ISR_ERRORS	(DMA2D_ISR_CEIF | DMA2D_ISR_CAEIF | \
+				 DMA2D_ISR_TEIF)
+
+static struct dma2d_command *dma2d_queue;
+static uint32_t dma2d_size;
+static volatile uint32_t dma2d_head, dma2d_count;
+static volatile uint32_t dma2d_error_count;
+static volatile bool dma2d_running;
+static dma2d_done_callback dma2d_done;
+static void *dma2d_done_arg;
+/* CLUTs in the DMA2D, so that repeated draws from one palette load it once */
+static const uint32_t *dma2d_fgclut, *dma2d_bgclut;
+
+/* Program and start the command at the head of the queue, loading its
+ * CLUT(s) first if needed; each CLUT load ends with a CTCIF interrupt. */
+static void dma2d_run(void)
+{
+	const struct dma2d_command *c;
+
+	if (dma2d_count == 0) {
+		dma2d_running = false;
+		if (dma2d_done) {
+			dma2d_done(dma2d_done_arg);
+		}
+		return;
+	}
+
+	dma2d_running = true;
+	c = &dma2d_queue[dma2d_head];
+	DMA2D_CR = DMA2D_CR_IRQS;
+	if (c->fgclut && c->fgclut != dma2d_fgclut) {
+		dma2d_fgclut = c->fgclut;
+		DMA2D_FGCMAR = (uint32_t)c->fgclut;
+		DMA2D_FGPFCCR = c->fgpfccr | DMA2D_xPFCCR_START;
+		return;
+	}
+	if (c->bgclut && c->bgclut != dma2d_bgclut) {
+		dma2d_bgclut = c->bgclut;
+		DMA2D_BGCMAR = (uint32_t)c->bgclut;
+		DMA2D_BGPFCCR = c->bgpfccr | DMA2D_xPFCCR_START;
+		return;
+	}
+
+	DMA2D_FGPFCCR = c->fgpfccr;
+	DMA2D_BGPFCCR = c->bgpfccr;
+	DMA2D_OPFCCR = c->opfccr;
+	DMA2D_FGMAR = c->fgmar;
+	DMA2D_FGOR = c->fgor;
+	DMA2D_BGMAR = c->bgmar;
+	DMA2D_BGOR = c->bgor;
+	DMA2D_OCOLR = c->ocolr;
+	DMA2D_OMAR = c->omar;
+	DMA2D_OOR = c->oor;
+	DMA2D_NLR = c->nlr;
+	DMA2D_CR = c->cr | DMA2D_CR_IRQS | DMA2D_CR_START;
+}
+
+/* Queue a command, starting it if the DMA2D is idle */
+static bool dma2d_submit(const struct dma2d_command *c)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+	bool ok = dma2d_count < dma2d_size;
+
+	if (ok) {
+		dma2d_queue[(dma2d_head + dma2d_count) % dma2d_size] = *c;
+		dma2d_count++;
+		if (!dma2d_running) {
+			dma2d_run();
+		}
+	}
+	cm_mask_interrupts(mask);
+	return ok;
+}
+
+static uint32_t dma2d_pfccr(const struct dma2d_image *img)
+{
+	uint32_t pfccr = (img->format & DMA2D_xPFCCR_CM_MASK) |
+			 (img->alpha_mode & DMA2D_xPFCCR_AM_MASK) <<
+			 DMA2D_xPFCCR_AM_SHIFT |
+			 (uint32_t)img->alpha << DMA2D_xPFCCR_ALPHA_SHIFT;
+
+	if (img->clut) {
+		pfccr |= DMA2D_xPFCCR_CCM_ARGB8888 |
+			 ((img->clut_size - 1) & DMA2D_xPFCCR_CS_MASK) <<
+			 DMA2D_xPFCCR_CS_SHIFT;
+	}
+	return pfccr;
+}
+
+static void dma2d_set_output(struct dma2d_command *c,
+			     const struct dma2d_image *dst,
+			     uint16_t width, uint16_t height)
+{
+	c->opfccr = dst->format & DMA2D_OPFCCR_CM_MASK;
+	c->omar = (uint32_t)dst->addr;
+	c->oor = dst->pitch - width;
+	c->nlr = (uint32_t)width << DMA2D_NLR_PL_SHIFT | height;
+}
+
+/* Convert an ARGB8888 color to output format @p format for DMA2D_OCOLR */
+static uint32_t dma2d_color(uint8_t format, uint32_t argb)
+{
+	uint32_t a = argb >> 24, r = (argb >> 16) & 0xff;
+	uint32_t g = (argb >> 8) & 0xff, b = argb & 0xff;
+
+	switch (format) {
+	case DMA2D_OPFCCR_CM_RGB888:
+		return argb & 0xffffff;
+	case DMA2D_OPFCCR_CM_RGB565:
+		return (r >> 3) << 11 | (g >> 2) << 5 | b >> 3;
+	case DMA2D_OPFCCR_CM_ARGB1555:
+		return (a >> 7) << 15 | (r >> 3) << 10 | (g >> 3) << 5 | b >> 3;
+	case DMA2D_OPFCCR_CM_ARGB4444:
+		return (a >> 4) << 12 | (r >> 4) << 8 | (g >> 4) << 4 | b >> 4;
+	default:
+		return argb;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Initialise the DMA2D Command Queue
+
+Fills, copies and blends are queued and run one after the other from
+dma2d_isr(), which the application calls from its DMA2D interrupt handler,
+with that interrupt enabled in the NVIC. Without interrupts, dma2d_wait()
+runs the queue as well. The DMA2D clock must be enabled.
+
+@param[in] queue Storage for @p size pending commands.
+@param[in] size Number of commands in @p queue.
+@param[in] done Called when the queue has run empty, may be NULL.
+@param[in] arg Argument for @p done.
+*/
+void dma2d_init(struct dma2d_command *queue, uint32_t size,
+		dma2d_done_callback done, void *arg)
+{
+	DMA2D_CR = 0;
+	DMA2D_IFCR = DMA2D_ISR_ERRORS | DMA2D_ISR_CTCIF | DMA2D_ISR_TWIF |
+		     DMA2D_ISR_TCIF;
+	dma2d_queue = queue;
+	dma2d_size = size;
+	dma2d_head = 0;
+	dma2d_count = 0;
+	dma2d_error_count = 0;
+	dma2d_running = false;
+	dma2d_done = done;
+	dma2d_done_arg = arg;
+	dma2d_invalidate_clut();
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Queue a Rectangle Fill
+
+Register to memory transfer of a constant color.
+
+@param[in] dst Destination; only addr, pitch and format are used.
+@param[in] width Pixels per line.
+@param[in] height Lines.
+@param[in] argb ARGB8888 color, converted to the destination format.
+@returns false if the queue is full.
+*/
+bool dma2d_fill(const struct dma2d_image *dst, uint16_t width,
+		uint16_t height, uint32_t argb)
+{
+	struct dma2d_command c = {
+		.cr = DMA2D_CR_MODE_R2M << DMA2D_CR_MODE_SHIFT,
+		.ocolr = dma2d_color(dst->format, argb),
+	};
+
+	dma2d_set_output(&c, dst, width, height);
+	return dma2d_submit(&c);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Queue a Rectangle Copy
+
+A plain memory to memory copy when the formats match and the source alpha is
+unchanged, otherwise with pixel format conversion, using the source CLUT for
+indexed formats.
+
+@param[in] src Source.
+@param[in] dst Destination; only addr, pitch and format are used.
+@param[in] width Pixels per line.
+@param[in] height Lines.
+@returns false if the queue is full.
+*/
+bool dma2d_copy(const struct dma2d_image *src, const struct dma2d_image *dst,
+		uint16_t width, uint16_t height)
+{
+	struct dma2d_command c = {
+		.fgpfccr = dma2d_pfccr(src),
+		.fgmar = (uint32_t)src->addr,
+		.fgor = src->pitch - width,
+		.fgclut = src->clut,
+	};
+	uint32_t mode = DMA2D_CR_MODE_M2MWPFC;
+
+	if (src->format == dst->format && !src->clut &&
+	    src->alpha_mode == DMA2D_xPFCCR_AM_NONE) {
+		mode = DMA2D_CR_MODE_M2M;
+	}
+	c.cr = mode << DMA2D_CR_MODE_SHIFT;
+	dma2d_set_output(&c, dst, width, height);
+	return dma2d_submit(&c);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Queue a Rectangle Blend
+
+Blends @p fg over @p bg into @p dst, which may be the same memory as @p bg.
+Both sources are converted as for dma2d_copy().
+
+@param[in] fg Foreground.
+@param[in] bg Background.
+@param[in] dst Destination; only addr, pitch and format are used.
+@param[in] width Pixels per line.
+@param[in] height Lines.
+@returns false if the queue is full.
+*/
+bool dma2d_blend(const struct dma2d_image *fg, const struct dma2d_image *bg,
+		 const struct dma2d_image *dst, uint16_t width, uint16_t height)
+{
+	struct dma2d_command c = {
+		.cr = DMA2D_CR_MODE_M2MWB << DMA2D_CR_MODE_SHIFT,
+		.fgpfccr = dma2d_pfccr(fg),
+		.fgmar = (uint32_t)fg->addr,
+		.fgor = fg->pitch - width,
+		.fgclut = fg->clut,
+		.bgpfccr = dma2d_pfccr(bg),
+		.bgmar = (uint32_t)bg->addr,
+		.bgor = bg->pitch - width,
+		.bgclut = bg->clut,
+	};
+
+	dma2d_set_output(&c, dst, width, height);
+	return dma2d_submit(&c);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DMA2D Busy
+
+@returns true while queued commands are pending or running.
+*/
+bool dma2d_busy(void)
+{
+	return dma2d_running;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Wait for the Command Queue to Run Empty
+
+Call before the CPU touches memory written by queued commands. Also runs the
+queue when the DMA2D interrupt is not used.
+*/
+void dma2d_wait(void)
+{
+	while (dma2d_running) {
+		uint32_t mask = cm_mask_interrupts(1);
+		dma2d_isr();
+		cm_mask_interrupts(mask);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Forget the Loaded CLUTs
+
+Call after changing the contents of a CLUT already used, so that it is loaded
+again.
+*/
+void dma2d_invalidate_clut(void)
+{
+	dma2d_fgclut = NULL;
+	dma2d_bgclut = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DMA2D Error Count
+
+@returns the number of commands ended by a transfer, CLUT access or
+configuration error since dma2d_init().
+*/
+uint32_t dma2d_errors(void)
+{
+	return dma2d_error_count;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief DMA2D Interrupt Handler
+
+Ends the running command on transfer complete or error and starts the next,
+and continues a command after its CLUT load.
+*/
+void dma2d_isr(void)
+{
+	uint32_t isr = DMA2D_ISR & (DMA2D_ISR_ERRORS | DMA2D_ISR_CTCIF |
+				    DMA2D_ISR_TCIF);
+
+	if (!isr || !dma2d_running) {
+		return;
+	}
+	DMA2D_IFCR = isr;
+
+	if (isr & DMA2D_ISR_ERRORS) {
+		dma2d_error_count++;
+		dma2d_invalidate_clut();
+	}
+	if (isr & (DMA2D_ISR_ERRORS | DMA2D_ISR_TCIF)) {
+		dma2d_head = (dma2d_head + 1) % dma2d_size;
+		dma2d_count--;
+	}
+	dma2d_run();
+}
+
 /**@}*/
@@ -20,6 +20,7 @@
 #include <libopencm3/stm32/fdcan.h>
 #include <libopencm3/stm32/rcc.h>
 #include <stddef.h>
+#include <string.h>
 
 
 /* --- FD-CAN internal functions -------------------------------------------- */
@@ -229,6 +230,124 @@ uint8_t fdcan_dlc_to_length(uint32_t dlc)
 	}
 }
 
+/** Copy frame payload into message RAM.
+ *
+ * Message RAM can only be accessed in 32bit quantities, while payload buffer
+ * may have any alignment and length. Words are assembled in registers and
+ * the last one is padded by zeroes.
+ *
+ * @param [out] dst payload area of message RAM element
+ * @param [in] src payload buffer
+ * @param [in] length payload length in bytes
+ */
+static void fdcan_payload_to_msgram(uint32_t *dst, const uint8_t *src, unsigned length)
+{
+	uint32_t word;
+	unsigned q;
+
+	for (q = 0; q + 4 <= length; q += 4) {
+		memcpy(&word, &src[q], 4);
+		dst[q / 4] = word;
+	}
+
+	if (q < length) {
+		word = 0;
+		memcpy(&word, &src[q], length - q);
+		dst[q / 4] = word;
+	}
+}
+
+/** Copy frame payload out of message RAM.
+ *
+ * Counterpart of @ref fdcan_payload_to_msgram. Exactly length bytes are
+ * written to the payload buffer, which may have any alignment.
+ *
+ * @param [out] dst payload buffer
+ * @param [in] src payload area of message RAM element
+ * @param [in] length payload length in bytes
+ */
+static void fdcan_payload_from_msgram(uint8_t *dst, const uint32_t *src, unsigned length)
+{
+	uint32_t word;
+	unsigned q;
+
+	for (q = 0; q + 4 <= length; q += 4) {
+		word = src[q / 4];
+		memcpy(&dst[q], &word, 4);
+	}
+
+	if (q < length) {
+		word = src[q / 4];
+		memcpy(&dst[q], &word, length - q);
+	}
+}
+
+/** Fill transmit buffer element.
+ *
+ * Each header word of the element is written by single store.
+ *
+ * @param [out] tx_buffer transmit buffer element in message RAM
+ * @param [in] id Message ID
+ * @param [in] ext Extended message ID
+ * @param [in] rtr Request transmit
+ * @param [in] flags Any of FDCAN_FIFO_FDF, FDCAN_FIFO_BRS, FDCAN_FIFO_EFC
+ *		and message marker.
+ * @param [in] dlc DLC value of payload length
+ * @param [in] data Message payload data, any alignment
+ */
+static void fdcan_write_txbuf(struct fdcan_tx_buffer_element *tx_buffer,
+		uint32_t id, bool ext, bool rtr, uint32_t flags, uint32_t dlc,
+		const uint8_t *data)
+{
+	uint32_t identifier_flags;
+
+	if (ext) {
+		identifier_flags = FDCAN_FIFO_XTD
+			| ((id & FDCAN_FIFO_EID_MASK) << FDCAN_FIFO_EID_SHIFT);
+	} else {
+		identifier_flags = (id & FDCAN_FIFO_SID_MASK) << FDCAN_FIFO_SID_SHIFT;
+	}
+
+	if (rtr) {
+		identifier_flags |= FDCAN_FIFO_RTR;
+	}
+
+	tx_buffer->identifier_flags = identifier_flags;
+	tx_buffer->evt_fmt_dlc_res = (dlc << FDCAN_FIFO_DLC_SHIFT) | flags;
+
+	fdcan_payload_to_msgram(tx_buffer->data, data, fdcan_dlc_to_length(dlc));
+}
+
+/** Read receive FIFO element into frame structure.
+ *
+ * @param [in] fifo receive FIFO element in message RAM
+ * @param [out] frame frame structure to fill
+ */
+static void fdcan_read_rxfifo(const struct fdcan_rx_fifo_element *fifo,
+		struct fdcan_frame *frame)
+{
+	uint32_t identifier_flags = fifo->identifier_flags;
+	uint32_t filt_fmt_dlc_ts = fifo->filt_fmt_dlc_ts;
+
+	frame->ext = (identifier_flags & FDCAN_FIFO_XTD) == FDCAN_FIFO_XTD;
+	if (frame->ext) {
+		frame->id = (identifier_flags >> FDCAN_FIFO_EID_SHIFT) & FDCAN_FIFO_EID_MASK;
+	} else {
+		frame->id = (identifier_flags >> FDCAN_FIFO_SID_SHIFT) & FDCAN_FIFO_SID_MASK;
+	}
+	frame->rtr = (identifier_flags & FDCAN_FIFO_RTR) == FDCAN_FIFO_RTR;
+	frame->fdf = (filt_fmt_dlc_ts & FDCAN_FIFO_FDF) == FDCAN_FIFO_FDF;
+	frame->brs = (filt_fmt_dlc_ts & FDCAN_FIFO_BRS) == FDCAN_FIFO_BRS;
+	frame->fmi = (filt_fmt_dlc_ts >> FDCAN_FIFO_FIDX_SHIFT) & FDCAN_FIFO_FIDX_MASK;
+	frame->timestamp = (filt_fmt_dlc_ts >> FDCAN_FIFO_RXTS_SHIFT) & FDCAN_FIFO_RXTS_MASK;
+	frame->length = fdcan_dlc_to_length((filt_fmt_dlc_ts >> FDCAN_FIFO_DLC_SHIFT)
+			& FDCAN_FIFO_DLC_MASK);
+	frame->marker = 0;
+	frame->event = false;
+
+	fdcan_payload_from_msgram(frame->data, fifo->data, frame->length);
+}
+
 /* --- FD-CAN functions ----------------------------------------------------- */
 
 /** @ingroup fdcan_file */
@@ -470,6 +589,211 @@ void fdcan_set_ext_filter(uint32_t canport, uint32_t nr,
 		| ((id2 & FDCAN_EFID2_MASK) << FDCAN_EFID2_SHIFT);
 }
 
+/** Copy filter rules to work, sorted by ID type and first ID, and merge
+ * overlapping and adjacent ones.
+ *
+ * @returns amount of rules left in work.
+ */
+static uint32_t fdcan_filter_normalize(const struct fdcan_filter_rule *rules,
+		uint32_t nrules, struct fdcan_filter_rule *work)
+{
+	struct fdcan_filter_rule tmp;
+	uint32_t i, j, n;
+
+	for (i = 0; i < nrules; ++i) {
+		uint32_t max = rules[i].ext ? FDCAN_EFID1_MASK : FDCAN_SFID1_MASK;
+
+		tmp = rules[i];
+		tmp.id &= max;
+		if (tmp.id_last > max) {
+			tmp.id_last = max;
+		}
+		if (tmp.id_last < tmp.id) {
+			tmp.id_last = tmp.id;
+		}
+
+		for (j = i; j > 0; --j) {
+			if (work[j - 1].ext < tmp.ext
+				|| (work[j - 1].ext == tmp.ext && work[j - 1].id <= tmp.id)) {
+				break;
+			}
+			work[j] = work[j - 1];
+		}
+		work[j] = tmp;
+	}
+
+	n = 0;
+	for (i = 0; i < nrules; ++i) {
+		if (n > 0 && work[n - 1].ext == work[i].ext
+				&& work[i].id <= work[n - 1].id_last + 1) {
+			if (work[i].id_last > work[n - 1].id_last) {
+				work[n - 1].id_last = work[i].id_last;
+			}
+		} else {
+			work[n++] = work[i];
+		}
+	}
+
+	return n;
+}
+
+/** Amount of filter elements needed for sorted rules.
+ *
+ * Ranges take one element each, single IDs are paired in dual ID elements.
+ */
+static uint32_t fdcan_filter_elements(const struct fdcan_filter_rule *rules, uint32_t n)
+{
+	uint32_t i, ranges = 0, singles = 0;
+
+	for (i = 0; i < n; ++i) {
+		if (rules[i].id == rules[i].id_last) {
+			singles++;
+		} else {
+			ranges++;
+		}
+	}
+
+	return ranges + (singles + 1) / 2;
+}
+
+/** Merge neighbouring rules until they fit into avail filter elements.
+ *
+ * Rules separated by the smallest gap are merged first, so the amount of
+ * falsely accepted IDs grows as little as possible with each merge.
+ *
+ * @returns amount of rules left.
+ */
+static uint32_t fdcan_filter_fit(struct fdcan_filter_rule *rules, uint32_t n,
+		uint32_t avail, uint64_t *false_accepts)
+{
+	uint32_t i, best, gap;
+
+	while (n > 1 && fdcan_filter_elements(rules, n) > avail) {
+		best = 0;
+		for (i = 1; i < n - 1; ++i) {
+			gap = rules[i + 1].id - rules[i].id_last;
+			if (gap < rules[best + 1].id - rules[best].id_last) {
+				best = i;
+			}
+		}
+
+		*false_accepts += rules[best + 1].id - rules[best].id_last - 1;
+		rules[best].id_last = rules[best + 1].id_last;
+		for (i = best + 1; i < n - 1; ++i) {
+			rules[i] = rules[i + 1];
+		}
+		n--;
+	}
+
+	return n;
+}
+
+/** Compile and program filter rules accepting given ID ranges.
+ *
+ * Rules are sorted and merged, then packed into filter elements: single IDs
+ * pairwise into dual ID elements and ranges into range elements. Extended
+ * ranges are programmed to ignore XIDAM. If rules need more elements than
+ * are available, neighbouring rules closest to each other are merged and the
+ * amount of IDs accepted on top of the rules is reported.
+ *
+ * Filter elements not needed are disabled. Amount of elements has to be
+ * configured previously using @ref fdcan_init_filter.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block.
+ * @param [in] rules ID ranges to be accepted, left unchanged
+ * @param [in] nrules amount of rules
+ * @param [in] work scratch storage, where rules are sorted and merged
+ * @param [in] work_size amount of rules work can hold, at least nrules
+ * @param [in] std_filt amount of standard ID filter elements available
+ * @param [in] ext_filt amount of extended ID filter elements available
+ * @param [in] fifo FIFO matching frames are stored to. See @ref fdcan_fifo.
+ * @param [out] report filter elements used and false accepts, may be NULL
+ * @returns FDCAN_E_OK on success, FDCAN_E_OUTOFRANGE if rules exist for
+ * ID type which has no filter elements available, FDCAN_E_INVALID if work
+ * is too small.
+ */
+int fdcan_filter_compile(uint32_t canport, const struct fdcan_filter_rule *rules,
+		uint32_t nrules, struct fdcan_filter_rule *work, uint32_t work_size,
+		uint32_t std_filt, uint32_t ext_filt, uint8_t fifo,
+		struct fdcan_filter_report *report)
+{
+	uint32_t i, n, nstd, next, std_nr = 0, ext_nr = 0;
+	uint64_t false_accepts = 0;
+	int32_t single = -1;
+	uint8_t action = (fifo == FDCAN_FIFO1) ? FDCAN_SFEC_FIFO1 : FDCAN_SFEC_FIFO0;
+
+	if (work_size < nrules) {
+		return FDCAN_E_INVALID;
+	}
+
+	n = fdcan_filter_normalize(rules, nrules, work);
+	for (nstd = 0; nstd < n && !work[nstd].ext; ++nstd);
+
+	if ((nstd > 0 && std_filt == 0) || (n > nstd && ext_filt == 0)) {
+		return FDCAN_E_OUTOFRANGE;
+	}
+
+	next = fdcan_filter_fit(&work[nstd], n - nstd, ext_filt, &false_accepts);
+	n = fdcan_filter_fit(work, nstd, std_filt, &false_accepts);
+	for (i = 0; i < next; ++i) {
+		work[n + i] = work[nstd + i];
+	}
+	n += next;
+
+	for (i = 0; i < n; ++i) {
+		bool ext = work[i].ext;
+
+		if (work[i].id != work[i].id_last) {
+			if (ext) {
+				fdcan_set_ext_filter(canport, ext_nr++, FDCAN_EFT_RANGE_NOXIDAM,
+						work[i].id, work[i].id_last, action);
+			} else {
+				fdcan_set_std_filter(canport, std_nr++, FDCAN_SFT_RANGE,
+						work[i].id, work[i].id_last, action);
+			}
+		} else if (single < 0 || work[single].ext != ext) {
+			single = i;
+		} else {
+			if (ext) {
+				fdcan_set_ext_filter(canport, ext_nr++, FDCAN_EFT_DUAL,
+						work[single].id, work[i].id, action);
+			} else {
+				fdcan_set_std_filter(canport, std_nr++, FDCAN_SFT_DUAL,
+						work[single].id, work[i].id, action);
+			}
+			single = -1;
+		}
+
+		/* Unpaired single ID left at the end of its ID type */
+		if (single >= 0 && (i + 1 == n || work[i + 1].ext != ext)) {
+			if (ext) {
+				fdcan_set_ext_filter(canport, ext_nr++, FDCAN_EFT_DUAL,
+						work[single].id, work[single].id, action);
+			} else {
+				fdcan_set_std_filter(canport, std_nr++, FDCAN_SFT_DUAL,
+						work[single].id, work[single].id, action);
+			}
+			single = -1;
+		}
+	}
+
+	for (i = std_nr; i < std_filt; ++i) {
+		fdcan_set_std_filter(canport, i, FDCAN_SFT_DISABLE, 0, 0, FDCAN_SFEC_DISABLE);
+	}
+	for (i = ext_nr; i < ext_filt; ++i) {
+		fdcan_set_ext_filter(canport, i, FDCAN_EFT_RANGE, 0, 0, FDCAN_EFEC_DISABLE);
+	}
+
+	if (report) {
+		report->std_filters = std_nr;
+		report->ext_filters = ext_nr;
+		report->false_accepts = false_accepts > 0xFFFFFFFF ?
+			0xFFFFFFFF : false_accepts;
+	}
+
+	return FDCAN_E_OK;
+}
+
 /** Transmit Message using FDCAN
  *
  * @param [in] canport CAN block register base. See @ref fdcan_block.
@@ -479,7 +803,7 @@ void fdcan_set_ext_filter(uint32_t canport, uint32_t nr,
  * @param [in] fdcan_fmt Use FDCAN format
  * @param [in] btr_switch Switch bitrate for data portion of frame
  * @param [in] length Message payload length. Must be valid CAN or FDCAN frame length
- * @param [in] data Message payload data
+ * @param [in] data Message payload data, no alignment required
  * @returns int 0, 1 or 2 on success and depending on which outgoing mailbox got
  * selected. Otherwise returns error code. For error codes, see @ref fdcan_error.
  */
@@ -495,8 +819,6 @@ int fdcan_transmit(uint32_t canport, uint32_t id, bool ext, bool rtr,
 		return mailbox;
 	}
 
-	struct fdcan_tx_buffer_element *tx_buffer = fdcan_get_txbuf_addr(canport, mailbox);
-
 	/* Early check: if FDCAN message lentgh is > 8, it must be
 	 * a multiple of 4 *and* fdcan format must be enabled.
 	 */
@@ -506,18 +828,6 @@ int fdcan_transmit(uint32_t canport, uint32_t id, bool ext, bool rtr,
 		return FDCAN_E_INVALID;
 	}
 
-	if (ext) {
-		tx_buffer->identifier_flags = FDCAN_FIFO_XTD
-			| ((id & FDCAN_FIFO_EID_MASK) << FDCAN_FIFO_EID_SHIFT);
-	} else {
-		tx_buffer->identifier_flags =
-			(id & FDCAN_FIFO_SID_MASK) << FDCAN_FIFO_SID_SHIFT;
-	}
-
-	if (rtr) {
-		tx_buffer->identifier_flags |= FDCAN_FIFO_RTR;
-	}
-
 	if (fdcan_fmt) {
 		flags |= FDCAN_FIFO_FDF;
 	}
@@ -526,14 +836,10 @@ int fdcan_transmit(uint32_t canport, uint32_t id, bool ext, bool rtr,
 		flags |= FDCAN_FIFO_BRS;
 	}
 
-	tx_buffer->evt_fmt_dlc_res =
-		(dlc << FDCAN_FIFO_DLC_SHIFT) | flags;
-
-	for (int q = 0; q < length; q += 4) {
-		tx_buffer->data[q / 4] = *((uint32_t *) &data[q]);
-	}
+	fdcan_write_txbuf(fdcan_get_txbuf_addr(canport, mailbox), id, ext, rtr,
+			flags, dlc, data);
 
-	FDCAN_TXBAR(canport) |= 1 << mailbox;
+	FDCAN_TXBAR(canport) = 1 << mailbox;
 
 	return mailbox;
 }
@@ -604,9 +910,7 @@ int fdcan_receive(uint32_t canport, uint8_t fifo_id, bool release, uint32_t *id,
 		*rtr = ((fifo->identifier_flags & FDCAN_FIFO_RTR) == FDCAN_FIFO_RTR);
 	}
 
-	for (unsigned int q = 0; q < len; q += 4) {
-		*((uint32_t *) &data[q]) = fifo->data[q / 4];
-	}
+	fdcan_payload_from_msgram(data, fifo->data, len);
 
 	if (release) {
 		FDCAN_RXFIA(canport, fifo_id) = get_index << FDCAN_RXFIFO_AI_SHIFT;
@@ -615,6 +919,186 @@ int fdcan_receive(uint32_t canport, uint8_t fifo_id, bool release, uint32_t *id,
 	return FDCAN_E_OK;
 }
 
+/** Transmit several frames using transmit FIFO/queue
+ *
+ * Fills as many free transmit FIFO/queue elements as possible and requests
+ * transmission of all of them by single write to TXBAR. In FIFO mode frames
+ * are stored starting at put index, so they are sent in order. In queue mode
+ * any element not pending transmission is used. Frames with event flag set
+ * store a transmit event carrying their marker, see @ref fdcan_read_tx_events.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block.
+ * @param [in] frames Frames to be sent
+ * @param [in] count Amount of frames
+ * @returns Amount of frames queued, which may be less than count. Otherwise
+ * returns error code: FDCAN_E_BUSY if no element is free, FDCAN_E_INVALID if
+ * first frame has invalid length. See @ref fdcan_error.
+ */
+int fdcan_transmit_batch(uint32_t canport, const struct fdcan_frame *frames,
+		unsigned count)
+{
+	unsigned first = fdcan_get_txfifo_first(canport);
+	unsigned depth = fdcan_get_txfifo_depth(canport);
+	uint32_t txfqs = FDCAN_TXFQS(canport);
+	uint32_t pending = FDCAN_TXBRP(canport);
+	bool queue_mode = (FDCAN_TXBC(canport) & FDCAN_TXBC_TFQM) == FDCAN_TXBC_TFQM;
+	unsigned put, free_level;
+	uint32_t dlc, flags, add = 0;
+	unsigned n;
+
+	if (queue_mode) {
+		/* Any element not pending in TXBRP is free, scan them all */
+		put = first;
+		free_level = depth;
+	} else {
+		/* In order from the put index, TFFL elements are free */
+		put = (txfqs >> FDCAN_TXFQS_TFQPI_SHIFT) & FDCAN_TXFQS_TFQPI_MASK;
+		free_level = (txfqs >> FDCAN_TXFQS_TFFL_SHIFT) & FDCAN_TXFQS_TFFL_MASK;
+	}
+
+	for (n = 0; n < count; ++n) {
+		const struct fdcan_frame *frame = &frames[n];
+
+		if (queue_mode) {
+			while (put < first + depth && (pending & (1u << put))) {
+				put++;
+			}
+			if (put >= first + depth) {
+				break;
+			}
+		} else if (free_level-- == 0 || (pending & (1u << put))) {
+			break;
+		}
+
+		dlc = fdcan_length_to_dlc(frame->length);
+		if (dlc == 0xFF) {
+			if (n == 0) {
+				return FDCAN_E_INVALID;
+			}
+			break;
+		}
+
+		flags = ((uint32_t) frame->marker << FDCAN_FIFO_MM_SHIFT);
+		if (frame->fdf) {
+			flags |= FDCAN_FIFO_FDF;
+		}
+		if (frame->brs) {
+			flags |= FDCAN_FIFO_BRS;
+		}
+		if (frame->event) {
+			flags |= FDCAN_FIFO_EFC;
+		}
+
+		fdcan_write_txbuf(fdcan_get_txbuf_addr(canport, put), frame->id,
+				frame->ext, frame->rtr, flags, dlc, frame->data);
+		add |= 1u << put;
+
+		if (queue_mode) {
+			pending |= 1u << put;
+		} else if (++put == first + depth) {
+			put = first;
+		}
+	}
+
+	if (add != 0) {
+		FDCAN_TXBAR(canport) = add;
+	} else if (count > 0) {
+		return FDCAN_E_BUSY;
+	}
+
+	return n;
+}
+
+/** Receive several frames from FDCAN FIFO
+ *
+ * Reads up to max frames waiting in receive FIFO and releases all of them
+ * by single write to acknowledge register.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block.
+ * @param [in] fifo_id FIFO id.
+ * @param [out] frames Buffer for received frames
+ * @param [in] max Amount of frames buffer can hold
+ * @returns Amount of frames received, 0 if FIFO was empty.
+ */
+int fdcan_receive_batch(uint32_t canport, uint8_t fifo_id,
+		struct fdcan_frame *frames, unsigned max)
+{
+	unsigned depth = fdcan_get_rxfifo_depth(canport, fifo_id);
+	unsigned pending_frames, get_index, last = 0, n;
+
+	fdcan_get_fill_rxfifo(canport, fifo_id, &get_index, &pending_frames);
+
+	for (n = 0; n < pending_frames && n < max; ++n) {
+		fdcan_read_rxfifo(fdcan_get_rxfifo_addr(canport, fifo_id, get_index),
+				&frames[n]);
+		last = get_index;
+		if (++get_index >= depth) {
+			get_index = 0;
+		}
+	}
+
+	if (n > 0) {
+		FDCAN_RXFIA(canport, fifo_id) = last << FDCAN_RXFIFO_AI_SHIFT;
+	}
+
+	return n;
+}
+
+/** Read events from transmit event FIFO
+ *
+ * Transmit events are stored for frames sent with event flag set, see
+ * @ref fdcan_transmit_batch. They carry transmit timestamp and message marker,
+ * which allows to match them with frames sent. All events read are released
+ * by single write to acknowledge register.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block.
+ * @param [out] events Buffer for events
+ * @param [in] max Amount of events buffer can hold
+ * @returns Amount of events read, 0 if transmit event FIFO was empty.
+ */
+int fdcan_read_tx_events(uint32_t canport, struct fdcan_tx_event *events,
+		unsigned max)
+{
+	const struct fdcan_tx_event_element *txevt = fdcan_get_txevt_addr(canport);
+	unsigned depth = fdcan_get_txevt_depth(canport);
+	uint32_t txefs = FDCAN_TXEFS(canport);
+	unsigned fill = (txefs >> FDCAN_TXEFS_EFFL_SHIFT) & FDCAN_TXEFS_EFFL_MASK;
+	unsigned get_index = (txefs >> FDCAN_TXEFS_EFGI_SHIFT) & FDCAN_TXEFS_EFGI_MASK;
+	unsigned last = 0, n;
+
+	for (n = 0; n < fill && n < max; ++n) {
+		uint32_t identifier_flags = txevt[get_index].identifier_flags;
+		uint32_t evt_fmt_dlc_ts = txevt[get_index].evt_fmt_dlc_ts;
+		struct fdcan_tx_event *event = &events[n];
+
+		event->ext = (identifier_flags & FDCAN_FIFO_XTD) == FDCAN_FIFO_XTD;
+		if (event->ext) {
+			event->id = (identifier_flags >> FDCAN_FIFO_EID_SHIFT) & FDCAN_FIFO_EID_MASK;
+		} else {
+			event->id = (identifier_flags >> FDCAN_FIFO_SID_SHIFT) & FDCAN_FIFO_SID_MASK;
+		}
+		event->marker = (evt_fmt_dlc_ts >> FDCAN_FIFO_MM_SHIFT) & FDCAN_FIFO_MM_MASK;
+		event->type = (evt_fmt_dlc_ts >> FDCAN_FIFO_ET_SHIFT) & FDCAN_FIFO_ET_MASK;
+		event->fdf = (evt_fmt_dlc_ts & FDCAN_FIFO_FDF) == FDCAN_FIFO_FDF;
+		event->brs = (evt_fmt_dlc_ts & FDCAN_FIFO_BRS) == FDCAN_FIFO_BRS;
+		event->length = fdcan_dlc_to_length((evt_fmt_dlc_ts >> FDCAN_FIFO_DLC_SHIFT)
+				& FDCAN_FIFO_DLC_MASK);
+		event->timestamp = (evt_fmt_dlc_ts >> FDCAN_FIFO_TXTS_SHIFT)
+			& FDCAN_FIFO_TXTS_MASK;
+
+		last = get_index;
+		if (++get_index >= depth) {
+			get_index = 0;
+		}
+	}
+
+	if (n > 0) {
+		FDCAN_TXEFA(canport) = last << FDCAN_TXEFA_EFAI_SHIFT;
+	}
+
+	return n;
+}
+
 /** Release receive oldest FIFO entry.
  *
  * This function will mask oldest entry in FIFO as released making
@@ -694,6 +1178,22 @@ bool fdcan_available_rx(uint32_t canport, uint8_t fifo)
 	return (pending_frames != 0);
 }
 
+/** Read the transmit and receive error counters.
+ *
+ * Both counters are taken from a single read of ECR.
+ *
+ * @param [in] canport FDCAN port. See @ref fdcan_block.
+ * @param [out] tec transmit error counter
+ * @param [out] rec receive error counter
+ */
+void fdcan_get_error_counters(uint32_t canport, uint8_t *tec, uint8_t *rec)
+{
+	uint32_t ecr = FDCAN_ECR(canport);
+
+	*tec = (ecr >> FDCAN_ECR_TEC_SHIFT) & FDCAN_ECR_TEC_MASK;
+	*rec = (ecr >> FDCAN_ECR_REC_SHIFT) & FDCAN_ECR_REC_MASK;
+}
+
 /**@}*/
 
 
@@ -108,4 +108,183 @@ sdram_command(enum fmc_sdram_bank bank,
 	FMC_SDCMR = tmp_reg;
 }
 
+/* Cycles of a clock at freq Hz covering ns nanoseconds, at least one */
+static uint32_t
+sdram_cycles(uint32_t ns, uint32_t freq) {
+	uint32_t cycles = ((uint64_t)ns * freq + 999999999) / 1000000000;
+
+	return cycles ? cycles : 1;
+}
+
+/*
+ * Compute the SDCR, SDTR and refresh timer values and the mode register
+ * for an SDRAM chip at the fastest SDRAM clock, HCLK / 2 or HCLK / 3, the
+ * chip supports. Reads are done in bursts with one HCLK of read pipe delay,
+ * writes singly. Returns false if the chip cannot be run from this HCLK,
+ * or a parameter is out of range of the FMC.
+ */
+bool
+sdram_calc(const struct sdram_chip *chip, uint32_t hclk,
+	   struct sdram_config *cfg) {
+	struct sdram_timing t;
+	uint32_t div, count;
+
+	if (chip->rows < 11 || chip->rows > 13 ||
+	    chip->columns < 8 || chip->columns > 11 ||
+	    (chip->banks != 2 && chip->banks != 4) ||
+	    (chip->width != 8 && chip->width != 16 && chip->width != 32) ||
+	    chip->cas < 1 || chip->cas > 3 || chip->refresh_rows == 0) {
+		return false;
+	}
+
+	for (div = 2; div <= 3 && hclk / div > chip->max_freq; div++);
+	if (div > 3) {
+		return false;
+	}
+	cfg->sdclk = hclk / div;
+
+	t.trcd = sdram_cycles(chip->trcd, cfg->sdclk);
+	t.trp = sdram_cycles(chip->trp, cfg->sdclk);
+	t.twr = sdram_cycles(chip->twr, cfg->sdclk);
+	t.trc = sdram_cycles(chip->trc, cfg->sdclk);
+	t.tras = sdram_cycles(chip->tras, cfg->sdclk);
+	t.txsr = sdram_cycles(chip->txsr, cfg->sdclk);
+	t.tmrd = chip->tmrd;
+	/* The FMC also needs TWR >= TRAS - TRCD and TWR >= TRC - TRCD - TRP */
+	if (t.twr < t.tras - t.trcd) {
+		t.twr = t.tras - t.trcd;
+	}
+	if (t.twr < t.trc - t.trcd - t.trp) {
+		t.twr = t.trc - t.trcd - t.trp;
+	}
+	if (t.tmrd < 1) {
+		t.tmrd = 1;
+	}
+	if (t.trcd > 16 || t.trp > 16 || t.twr > 16 || t.trc > 16 ||
+	    t.tras > 16 || t.txsr > 16 || t.tmrd > 16) {
+		return false;
+	}
+	cfg->sdtr = sdram_timing(&t);
+
+	/* Refresh rate, less a 20 cycle margin for the ongoing access */
+	count = (uint64_t)cfg->sdclk * chip->refresh_ms / 1000 /
+		chip->refresh_rows - 20;
+	if (count < 41 || count > 0x1fff) {
+		return false;
+	}
+	cfg->sdrtr = count << FMC_SDRTR_COUNT_SHIFT;
+
+	cfg->sdcr = (chip->columns - 8) << FMC_SDCR_NC_SHIFT |
+		    (chip->rows - 11) << FMC_SDCR_NR_SHIFT |
+		    (chip->width == 8 ? FMC_SDCR_MWID_8b :
+		     chip->width == 16 ? FMC_SDCR_MWID_16b :
+					 FMC_SDCR_MWID_32b) |
+		    (chip->banks == 4 ? FMC_SDCR_NB4 : FMC_SDCR_NB2) |
+		    chip->cas << FMC_SDCR_CAS_SHIFT |
+		    (div == 2 ? FMC_SDCR_SDCLK_2HCLK : FMC_SDCR_SDCLK_3HCLK) |
+		    FMC_SDCR_RBURST | FMC_SDCR_RPIPE_1CLK;
+
+	cfg->mode = SDRAM_MODE_BURST_LENGTH_1 |
+		    SDRAM_MODE_BURST_TYPE_SEQUENTIAL |
+		    chip->cas << 4 |
+		    SDRAM_MODE_OPERATING_MODE_STANDARD |
+		    SDRAM_MODE_WRITEBURST_MODE_SINGLE;
+	return true;
+}
+
+/*
+ * Program the controller for one or both SDRAM banks and run the JEDEC
+ * power up sequence: clock enable, 100us wait, precharge all, eight auto
+ * refreshes and mode register load, then start the refresh timer. The FMC
+ * clock and pins must already be set up.
+ */
+void
+sdram_init(enum fmc_sdram_bank bank, const struct sdram_config *cfg) {
+	volatile uint32_t i;
+
+	if (bank == SDRAM_BANK1 || bank == SDRAM_BOTH_BANKS) {
+		FMC_SDCR1 = cfg->sdcr;
+		FMC_SDTR1 = cfg->sdtr;
+	}
+	if (bank == SDRAM_BANK2 || bank == SDRAM_BOTH_BANKS) {
+		/* Clock, burst and pipe, TRP and TRC only count in bank 1 */
+		FMC_SDCR1 = (FMC_SDCR1 & ~FMC_SDCR_DNC_MASK) |
+			    (cfg->sdcr & FMC_SDCR_DNC_MASK);
+		FMC_SDTR1 = (FMC_SDTR1 & ~FMC_SDTR_DNC_MASK) |
+			    (cfg->sdtr & FMC_SDTR_DNC_MASK);
+		FMC_SDCR2 = cfg->sdcr;
+		FMC_SDTR2 = cfg->sdtr;
+	}
+
+	sdram_command(bank, SDRAM_CLK_CONF, 0, 0);
+	/* At least 100us: every iteration takes more than one SDRAM clock */
+	for (i = 0; i < cfg->sdclk / 10000; i++);
+	sdram_command(bank, SDRAM_PALL, 0, 0);
+	sdram_command(bank, SDRAM_AUTO_REFRESH, 7, 0);
+	sdram_command(bank, SDRAM_LOAD_MODE, 0, cfg->mode);
+
+	while (FMC_SDSR & FMC_SDSR_BUSY);
+	FMC_SDRTR = cfg->sdrtr;
+}
+
+/*
+ * March C- test of size bytes of SDRAM from base, with 0x55555555 and its
+ * complement so that neighbouring data lines differ. The initial background
+ * is written by fill, typically a memory to memory DMA, or by the CPU if
+ * fill is NULL; the read and write elements run on the CPU. The SDRAM is
+ * left filled with 0x55555555; with a data cache, base must not be
+ * cacheable. Returns the address of the first failing word, or 0 if none.
+ */
+uint32_t
+sdram_march_test(uint32_t base, uint32_t size, sdram_fill_callback fill) {
+	static const uint32_t p0 = 0x55555555, p1 = ~0x55555555U;
+	volatile uint32_t *mem = (volatile uint32_t *)base;
+	uint32_t words = size / 4;
+	uint32_t i;
+
+	/* up: w0 */
+	if (fill) {
+		fill(base, words, p0);
+	} else {
+		for (i = 0; i < words; i++) {
+			mem[i] = p0;
+		}
+	}
+	/* up: r0, w1 */
+	for (i = 0; i < words; i++) {
+		if (mem[i] != p0) {
+			return (uint32_t)&mem[i];
+		}
+		mem[i] = p1;
+	}
+	/* up: r1, w0 */
+	for (i = 0; i < words; i++) {
+		if (mem[i] != p1) {
+			return (uint32_t)&mem[i];
+		}
+		mem[i] = p0;
+	}
+	/* down: r0, w1 */
+	for (i = words; i-- > 0;) {
+		if (mem[i] != p0) {
+			return (uint32_t)&mem[i];
+		}
+		mem[i] = p1;
+	}
+	/* down: r1, w0 */
+	for (i = words; i-- > 0;) {
+		if (mem[i] != p1) {
+			return (uint32_t)&mem[i];
+		}
+		mem[i] = p0;
+	}
+	/* r0 */
+	for (i = 0; i < words; i++) {
+		if (mem[i] != p0) {
+			return (uint32_t)&mem[i];
+		}
+	}
+	return 0;
+}
+
 /**@}*/
@@ -32,8 +32,12 @@
 
 /**@{*/
 
+#include <string.h>
 #include <libopencm3/stm32/hash.h>
 
+/* Context whose state is in the peripheral, NULL if none */
+static struct hash_ctx *hash_active;
+
 /*---------------------------------------------------------------------------*/
 /** @brief HASH Set Mode
 
@@ -160,5 +164,322 @@ void hash_get_result(uint32_t *data)
 		data[4] = HASH_HR[4];
 	}
 }
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Write Words
+
+Writes whole words to HASH_DIN. The source needs no particular alignment.
+
+@param[in] data Words to write.
+@param[in] n Number of words.
+*/
+
+static void hash_write_words(const uint8_t *data, size_t n)
+{
+	uint32_t word;
+
+	if (((uintptr_t)data & 3) == 0) {
+		const uint32_t *w = (const uint32_t *)data;
+
+		while (n--) {
+			HASH_DIN = *w++;
+		}
+		return;
+	}
+
+	while (n--) {
+		memcpy(&word, data, 4);
+		HASH_DIN = word;
+		data += 4;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Write Last Bytes
+
+Writes the end of a message or key and starts the digest calculation.
+
+@param[in] data Bytes to write.
+@param[in] len Number of bytes.
+*/
+
+static void hash_write_last(const uint8_t *data, size_t len)
+{
+	uint32_t word = 0;
+
+	hash_write_words(data, len / 4);
+	if (len & 3) {
+		memcpy(&word, data + (len & ~3), len & 3);
+		HASH_DIN = word;
+	}
+	HASH_STR = (len & 3) * 8;
+	HASH_STR = ((len & 3) * 8) | HASH_STR_DCAL;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Save Context
+
+Saves the state of the active context, which has only ever written whole
+blocks, once the input FIFO has been taken in (DINIS) and the peripheral is
+idle, as the reference manual's context swap procedure requires.
+
+@param[in] ctx Context in the peripheral.
+*/
+
+static void hash_ctx_save(struct hash_ctx *ctx)
+{
+	int i;
+
+	while ((HASH_SR & (HASH_SR_DINIS | HASH_SR_BUSY)) != HASH_SR_DINIS);
+
+	ctx->imr = HASH_IMR;
+	ctx->str = HASH_STR;
+	ctx->cr = HASH_CR;
+	for (i = 0; i < HASH_CSR_COUNT; i++) {
+		ctx->csr[i] = HASH_CSR[i];
+	}
+	ctx->saved = true;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Activate Context
+
+Loads a context into the peripheral, saving the one in use first. A fresh
+context is initialised, and for HMAC the inner key is hashed.
+
+@param[in] ctx Context to activate.
+*/
+
+static void hash_activate(struct hash_ctx *ctx)
+{
+	int i;
+
+	if (hash_active == ctx) {
+		return;
+	}
+	if (hash_active) {
+		hash_ctx_save(hash_active);
+	}
+	hash_active = ctx;
+
+	if (ctx->saved) {
+		HASH_IMR = ctx->imr;
+		HASH_STR = ctx->str;
+		HASH_CR = ctx->cr | HASH_CR_INIT;
+		for (i = 0; i < HASH_CSR_COUNT; i++) {
+			HASH_CSR[i] = ctx->csr[i];
+		}
+		ctx->saved = false;
+		return;
+	}
+
+	HASH_CR = ctx->cr | HASH_CR_INIT;
+	if (ctx->key) {
+		hash_write_last(ctx->key, ctx->keylen);
+		while (HASH_SR & HASH_SR_BUSY);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Read Digest
+
+Waits for the digest calculation to finish and reads the result.
+
+@param[out] digest 4 words for MD5, 5 for SHA-1.
+*/
+
+static void hash_read_digest(uint32_t *digest)
+{
+	while (!(HASH_SR & HASH_SR_DCIS));
+	hash_get_result(digest);
+	hash_active = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Context Init
+
+Prepares a context for a new message digest. The peripheral is not touched
+until data is added, so contexts can be set up freely while another one is
+in progress.
+
+@param[out] ctx Context to initialise.
+@param[in] algorithm unsigned int8. Hash algorithm: @ref hash_algorithm
+*/
+
+void hash_ctx_init(struct hash_ctx *ctx, uint8_t algorithm)
+{
+	hash_ctx_abort(ctx);
+	ctx->cr = algorithm | HASH_MODE_HASH | HASH_DATA_8BIT;
+	ctx->nbytes = 0;
+	ctx->saved = false;
+	ctx->key = NULL;
+	ctx->keylen = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH HMAC Context Init
+
+As hash_ctx_init(), for a keyed HMAC. The key is hashed again by
+hash_final(), so it must stay valid until then.
+
+@param[out] ctx Context to initialise.
+@param[in] algorithm unsigned int8. Hash algorithm: @ref hash_algorithm
+@param[in] key HMAC key.
+@param[in] keylen Key length in bytes.
+*/
+
+void hash_hmac_init(struct hash_ctx *ctx, uint8_t algorithm,
+		    const uint8_t *key, uint32_t keylen)
+{
+	hash_ctx_init(ctx, algorithm);
+	ctx->cr |= HASH_MODE_HMAC;
+	if (keylen > HASH_BLOCK_WORDS * 4) {
+		ctx->cr |= HASH_KEY_LONG;
+	}
+	ctx->key = key;
+	ctx->keylen = keylen;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Update
+
+Adds bytes to a message digest. Data is written to the peripheral a whole
+block at a time, so the context can be swapped out between any two calls;
+the rest is kept in the context until more data arrives. @p data needs no
+particular alignment.
+
+@param[in] ctx Context of the digest.
+@param[in] data Bytes to add.
+@param[in] len Number of bytes.
+*/
+
+void hash_update(struct hash_ctx *ctx, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	uint8_t *block = (uint8_t *)ctx->block;
+	size_t n;
+
+	if (ctx->nbytes + len < HASH_BLOCK_WORDS * 4) {
+		memcpy(block + ctx->nbytes, p, len);
+		ctx->nbytes += len;
+		return;
+	}
+
+	hash_activate(ctx);
+
+	if (ctx->nbytes) {
+		n = HASH_BLOCK_WORDS * 4 - ctx->nbytes;
+		memcpy(block + ctx->nbytes, p, n);
+		hash_write_words(block, HASH_BLOCK_WORDS);
+		p += n;
+		len -= n;
+	}
+
+	n = len & ~(size_t)(HASH_BLOCK_WORDS * 4 - 1);
+	hash_write_words(p, n / 4);
+
+	ctx->nbytes = len - n;
+	memcpy(block, p + n, ctx->nbytes);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Final
+
+Finishes a message digest. For HMAC, the outer key pass is done as well.
+
+@param[in] ctx Context of the digest.
+@param[out] digest 4 words for MD5, 5 for SHA-1.
+*/
+
+void hash_final(struct hash_ctx *ctx, uint32_t *digest)
+{
+	hash_activate(ctx);
+	hash_write_last((const uint8_t *)ctx->block, ctx->nbytes);
+	ctx->nbytes = 0;
+
+	if (ctx->key) {
+		while (HASH_SR & HASH_SR_BUSY);
+		hash_write_last(ctx->key, ctx->keylen);
+	}
+
+	hash_read_digest(digest);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Final using DMA
+
+Finishes a plain message digest with the last, typically large, piece of
+the message fed by DMA. Bytes still held by the context and the few needed
+to reach a word boundary are written by the CPU, the rest is handed to
+@p start for a DMA transfer into HASH_DIN. The peripheral starts the digest
+calculation by itself at the end of the transfer; collect the result with
+hash_wait_result(). The transfer reads up to three bytes past the end of
+@p data, within the same word.
+
+Nothing is done for HMAC contexts, or if @p data is not word aligned once
+the held bytes are accounted for; use hash_update() and hash_final() then.
+
+@param[in] ctx Context of the digest.
+@param[in] data Last bytes of the message.
+@param[in] len Number of bytes.
+@param[in] start Starts the DMA transfer.
+@returns true if the DMA transfer was started.
+*/
+
+bool hash_final_dma(struct hash_ctx *ctx, const void *data, size_t len,
+		    hash_dma_callback start)
+{
+	const uint8_t *p = data;
+	size_t head = (4 - (ctx->nbytes & 3)) & 3;
+
+	if (ctx->key || len < head + 4 || ((uintptr_t)(p + head) & 3)) {
+		return false;
+	}
+
+	hash_activate(ctx);
+	memcpy((uint8_t *)ctx->block + ctx->nbytes, p, head);
+	hash_write_words((const uint8_t *)ctx->block,
+			 (ctx->nbytes + head) / 4);
+	ctx->nbytes = 0;
+	p += head;
+	len -= head;
+
+	HASH_STR = (len & 3) * 8;
+	HASH_CR |= HASH_CR_DMAE;
+	start((const uint32_t *)p, (len + 3) / 4);
+	return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Wait for Result
+
+Waits for the digest started by hash_final_dma() and reads it.
+
+@param[in] ctx Context of the digest.
+@param[out] digest 4 words for MD5, 5 for SHA-1.
+*/
+
+void hash_wait_result(struct hash_ctx *ctx, uint32_t *digest)
+{
+	(void)ctx;
+	hash_read_digest(digest);
+	HASH_CR &= ~HASH_CR_DMAE;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief HASH Context Abort
+
+Forgets a context, so it can be discarded without being finished.
+
+@param[in] ctx Context to abort.
+*/
+
+void hash_ctx_abort(struct hash_ctx *ctx)
+{
+	if (hash_active == ctx) {
+		hash_active = NULL;
+	}
+	ctx->saved = false;
+}
 /**@}*/
 
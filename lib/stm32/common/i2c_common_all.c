@@ -0,0 +1,77 @@
+/** @addtogroup i2c_file I2C peripheral API
+ * @ingroup peripheral_apis
+ */
+
+/*
+ * This file is part of the libopencm3 project.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/cm3/cortex.h>
+#include <libopencm3/stm32/i2c.h>
+
+/**@{*/
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Queue a transfer
+ *
+ * Returns immediately. The transfer starts as soon as the ones queued before
+ * it have finished, with the write (if any) followed by the read (if any)
+ * behind a repeated start, exactly as i2c_transfer7() would do. On I2C v2
+ * parts transfers of more than 255 bytes are split with NBYTES reloads.
+ *
+ * On completion xfer->status holds the result and xfer->callback, if set, is
+ * called from interrupt context.
+ *
+ * A transfer held back because the STOP ending the previous one was not out
+ * yet (I2C v1 only) is retried here as well as from i2c_xfer_tick().
+ *
+ * @param[in] bus transfer queue
+ * @param[in] xfer transfer, must stay valid until it completes
+ */
+void i2c_xfer_submit(struct i2c_xfer_bus *bus, struct i2c_xfer *xfer)
+{
+	uint32_t mask;
+
+	xfer->next = NULL;
+	xfer->status = I2C_XFER_PENDING;
+
+	mask = cm_mask_interrupts(1);
+	if (bus->tail) {
+		bus->tail->next = xfer;
+		bus->tail = xfer;
+		if (bus->stop_wait) {
+			i2c_xfer_start(bus);
+		}
+	} else {
+		bus->head = xfer;
+		bus->tail = xfer;
+		i2c_xfer_start(bus);
+	}
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Check if a transfer queue is empty
+ *
+ * @param[in] bus transfer queue
+ * @returns true if no transfer is queued or running
+ */
+bool i2c_xfer_idle(struct i2c_xfer_bus *bus)
+{
+	return bus->head == NULL;
+}
+
+/**@}*/
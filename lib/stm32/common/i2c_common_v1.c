@@ -36,6 +36,8 @@ register access, Error conditions
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <libopencm3/cm3/cortex.h>
+#include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/i2c.h>
 #include <libopencm3/stm32/rcc.h>
 
@@ -536,5 +538,380 @@ void i2c_set_speed(uint32_t i2c, enum i2c_speeds speed, uint32_t clock_megahz)
 	}
 }
 
+/*---------------------------------------------------------------------------*/
+/* Interrupt driven transfer queue.
+ *
+ * Same API as on the v2 peripheral. The EV5/EV6/EV7 sequencing, including
+ * the special cases for 1, 2 and 3 remaining bytes from the reference manual,
+ * runs from i2c_xfer_isr(), which the application calls from both the event
+ * and the error interrupt handler of the peripheral.
+ */
+
+#define I2C_XFER_IRQS	(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN)
+
+/* CR1 reads to wait for a STOP, some bit times even at 400 kHz */
+#define I2C_XFER_STOP_POLLS	1000
+
+/* Reset the peripheral without losing its configuration */
+static void i2c_xfer_reset(uint32_t i2c)
+{
+	uint32_t cr1 = I2C_CR1(i2c) & ~(I2C_CR1_START | I2C_CR1_STOP |
+					I2C_CR1_POS | I2C_CR1_PEC);
+	uint32_t cr2 = I2C_CR2(i2c);
+	uint32_t oar1 = I2C_OAR1(i2c);
+	uint32_t oar2 = I2C_OAR2(i2c);
+	uint32_t ccr = I2C_CCR(i2c);
+	uint32_t trise = I2C_TRISE(i2c);
+
+	I2C_CR1(i2c) |= I2C_CR1_SWRST;
+	I2C_CR1(i2c) &= ~I2C_CR1_SWRST;
+
+	I2C_CR2(i2c) = cr2;
+	I2C_OAR1(i2c) = oar1;
+	I2C_OAR2(i2c) = oar2;
+	I2C_CCR(i2c) = ccr;
+	I2C_TRISE(i2c) = trise;
+	I2C_CR1(i2c) = cr1;
+}
+
+static void i2c_xfer_start_phase(struct i2c_xfer_bus *bus, bool read)
+{
+	struct i2c_xfer *xfer = bus->head;
+	uint32_t i2c = bus->i2c;
+
+	bus->reading = read;
+	bus->pos = 0;
+	/* Stays 0 until EV6, so stale BTF/RxNE can't be taken for data */
+	bus->left = 0;
+
+	I2C_CR1(i2c) &= ~I2C_CR1_POS;
+	if (read && xfer->rn == 2) {
+		/* NACK the second byte, not the one in the shift register */
+		I2C_CR1(i2c) |= I2C_CR1_POS | I2C_CR1_ACK;
+	} else if (read && xfer->rn > 2) {
+		I2C_CR1(i2c) |= I2C_CR1_ACK;
+	} else {
+		I2C_CR1(i2c) &= ~I2C_CR1_ACK;
+	}
+
+	/* Buffer interrupts are only wanted once the address is through */
+	I2C_CR2(i2c) = (I2C_CR2(i2c) & ~(I2C_CR2_ITBUFEN | I2C_CR2_DMAEN |
+					 I2C_CR2_LAST)) |
+		       I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+	I2C_CR1(i2c) |= I2C_CR1_START;
+}
+
+/* Put the head of the queue on the bus, see i2c_xfer_submit() */
+void i2c_xfer_start(struct i2c_xfer_bus *bus)
+{
+	struct i2c_xfer *xfer = bus->head;
+	uint32_t n;
+
+	xfer->status = I2C_XFER_ACTIVE;
+	bus->ticks = 0;
+	bus->error = I2C_XFER_OK;
+
+	/*
+	 * A STOP from the previous transfer must be out before a new START.
+	 * This may run in interrupt context, so if SCL is held low the START
+	 * is left to i2c_xfer_tick() or the next i2c_xfer_submit() rather
+	 * than waited for here.
+	 */
+	for (n = 0; n < I2C_XFER_STOP_POLLS; n++) {
+		if (!(I2C_CR1(bus->i2c) & I2C_CR1_STOP)) {
+			bus->stop_wait = false;
+			i2c_xfer_start_phase(bus,
+					     xfer->wn == 0 && xfer->rn != 0);
+			return;
+		}
+	}
+	bus->stop_wait = true;
+}
+
+static void i2c_xfer_finish(struct i2c_xfer_bus *bus,
+			    enum i2c_xfer_status status)
+{
+	struct i2c_xfer *xfer = bus->head;
+	uint32_t i2c = bus->i2c;
+
+	I2C_CR2(i2c) &= ~(I2C_XFER_IRQS | I2C_CR2_DMAEN | I2C_CR2_LAST);
+	I2C_CR1(i2c) &= ~(I2C_CR1_POS | I2C_CR1_ACK);
+
+	bus->head = xfer->next;
+	if (!bus->head) {
+		bus->tail = NULL;
+	} else {
+		i2c_xfer_start(bus);
+	}
+
+	/* Only now, so the callback may submit again */
+	xfer->status = status;
+	if (xfer->callback) {
+		xfer->callback(xfer);
+	}
+}
+
+/* EV6: address acknowledged, ADDR is cleared by the SR2 read */
+static void i2c_xfer_addr(struct i2c_xfer_bus *bus)
+{
+	struct i2c_xfer *xfer = bus->head;
+	uint32_t i2c = bus->i2c;
+
+	bus->left = bus->reading ? xfer->rn : xfer->wn;
+	if (!bus->reading) {
+		(void)I2C_SR2(i2c);
+		if (xfer->wn) {
+			I2C_CR2(i2c) |= I2C_CR2_ITBUFEN;
+		} else if (xfer->rn) {
+			i2c_xfer_start_phase(bus, true);
+		} else {
+			/* Address probe */
+			I2C_CR1(i2c) |= I2C_CR1_STOP;
+			i2c_xfer_finish(bus, I2C_XFER_OK);
+		}
+		return;
+	}
+
+	if (xfer->rn == 1) {
+		/* ACK is already off, STOP must follow the ADDR clear */
+		(void)I2C_SR2(i2c);
+		I2C_CR1(i2c) |= I2C_CR1_STOP;
+		I2C_CR2(i2c) |= I2C_CR2_ITBUFEN;
+	} else if (xfer->rn == 2) {
+		(void)I2C_SR2(i2c);
+		I2C_CR1(i2c) &= ~I2C_CR1_ACK;
+	} else if (bus->dma_read && xfer->rn >= bus->dma_threshold) {
+		/* LAST makes the hardware NACK the final byte */
+		bus->dma_read(i2c, xfer->r, xfer->rn);
+		I2C_CR2(i2c) |= I2C_CR2_DMAEN | I2C_CR2_LAST;
+		(void)I2C_SR2(i2c);
+	} else {
+		(void)I2C_SR2(i2c);
+		if (xfer->rn > 3) {
+			I2C_CR2(i2c) |= I2C_CR2_ITBUFEN;
+		}
+	}
+}
+
+static void i2c_xfer_read(struct i2c_xfer_bus *bus, uint32_t sr1)
+{
+	struct i2c_xfer *xfer = bus->head;
+	uint32_t i2c = bus->i2c;
+
+	if (I2C_CR2(i2c) & I2C_CR2_DMAEN) {
+		return;
+	}
+
+	if ((sr1 & I2C_SR1_BTF) && bus->left == 3) {
+		/* EV7_2: N-2 in DR, N-1 in the shift register */
+		I2C_CR1(i2c) &= ~I2C_CR1_ACK;
+		xfer->r[bus->pos++] = I2C_DR(i2c) & 0xff;
+		bus->left--;
+	} else if ((sr1 & I2C_SR1_BTF) && bus->left == 2) {
+		I2C_CR1(i2c) |= I2C_CR1_STOP;
+		xfer->r[bus->pos++] = I2C_DR(i2c) & 0xff;
+		xfer->r[bus->pos++] = I2C_DR(i2c) & 0xff;
+		i2c_xfer_finish(bus, I2C_XFER_OK);
+	} else if ((sr1 & I2C_SR1_RxNE) && bus->left == 1) {
+		xfer->r[bus->pos++] = I2C_DR(i2c) & 0xff;
+		i2c_xfer_finish(bus, I2C_XFER_OK);
+	} else if ((sr1 & I2C_SR1_RxNE) && bus->left > 3) {
+		xfer->r[bus->pos++] = I2C_DR(i2c) & 0xff;
+		if (--bus->left == 3) {
+			I2C_CR2(i2c) &= ~I2C_CR2_ITBUFEN;
+		}
+	}
+}
+
+static void i2c_xfer_write(struct i2c_xfer_bus *bus, uint32_t sr1)
+{
+	struct i2c_xfer *xfer = bus->head;
+	uint32_t i2c = bus->i2c;
+
+	if ((sr1 & I2C_SR1_TxE) && bus->left) {
+		I2C_DR(i2c) = xfer->w[bus->pos++];
+		if (--bus->left == 0) {
+			I2C_CR2(i2c) &= ~I2C_CR2_ITBUFEN;
+		}
+	} else if ((sr1 & I2C_SR1_BTF) && bus->pos == xfer->wn) {
+		if (xfer->rn) {
+			i2c_xfer_start_phase(bus, true);
+		} else {
+			I2C_CR1(i2c) |= I2C_CR1_STOP;
+			i2c_xfer_finish(bus, I2C_XFER_OK);
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Initialise a transfer queue
+ *
+ * The peripheral must already be configured (clock, speed) and enabled.
+ * Set bus->dma_read and bus->dma_threshold afterwards to use DMA for reads
+ * of more than two bytes, see i2c_xfer_dma_complete().
+ *
+ * @param[in] bus transfer queue to initialise
+ * @param[in] i2c Unsigned int32. I2C register base address @ref i2c_reg_base.
+ */
+void i2c_xfer_init(struct i2c_xfer_bus *bus, uint32_t i2c)
+{
+	bus->i2c = i2c;
+	bus->dma_read = NULL;
+	bus->dma_threshold = 0;
+	bus->head = NULL;
+	bus->tail = NULL;
+	bus->stop_wait = false;
+	bus->error = I2C_XFER_OK;
+	I2C_CR2(i2c) &= ~(I2C_XFER_IRQS | I2C_CR2_DMAEN | I2C_CR2_LAST);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Transfer queue interrupt handler
+ *
+ * Call from both the I2C event and the I2C error interrupt handlers.
+ *
+ * @param[in] bus transfer queue
+ */
+void i2c_xfer_isr(struct i2c_xfer_bus *bus)
+{
+	uint32_t i2c = bus->i2c;
+	uint32_t sr1 = I2C_SR1(i2c);
+	struct i2c_xfer *xfer = bus->head;
+
+	if (!xfer) {
+		I2C_CR2(i2c) &= ~I2C_XFER_IRQS;
+		return;
+	}
+
+	if (sr1 & I2C_SR1_AF) {
+		I2C_SR1(i2c) = ~I2C_SR1_AF;
+		I2C_CR1(i2c) |= I2C_CR1_STOP;
+		i2c_xfer_finish(bus, I2C_XFER_NACK);
+		return;
+	}
+
+	if (sr1 & (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR |
+		   I2C_SR1_TIMEOUT)) {
+		I2C_SR1(i2c) = ~(I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR |
+				 I2C_SR1_TIMEOUT);
+		if (!(sr1 & I2C_SR1_ARLO)) {
+			I2C_CR1(i2c) |= I2C_CR1_STOP;
+		}
+		i2c_xfer_finish(bus, (sr1 & I2C_SR1_ARLO) ?
+				I2C_XFER_ARB_LOST : I2C_XFER_BUS_ERROR);
+		return;
+	}
+
+	if (sr1 & I2C_SR1_SB) {
+		/* EV5: SB is cleared by the SR1 read above and the DR write */
+		I2C_DR(i2c) = (uint8_t)((xfer->addr << 1) |
+					(bus->reading ? I2C_READ : I2C_WRITE));
+	} else if (sr1 & I2C_SR1_ADDR) {
+		i2c_xfer_addr(bus);
+	} else if (bus->reading) {
+		i2c_xfer_read(bus, sr1);
+	} else {
+		i2c_xfer_write(bus, sr1);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Complete a DMA read
+ *
+ * Call from the transfer complete interrupt of the DMA channel armed by
+ * bus->dma_read, to end the transfer with a STOP condition.
+ *
+ * @param[in] bus transfer queue
+ */
+void i2c_xfer_dma_complete(struct i2c_xfer_bus *bus)
+{
+	if (bus->head && (I2C_CR2(bus->i2c) & I2C_CR2_DMAEN)) {
+		I2C_CR1(bus->i2c) |= I2C_CR1_STOP;
+		i2c_xfer_finish(bus, I2C_XFER_OK);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Transfer queue timeout tick
+ *
+ * Call periodically, eg from the systick handler, to enforce xfer->timeout.
+ * A transfer that runs out of time is aborted with a software reset of the
+ * peripheral, keeping its configuration, and completes with
+ * I2C_XFER_TIMEOUT. If a slave still holds SDA low afterwards, see
+ * i2c_bus_recover().
+ *
+ * Also starts a transfer held back because the STOP ending the previous one
+ * was not out yet; if it still is not, the peripheral is reset first. Such a
+ * transfer is otherwise only retried by the next i2c_xfer_submit(), so the
+ * tick is needed whenever the queue is used, even without timeouts.
+ *
+ * @param[in] bus transfer queue
+ */
+void i2c_xfer_tick(struct i2c_xfer_bus *bus)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+	struct i2c_xfer *xfer = bus->head;
+
+	if (xfer && bus->stop_wait) {
+		if (I2C_CR1(bus->i2c) & I2C_CR1_STOP) {
+			i2c_xfer_reset(bus->i2c);
+		}
+		bus->stop_wait = false;
+		i2c_xfer_start_phase(bus, xfer->wn == 0 && xfer->rn != 0);
+	} else if (xfer && xfer->timeout && ++bus->ticks >= xfer->timeout) {
+		i2c_xfer_reset(bus->i2c);
+		i2c_xfer_finish(bus, I2C_XFER_TIMEOUT);
+	}
+	cm_mask_interrupts(mask);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Release a bus held by a slave
+ *
+ * A slave reset in the middle of a read may keep SDA low forever. Clock SCL
+ * up to nine times until the slave lets go of SDA, then generate a STOP.
+ *
+ * SCL and SDA must be temporarily configured as open drain GPIO outputs,
+ * driven high, and returned to their alternate function afterwards.
+ *
+ * @param[in] scl_port GPIO port of SCL
+ * @param[in] scl GPIO pin of SCL
+ * @param[in] sda_port GPIO port of SDA
+ * @param[in] sda GPIO pin of SDA
+ * @param[in] half_period busy loop iterations for half an SCL period
+ * @returns true if SDA was released
+ */
+bool i2c_bus_recover(uint32_t scl_port, uint16_t scl, uint32_t sda_port,
+		     uint16_t sda, uint32_t half_period)
+{
+	uint32_t i;
+	int clocks;
+
+	gpio_set(sda_port, sda);
+	for (clocks = 0; clocks < 9 && !gpio_get(sda_port, sda); clocks++) {
+		gpio_clear(scl_port, scl);
+		for (i = 0; i < half_period; i++) {
+			__asm__ volatile("nop");
+		}
+		gpio_set(scl_port, scl);
+		for (i = 0; i < half_period; i++) {
+			__asm__ volatile("nop");
+		}
+	}
+
+	/* STOP: SDA rising while SCL is high */
+	gpio_clear(scl_port, scl);
+	gpio_clear(sda_port, sda);
+	for (i = 0; i < half_period; i++) {
+		__asm__ volatile("nop");
+	}
+	gpio_set(scl_port, scl);
+	for (i = 0; i < half_period; i++) {
+		__asm__ volatile("nop");
+	}
+	gpio_set(sda_port, sda);
+
+	return gpio_get(sda_port, sda) != 0;
+}
 
 /**@}*/
@@ -19,6 +19,7 @@
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <libopencm3/cm3/cortex.h>
 #include <libopencm3/stm32/i2c.h>
 #include <libopencm3/stm32/rcc.h>
 
@@ -447,4 +448,213 @@ void i2c_set_speed(uint32_t i2c, enum i2c_speeds speed, uint32_t clock_megahz)
 	}
 }
 
+/*---------------------------------------------------------------------------*/
+/* Interrupt driven transfer queue.
+ *
+ * Transfers are chained on an i2c_xfer_bus and run back to back from
+ * i2c_xfer_isr(), which the application calls from the I2C event (and, where
+ * separate, error) interrupt handler of the peripheral.
+ */
+
+#define I2C_XFER_IRQS	(I2C_CR1_ERRIE | I2C_CR1_TCIE | I2C_CR1_STOPIE | \
+			 I2C_CR1_NACKIE | I2C_CR1_RXIE | I2C_CR1_TXIE)
+
+#define I2C_XFER_MAX_NBYTES	255
+
+/* NBYTES/RELOAD/AUTOEND bits for the next chunk of the current direction */
+static uint32_t i2c_xfer_next_chunk(struct i2c_xfer_bus *bus, bool autoend)
+{
+	size_t n = bus->left;
+
+	if (n > I2C_XFER_MAX_NBYTES) {
+		bus->left -= I2C_XFER_MAX_NBYTES;
+		return (I2C_XFER_MAX_NBYTES << I2C_CR2_NBYTES_SHIFT) |
+		       I2C_CR2_RELOAD;
+	}
+	bus->left = 0;
+	return (n << I2C_CR2_NBYTES_SHIFT) | (autoend ? I2C_CR2_AUTOEND : 0);
+}
+
+static void i2c_xfer_start_phase(struct i2c_xfer_bus *bus, bool read)
+{
+	struct i2c_xfer *xfer = bus->head;
+	uint32_t i2c = bus->i2c;
+	uint32_t cr1, cr2;
+
+	cr1 = I2C_CR1(i2c) & ~(I2C_XFER_IRQS | I2C_CR1_RXDMAEN);
+	cr1 |= I2C_CR1_ERRIE | I2C_CR1_TCIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE;
+	cr2 = (xfer->addr & 0x7F) << I2C_CR2_SADD_7BIT_SHIFT;
+
+	bus->reading = read;
+	bus->pos = 0;
+	if (read) {
+		bus->left = xfer->rn;
+		cr2 |= I2C_CR2_RD_WRN;
+		if (bus->dma_read && xfer->rn >= bus->dma_threshold) {
+			bus->dma_read(i2c, xfer->r, xfer->rn);
+			cr1 |= I2C_CR1_RXDMAEN;
+		} else {
+			cr1 |= I2C_CR1_RXIE;
+		}
+	} else {
+		bus->left = xfer->wn;
+		cr1 |= I2C_CR1_TXIE;
+	}
+	/* A write followed by a read stops at TC for the repeated start */
+	cr2 |= i2c_xfer_next_chunk(bus, read || xfer->rn == 0);
+
+	I2C_CR1(i2c) = cr1;
+	I2C_CR2(i2c) = cr2 | I2C_CR2_START;
+}
+
+/* Put the head of the queue on the bus, see i2c_xfer_submit() */
+void i2c_xfer_start(struct i2c_xfer_bus *bus)
+{
+	struct i2c_xfer *xfer = bus->head;
+
+	xfer->status = I2C_XFER_ACTIVE;
+	bus->ticks = 0;
+	bus->error = I2C_XFER_OK;
+	i2c_xfer_start_phase(bus, xfer->wn == 0 && xfer->rn != 0);
+}
+
+static void i2c_xfer_finish(struct i2c_xfer_bus *bus,
+			    enum i2c_xfer_status status)
+{
+	struct i2c_xfer *xfer = bus->head;
+	uint32_t i2c = bus->i2c;
+
+	I2C_CR1(i2c) &= ~(I2C_XFER_IRQS | I2C_CR1_RXDMAEN);
+	if (status != I2C_XFER_OK) {
+		/* Flush a byte the slave never took */
+		I2C_ISR(i2c) = I2C_ISR_TXE;
+	}
+
+	bus->head = xfer->next;
+	if (!bus->head) {
+		bus->tail = NULL;
+	} else {
+		i2c_xfer_start(bus);
+	}
+
+	/* Only now, so the callback may submit again */
+	xfer->status = status;
+	if (xfer->callback) {
+		xfer->callback(xfer);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Initialise a transfer queue
+ *
+ * The peripheral must already be configured (timing, filters) and enabled.
+ * Set bus->dma_read and bus->dma_threshold afterwards to use DMA for reads.
+ *
+ * @param[in] bus transfer queue to initialise
+ * @param[in] i2c Unsigned int32. I2C register base address @ref i2c_reg_base.
+ */
+void i2c_xfer_init(struct i2c_xfer_bus *bus, uint32_t i2c)
+{
+	bus->i2c = i2c;
+	bus->dma_read = NULL;
+	bus->dma_threshold = 0;
+	bus->head = NULL;
+	bus->tail = NULL;
+	bus->stop_wait = false;
+	bus->error = I2C_XFER_OK;
+	I2C_CR1(i2c) &= ~(I2C_XFER_IRQS | I2C_CR1_RXDMAEN);
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Transfer queue interrupt handler
+ *
+ * Call from the I2C event interrupt handler, and from the error interrupt
+ * handler on parts where that is separate.
+ *
+ * @param[in] bus transfer queue
+ */
+void i2c_xfer_isr(struct i2c_xfer_bus *bus)
+{
+	uint32_t i2c = bus->i2c;
+	uint32_t isr = I2C_ISR(i2c);
+	struct i2c_xfer *xfer = bus->head;
+
+	if (!xfer) {
+		I2C_CR1(i2c) &= ~I2C_XFER_IRQS;
+		return;
+	}
+
+	if (isr & (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR |
+		   I2C_ISR_TIMEOUT)) {
+		I2C_ICR(i2c) = I2C_ICR_BERRCF | I2C_ICR_ARLOCF |
+			       I2C_ICR_OVRCF | I2C_ICR_TIMOUTCF;
+		i2c_xfer_finish(bus, (isr & I2C_ISR_ARLO) ?
+				I2C_XFER_ARB_LOST : I2C_XFER_BUS_ERROR);
+		return;
+	}
+
+	if (isr & I2C_ISR_NACKF) {
+		/* The master sends STOP by itself, finish on STOPF */
+		I2C_ICR(i2c) = I2C_ICR_NACKCF;
+		if (!(I2C_CR2(i2c) & I2C_CR2_AUTOEND)) {
+			I2C_CR2(i2c) |= I2C_CR2_STOP;
+		}
+		bus->error = I2C_XFER_NACK;
+	}
+
+	if ((isr & I2C_ISR_TXIS) && bus->pos < xfer->wn) {
+		I2C_TXDR(i2c) = xfer->w[bus->pos++];
+	}
+
+	/* With RXDMAEN the DMA owns RXDR; pos stays at 0 */
+	if ((isr & I2C_ISR_RXNE) && !(I2C_CR1(i2c) & I2C_CR1_RXDMAEN) &&
+	    bus->pos < xfer->rn) {
+		xfer->r[bus->pos++] = I2C_RXDR(i2c) & 0xff;
+	}
+
+	if (isr & I2C_ISR_TCR) {
+		I2C_CR2(i2c) = (I2C_CR2(i2c) &
+				~(I2C_CR2_NBYTES_MASK | I2C_CR2_RELOAD)) |
+			       i2c_xfer_next_chunk(bus,
+					bus->reading || xfer->rn == 0);
+	}
+
+	if ((isr & I2C_ISR_TC) && !bus->reading &&
+	    bus->error == I2C_XFER_OK) {
+		i2c_xfer_start_phase(bus, true);
+	}
+
+	if (isr & I2C_ISR_STOPF) {
+		I2C_ICR(i2c) = I2C_ICR_STOPCF;
+		i2c_xfer_finish(bus, bus->error);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief I2C Transfer queue timeout tick
+ *
+ * Call periodically, eg from the systick handler, to enforce xfer->timeout.
+ * A transfer that runs out of time is aborted by toggling PE, which releases
+ * the bus, and completes with I2C_XFER_TIMEOUT.
+ *
+ * @param[in] bus transfer queue
+ */
+void i2c_xfer_tick(struct i2c_xfer_bus *bus)
+{
+	uint32_t mask = cm_mask_interrupts(1);
+	struct i2c_xfer *xfer = bus->head;
+	int i;
+
+	if (xfer && xfer->timeout && ++bus->ticks >= xfer->timeout) {
+		/* PE must stay low for at least three APB clock cycles */
+		I2C_CR1(bus->i2c) &= ~I2C_CR1_PE;
+		for (i = 0; i < 3; i++) {
+			(void)I2C_CR1(bus->i2c);
+		}
+		I2C_CR1(bus->i2c) |= I2C_CR1_PE;
+		i2c_xfer_finish(bus, I2C_XFER_TIMEOUT);
+	}
+	cm_mask_interrupts(mask);
+}
+
 /**@}*/
@@ -36,6 +36,7 @@
 
 /**@{*/
 
+#include <libopencm3/cm3/cortex.h>
 #include <libopencm3/stm32/common/ltdc_common_f47.h>
 
 void ltdc_set_tft_sync_timings(uint16_t sync_width,    uint16_t sync_height,
@@ -88,5 +89,237 @@ void ltdc_setup_windowing(uint8_t layer_number, uint16_t h_back_porch,
 		(v_back_porch + v_sync) << LTDC_LxWVPCR_WVSTPOS_SHIFT;
 }
 
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Pixel Size
+@param[in] format unsigned int32. LTDC_LxPFCR_* pixel format
+@returns Bytes per pixel.
+*/
+uint32_t ltdc_pixel_size(uint32_t format)
+{
+	static const uint8_t size[8] = { 4, 3, 2, 2, 2, 1, 1, 2 };
+
+	return size[format & 7];
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Layer Setup
+
+Sets window, pixel format, framebuffer, constant alpha, color key and CLUT of
+a layer, blending by pixel alpha times constant alpha, and enables it. The
+synchronisation timings must already be set, the window is placed relative to
+the active area. Like all layer registers these are shadowed: they take
+effect on ltdc_reload(), or ltdc_vblank_reload() for a tear free change. The
+CLUT is written directly, while the layer is disabled or during blanking.
+
+@param[in] layer unsigned int32. @ref ltdc_layer_num
+@param[in] cfg Layer configuration.
+*/
+void ltdc_layer_setup(uint32_t layer, const struct ltdc_layer_config *cfg)
+{
+	uint32_t x0 = ((LTDC_BPCR >> LTDC_BPCR_AHBP_SHIFT) &
+		       LTDC_BPCR_AHBP_MASK) + 1 + cfg->x;
+	uint32_t y0 = ((LTDC_BPCR >> LTDC_BPCR_AVBP_SHIFT) &
+		       LTDC_BPCR_AVBP_MASK) + 1 + cfg->y;
+	uint32_t size = ltdc_pixel_size(cfg->format);
+	uint32_t pitch = cfg->pitch ? cfg->pitch : cfg->width;
+	uint32_t cr = LTDC_LxCR_LAYER_ENABLE;
+	uint32_t i;
+
+	LTDC_LxWHPCR(layer) =
+		(x0 + cfg->width - 1) << LTDC_LxWHPCR_WHSPPOS_SHIFT |
+		x0 << LTDC_LxWHPCR_WHSTPOS_SHIFT;
+	LTDC_LxWVPCR(layer) =
+		(y0 + cfg->height - 1) << LTDC_LxWVPCR_WVSPPOS_SHIFT |
+		y0 << LTDC_LxWVPCR_WVSTPOS_SHIFT;
+	ltdc_set_pixel_format(layer, cfg->format);
+	ltdc_set_fbuffer_address(layer, cfg->fb);
+	/* The line length includes the 3 bytes of the FIFO */
+	ltdc_set_fb_line_length(layer, cfg->width * size + 3, pitch * size);
+	LTDC_LxCFBLNR(layer) = cfg->height & 0x7ff;
+	ltdc_set_constant_alpha(layer, cfg->alpha);
+	ltdc_set_default_colors(layer, 0, 0, 0, 0);
+	ltdc_set_blending_factors(layer,
+				  LTDC_LxBFCR_BF1_PIXEL_ALPHA_x_CONST_ALPHA,
+				  LTDC_LxBFCR_BF2_PIXEL_ALPHA_x_CONST_ALPHA);
+
+	if (cfg->color_key) {
+		LTDC_LxCKCR(layer) = cfg->key & 0xffffff;
+		cr |= LTDC_LxCR_COLKEY_ENABLE;
+	}
+	if (cfg->clut) {
+		for (i = 0; i < cfg->clut_size; i++) {
+			LTDC_LxCLUTWR(layer) =
+				i << LTDC_LxCLUTWR_CLUTADD_SHIFT |
+				(cfg->clut[i] & 0xffffff);
+		}
+		cr |= LTDC_LxCR_COLTAB_ENABLE;
+	}
+	LTDC_LxCR(layer) = cr;
+}
+
+/* Reload requested, flips per layer and frames, for ltdc_isr() */
+static volatile bool ltdc_reload_pending;
+static struct ltdc_flip *ltdc_flips[2];
+static volatile uint32_t ltdc_frames;
+
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Vertical Blanking Interrupt Setup
+
+Sets the line interrupt to the first line after the active area, from which
+ltdc_isr() applies reloads and page flips. The application calls ltdc_isr()
+from its LTDC interrupt handler, with that enabled in the NVIC. The
+synchronisation timings must already be set.
+*/
+void ltdc_vblank_init(void)
+{
+	uint32_t line = ((LTDC_AWCR >> LTDC_AWCR_AAH_SHIFT) &
+			 LTDC_AWCR_AAH_MASK) + 1;
+	uint32_t total = (LTDC_TWCR >> LTDC_TWCR_TOTALH_SHIFT) &
+			 LTDC_TWCR_TOTALH_MASK;
+
+	if (line > total) {
+		line = 0;
+	}
+	LTDC_LIPCR = line << LTDC_LIPCR_LIPOS_SHIFT;
+	LTDC_ICR = LTDC_ICR_CLIF | LTDC_ICR_CFUIF | LTDC_ICR_CTERRIF;
+	LTDC_IER |= LTDC_IER_LIE;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Reload at Vertical Blanking
+
+Requests a reload of the shadow registers at the next vertical blanking
+interrupt, see ltdc_vblank_init().
+*/
+void ltdc_vblank_reload(void)
+{
+	ltdc_reload_pending = true;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Frame Count
+@returns Vertical blanking interrupts since ltdc_vblank_init().
+*/
+uint32_t ltdc_frame_count(void)
+{
+	return ltdc_frames;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Interrupt Handler
+
+On the vertical blanking line interrupt, reloads the shadow registers if
+requested and completes page flips: the buffer that was scanned out until
+now becomes free to draw into.
+*/
+void ltdc_isr(void)
+{
+	uint32_t isr = LTDC_ISR;
+	struct ltdc_flip *f;
+	int i;
+
+	LTDC_ICR = isr & (LTDC_ISR_LIF | LTDC_ISR_FUIF | LTDC_ISR_TERRIF);
+	if (!(isr & LTDC_ISR_LIF)) {
+		return;
+	}
+
+	ltdc_frames++;
+	if (!ltdc_reload_pending) {
+		return;
+	}
+	ltdc_reload(LTDC_SRCR_RELOAD_IMR);
+	ltdc_reload_pending = false;
+
+	for (i = 0; i < 2; i++) {
+		f = ltdc_flips[i];
+		if (!f || f->pending < 0) {
+			continue;
+		}
+		if (f->back < 0) {
+			f->back = f->front;
+		}
+		f->front = f->pending;
+		f->pending = -1;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Page Flip Setup
+
+Shows buffer 0 on a layer set up with ltdc_layer_setup(), taking effect on
+the next reload, and makes buffer 1 the back buffer. Page flips need
+ltdc_vblank_init().
+
+@param[in] f Flip state.
+@param[in] layer unsigned int32. @ref ltdc_layer_num
+@param[in] buffers Framebuffer addresses.
+@param[in] nbuffers 2 for double, 3 for triple buffering.
+*/
+void ltdc_flip_init(struct ltdc_flip *f, uint32_t layer,
+		    const uint32_t *buffers, uint8_t nbuffers)
+{
+	uint8_t i;
+
+	f->layer = layer;
+	f->nbuffers = nbuffers;
+	for (i = 0; i < nbuffers; i++) {
+		f->buffers[i] = buffers[i];
+	}
+	f->front = 0;
+	f->pending = -1;
+	f->back = 1;
+	ltdc_set_fbuffer_address(layer, buffers[0]);
+	ltdc_flips[layer - 1] = f;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Back Buffer
+
+With double buffering, waits for a flip still pending to complete.
+
+@param[in] f Flip state.
+@returns Address of the framebuffer to draw the next frame into.
+*/
+uint32_t ltdc_flip_back_buffer(struct ltdc_flip *f)
+{
+	while (f->back < 0);
+
+	return f->buffers[f->back];
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief LTDC Page Flip
+
+Shows the back buffer from the next frame, tear free. With triple buffering,
+drawing continues in the third buffer meanwhile; a frame still pending is
+then dropped for the new one. With double buffering, ltdc_flip_back_buffer()
+waits for the flip. Any other layer changes are applied with it.
+
+@param[in] f Flip state.
+*/
+void ltdc_flip_swap(struct ltdc_flip *f)
+{
+	uint32_t mask;
+	int8_t i, done;
+
+	/* Double buffered with a flip still pending */
+	while (f->back < 0);
+
+	mask = cm_mask_interrupts(1);
+	done = f->pending;
+
+	f->pending = f->back;
+	ltdc_set_fbuffer_address(f->layer, f->buffers[f->pending]);
+	ltdc_reload_pending = true;
+
+	f->back = done;
+	for (i = 0; f->back < 0 && i < f->nbuffers; i++) {
+		if (i != f->front && i != f->pending) {
+			f->back = i;
+		}
+	}
+	cm_mask_interrupts(mask);
+}
+
 /**@}*/
 
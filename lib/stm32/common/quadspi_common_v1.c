@@ -266,6 +266,43 @@ uint32_t quadspi_read_word(void)
 	return (uint32_t) QUADSPI_DR;
 }
 
+#ifdef QUADSPI_CR_DMAEN
+void quadspi_enable_dma(void)
+{
+	QUADSPI_CR |= QUADSPI_CR_DMAEN;
+}
+
+void quadspi_disable_dma(void)
+{
+	QUADSPI_CR &= ~QUADSPI_CR_DMAEN;
+}
+#endif
+
+void quadspi_set_polling_mask(uint32_t mask)
+{
+	QUADSPI_PSMKR = mask;
+}
+
+void quadspi_set_polling_match(uint32_t match)
+{
+	QUADSPI_PSMAR = match;
+}
+
+void quadspi_set_polling_interval(uint16_t interval)
+{
+	QUADSPI_PIR = interval;
+}
+
+void quadspi_set_memory_mapped_timeout(uint16_t cycles)
+{
+	QUADSPI_LPTR = cycles;
+	if (cycles) {
+		QUADSPI_CR |= QUADSPI_CR_TCEN;
+	} else {
+		QUADSPI_CR &= ~QUADSPI_CR_TCEN;
+	}
+}
+
 uint32_t quadspi_set_bus_frequency(uint32_t ahb_frequency, uint32_t bus_frequency)
 {
 	uint32_t real_bus_frequency = -1;
@@ -292,11 +329,66 @@ uint32_t quadspi_set_bus_frequency(uint32_t ahb_frequency, uint32_t bus_frequenc
 	return real_bus_frequency;
 }
 
+/* Size of the QUADSPI FIFO in bytes */
+#define QUADSPI_FIFO_SIZE	32
+
+/* Instruction, address, alternative bytes and dummy phases of a command */
+static uint32_t quadspi_prepare_command(struct quadspi_command *command)
+{
+	uint32_t ccr = 0;
+
+	if (command->instruction.mode != QUADSPI_CCR_MODE_NONE) {
+		ccr = quadspi_prepare_instruction_mode(ccr, command->instruction.mode);
+		ccr = quadspi_prepare_instruction(ccr, command->instruction.instruction);
+	}
+
+	if (command->address.mode != QUADSPI_CCR_MODE_NONE) {
+		ccr = quadspi_prepare_address_mode(ccr, command->address.mode);
+		ccr = quadspi_prepare_address_size(ccr, command->address.size);
+	}
+
+	if (command->alternative_bytes.mode != QUADSPI_CCR_MODE_NONE) {
+		ccr = quadspi_prepare_alternative_bytes_mode(
+			ccr,
+		command->alternative_bytes.mode);
+		ccr = quadspi_prepare_alternative_bytes_size(
+			ccr,
+		command->alternative_bytes.size);
+		quadspi_set_alternative_bytes(command->alternative_bytes.value);
+	}
+
+	if (command->dummy_cycles) {
+		ccr = quadspi_prepare_dummy_cycles(ccr, command->dummy_cycles);
+	}
+	return ccr;
+}
+
+/* Set up and start an indirect transfer, without moving any data */
+static void quadspi_start_indirect(struct quadspi_command *command,
+				   uint32_t buffer_size, uint32_t mode)
+{
+	/* Step 1: Prepare QUADSPI_CCR-register */
+	uint32_t ccr = quadspi_prepare_command(command);
+
+	if ((buffer_size) && (command->data_mode != QUADSPI_CCR_MODE_NONE)) {
+		ccr = quadspi_prepare_data_mode(ccr, command->data_mode);
+		quadspi_set_data_length(buffer_size - 1);
+	}
+	ccr = quadspi_prepare_funcion_mode(ccr, mode);
+
+	/* Step 2: Write QUADSPI_CCR-register */
+	quadspi_write_ccr(ccr);
+
+	/* Step 3: Write address, if necessary */
+	if (command->address.mode != QUADSPI_CCR_MODE_NONE) {
+		quadspi_set_address(command->address.address);
+	}
+}
+
 uint32_t quadspi_write(struct quadspi_command *command, const void *buffer, uint32_t buffer_size)
 {
 	uint32_t result = (uint32_t) -1;
-	volatile uint32_t *data_reg = (volatile uint32_t *)&QUADSPI_DR;
-	uint8_t *byte_buffer = (uint8_t *) buffer;
+	const uint8_t *byte_buffer = (const uint8_t *) buffer;
 
 	/* Check parameter.
 		Do only something if:
@@ -304,54 +396,25 @@ uint32_t quadspi_write(struct quadspi_command *command, const void *buffer, uint
 		* Pointer to buffer is not NULL when buffer_size >0
 	 */
 	if ((command != NULL) && ((buffer != NULL) || (buffer_size == 0))) {
-		uint32_t ccr = 0;
-		/* Step 1: Prepare QUADSPI_CCR-register */
-		if (command->instruction.mode != QUADSPI_CCR_MODE_NONE) {
-			ccr = quadspi_prepare_instruction_mode(ccr, command->instruction.mode);
-			ccr = quadspi_prepare_instruction(ccr, command->instruction.instruction);
-		}
+		quadspi_start_indirect(command, buffer_size, QUADSPI_CCR_FMODE_IWRITE);
 
-		if (command->address.mode != QUADSPI_CCR_MODE_NONE) {
-			ccr = quadspi_prepare_address_mode(ccr, command->address.mode);
-			ccr = quadspi_prepare_address_size(ccr, command->address.size);
+		if (command->data_mode == QUADSPI_CCR_MODE_NONE) {
+			buffer_size = 0;
 		}
-
-		if (command->alternative_bytes.mode != QUADSPI_CCR_MODE_NONE) {
-			ccr = quadspi_prepare_alternative_bytes_mode(
-				ccr,
-			command->alternative_bytes.mode);
-			ccr = quadspi_prepare_alternative_bytes_size(
-				ccr,
-			command->alternative_bytes.size);
-			quadspi_set_alternative_bytes(command->alternative_bytes.value);
-		}
-
-		if (command->dummy_cycles) {
-			ccr = quadspi_prepare_dummy_cycles(ccr, command->dummy_cycles);
-		}
-
-		if ((buffer_size) && (command->data_mode != QUADSPI_CCR_MODE_NONE)) {
-			ccr = quadspi_prepare_data_mode(ccr, command->data_mode);
-			quadspi_set_data_length(buffer_size - 1);
-		}
-		ccr = quadspi_prepare_funcion_mode(ccr, QUADSPI_CCR_FMODE_IWRITE);
-
-		/* Step 2: Write QUADSPI_CCR-register */
-		quadspi_write_ccr(ccr);
-
-		/* Step 3: Write address, if necessary */
-		if (command->address.mode != QUADSPI_CCR_MODE_NONE) {
-			quadspi_set_address(command->address.address);
-		}
-
-		/* Step 4: Send data */
-		if (buffer_size) {
-			for (result = 0; result < buffer_size; result++) {
-				uint32_t flags;
-				do {
-					flags = QUADSPI_SR & (QUADSPI_SR_FTF | QUADSPI_SR_TCF);
-				} while (!flags);
-				*((volatile uint8_t *) data_reg) = *(byte_buffer++);
+		/* Step 4: Send data, a word at a time while there is room */
+		result = 0;
+		while (result < buffer_size) {
+			uint32_t level = quadspi_get_fifo_level();
+
+			if ((buffer_size - result >= 4) &&
+			    (level <= QUADSPI_FIFO_SIZE - 4)) {
+				QUADSPI_DR = (uint32_t)byte_buffer[result] |
+					     ((uint32_t)byte_buffer[result + 1] << 8) |
+					     ((uint32_t)byte_buffer[result + 2] << 16) |
+					     ((uint32_t)byte_buffer[result + 3] << 24);
+				result += 4;
+			} else if (level < QUADSPI_FIFO_SIZE) {
+				QUADSPI_BYTE_DR = byte_buffer[result++];
 			}
 		}
 	}
@@ -361,7 +424,6 @@ uint32_t quadspi_write(struct quadspi_command *command, const void *buffer, uint
 uint32_t quadspi_read(struct quadspi_command *command, void *buffer, uint32_t buffer_size)
 {
 	uint32_t result = (uint32_t) -1;
-	volatile uint32_t *data_reg = (volatile uint32_t *)&QUADSPI_DR;
 	uint8_t *byte_buffer = (uint8_t *) buffer;
 
 	/* Check parameter.
@@ -370,56 +432,97 @@ uint32_t quadspi_read(struct quadspi_command *command, void *buffer, uint32_t bu
 		* Pointer to buffer is not NULL when buffer_size >0
 	 */
 	if ((command != NULL) && ((buffer != NULL) || (buffer_size == 0))) {
-		uint32_t ccr = 0;
-		/* Step 1: Prepare QUADSPI_CCR-register */
-		if (command->instruction.mode != QUADSPI_CCR_MODE_NONE) {
-			ccr = quadspi_prepare_instruction_mode(ccr, command->instruction.mode);
-			ccr = quadspi_prepare_instruction(ccr, command->instruction.instruction);
-		}
+		quadspi_start_indirect(command, buffer_size, QUADSPI_CCR_FMODE_IREAD);
 
-		if (command->address.mode != QUADSPI_CCR_MODE_NONE) {
-			ccr = quadspi_prepare_address_mode(ccr, command->address.mode);
-			ccr = quadspi_prepare_address_size(ccr, command->address.size);
+		if (command->data_mode == QUADSPI_CCR_MODE_NONE) {
+			buffer_size = 0;
 		}
-
-		if (command->alternative_bytes.mode != QUADSPI_CCR_MODE_NONE) {
-			ccr = quadspi_prepare_alternative_bytes_mode(
-				ccr,
-			command->alternative_bytes.mode);
-			ccr = quadspi_prepare_alternative_bytes_size(
-				ccr,
-			command->alternative_bytes.size);
-			quadspi_set_alternative_bytes(command->alternative_bytes.value);
+		/* Step 4: Read data, a word at a time while the FIFO has one */
+		result = 0;
+		while (result < buffer_size) {
+			uint32_t level = quadspi_get_fifo_level();
+
+			if ((buffer_size - result >= 4) && (level >= 4)) {
+				uint32_t data = QUADSPI_DR;
+
+				byte_buffer[result++] = data;
+				byte_buffer[result++] = data >> 8;
+				byte_buffer[result++] = data >> 16;
+				byte_buffer[result++] = data >> 24;
+			} else if (level) {
+				byte_buffer[result++] = QUADSPI_BYTE_DR;
+			}
 		}
+	}
+	return result;
+}
 
-		if (command->dummy_cycles) {
-			ccr = quadspi_prepare_dummy_cycles(ccr, command->dummy_cycles);
-		}
+bool quadspi_memory_mapped(struct quadspi_command *command)
+{
+	uint32_t ccr;
 
-		if ((buffer_size) && (command->data_mode != QUADSPI_CCR_MODE_NONE)) {
-			ccr = quadspi_prepare_data_mode(ccr, command->data_mode);
-			quadspi_set_data_length(buffer_size - 1);
-		}
-		ccr = quadspi_prepare_funcion_mode(ccr, QUADSPI_CCR_FMODE_IREAD);
+	if ((command == NULL) || (command->data_mode == QUADSPI_CCR_MODE_NONE)) {
+		return false;
+	}
 
-		/* Step 2: Write QUADSPI_CCR-register */
-		quadspi_write_ccr(ccr);
+	ccr = quadspi_prepare_command(command);
+	ccr = quadspi_prepare_data_mode(ccr, command->data_mode);
+	ccr = quadspi_prepare_funcion_mode(ccr, QUADSPI_CCR_FMODE_MEMMAP);
 
-		/* Step 3: Write address, if necessary */
-		if (command->address.mode != QUADSPI_CCR_MODE_NONE) {
-			quadspi_set_address(command->address.address);
-		}
+	/* No address write here, it comes from each AHB access */
+	quadspi_wait_while_busy();
+	quadspi_write_ccr(ccr);
+	return true;
+}
 
-		/* Step 4: Read data */
-		if (buffer_size) {
-			for (result = 0; result < buffer_size; result++) {
-				uint32_t flags;
-				do {
-					flags = QUADSPI_SR & (QUADSPI_SR_FTF | QUADSPI_SR_TCF);
-				} while (!flags);
-				*(byte_buffer++) = *((volatile uint8_t *) data_reg);
-			}
-		}
+bool quadspi_start_status_polling(struct quadspi_command *command, uint32_t mask,
+				  uint32_t match, uint32_t size, uint16_t interval)
+{
+	if ((command == NULL) || (command->data_mode == QUADSPI_CCR_MODE_NONE) ||
+	    (size < 1) || (size > 4)) {
+		return false;
 	}
-	return result;
-}
\ No newline at end of file
+
+	/* CR and the polling registers may only be written while not busy */
+	quadspi_wait_while_busy();
+	quadspi_clear_flag(QUADSPI_FCR_CSMF);
+	quadspi_set_polling_mask(mask);
+	quadspi_set_polling_match(match);
+	quadspi_set_polling_interval(interval);
+	/* AND match, stop polling on the first match */
+	QUADSPI_CR = (QUADSPI_CR & ~QUADSPI_CR_PMM) | QUADSPI_CR_APMS;
+
+	quadspi_start_indirect(command, size, QUADSPI_CCR_FMODE_APOLL);
+	return true;
+}
+
+bool quadspi_status_polling_done(void)
+{
+	if (quadspi_get_flag(QUADSPI_SR_SMF)) {
+		quadspi_clear_flag(QUADSPI_FCR_CSMF);
+		return true;
+	}
+	return false;
+}
+
+bool quadspi_read_dma(struct quadspi_command *command, uint32_t buffer_size)
+{
+	if ((command == NULL) || (command->data_mode == QUADSPI_CCR_MODE_NONE) ||
+	    (buffer_size == 0)) {
+		return false;
+	}
+	quadspi_clear_flag(QUADSPI_FCR_CTCF);
+	quadspi_start_indirect(command, buffer_size, QUADSPI_CCR_FMODE_IREAD);
+	return true;
+}
+
+bool quadspi_write_dma(struct quadspi_command *command, uint32_t buffer_size)
+{
+	if ((command == NULL) || (command->data_mode == QUADSPI_CCR_MODE_NONE) ||
+	    (buffer_size == 0)) {
+		return false;
+	}
+	quadspi_clear_flag(QUADSPI_FCR_CTCF);
+	quadspi_start_indirect(command, buffer_size, QUADSPI_CCR_FMODE_IWRITE);
+	return true;
+}
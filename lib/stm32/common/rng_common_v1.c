@@ -26,6 +26,8 @@
  * along with this library. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
+#include <libopencm3/cm3/cortex.h>
 #include <libopencm3/stm32/rng.h>
 
 /**@{*/
@@ -58,6 +60,26 @@ void rng_interrupt_disable(void)
     RNG_CR &= ~RNG_CR_IE;
 }
 
+/* Clear error flags, restarting the generator after a seed error */
+static void rng_clear_errors(void)
+{
+        uint32_t rv;
+
+        if (RNG_SR & RNG_SR_SEIS) {
+                RNG_SR = RNG_SR & ~RNG_SR_SEIS;
+                for (int i = 12; i != 0; i--) {
+                        rv = RNG_DR;
+                }
+                (void)rv;
+                RNG_CR &= ~RNG_CR_RNGEN;
+                RNG_CR |= RNG_CR_RNGEN;
+        }
+
+        if (RNG_SR & RNG_SR_CEIS) {
+                RNG_SR = RNG_SR & ~RNG_SR_CEIS;
+        }
+}
+
 /** Randomizes a number (non-blocking).
  * Can fail if a clock error or seed error is detected. Consult the Reference
  * Manual, but "try again", potentially after resetting the peripheral
@@ -97,24 +119,234 @@ uint32_t rng_get_random_blocking(void)
         uint32_t rv;
         bool done;
         do {
+                rng_clear_errors();
+                done = rng_get_random(&rv);
+        } while (!done);
 
-                if (RNG_SR & RNG_SR_SEIS) {
-                        RNG_SR = RNG_SR & ~RNG_SR_SEIS;
-                        for (int i = 12; i != 0; i--) {
-                                rv = RNG_DR;
-                        }
-                        RNG_CR &= ~RNG_CR_RNGEN;
-                        RNG_CR |= RNG_CR_RNGEN;
-                }
+        return rv;
+}
+
+/* Entropy pool, filled from rng_isr() */
+static uint32_t *rng_pool;
+static uint32_t rng_pool_size;
+static volatile uint32_t rng_pool_head;
+static volatile uint32_t rng_pool_tail;
+
+/** Set up the interrupt fed entropy pool.
+ * The pool keeps up to @p nwords - 1 ready words. The RNG interrupt is
+ * enabled while the pool is not full; call rng_isr() from its handler.
+ * @param buf storage for the pool
+ * @param nwords number of words in @p buf, at least 2
+ */
+void rng_pool_init(uint32_t *buf, uint32_t nwords)
+{
+        uint32_t mask = cm_mask_interrupts(1);
+
+        rng_pool = buf;
+        rng_pool_size = nwords;
+        rng_pool_head = 0;
+        rng_pool_tail = 0;
+        cm_mask_interrupts(mask);
 
-                if (RNG_SR & RNG_SR_CEIS) {
-                        RNG_SR = RNG_SR & ~RNG_SR_CEIS;
+        rng_enable();
+        rng_interrupt_enable();
+}
+
+/** Number of ready words in the entropy pool.
+ */
+uint32_t rng_pool_level(void)
+{
+        uint32_t n = rng_pool_head - rng_pool_tail;
+
+        return rng_pool_head >= rng_pool_tail ? n : n + rng_pool_size;
+}
+
+/** Handle the RNG interrupt.
+ * Recovers from seed and clock errors and moves ready words into the pool,
+ * disabling the interrupt once it is full.
+ */
+void rng_isr(void)
+{
+        uint32_t next;
+
+        rng_clear_errors();
+        if (!rng_pool) {
+                return;
+        }
+
+        while (!(RNG_SR & (RNG_SR_CECS | RNG_SR_SECS)) &&
+               (RNG_SR & RNG_SR_DRDY)) {
+                next = rng_pool_head + 1;
+                if (next == rng_pool_size) {
+                        next = 0;
+                }
+                if (next == rng_pool_tail) {
+                        rng_interrupt_disable();
+                        return;
                 }
+                rng_pool[rng_pool_head] = RNG_DR;
+                rng_pool_head = next;
+        }
+}
 
-                done = rng_get_random(&rv);
-        } while (!done);
+/** Fill a buffer with random bytes.
+ * Takes words from the entropy pool and only waits on the peripheral once
+ * the pool runs dry. Works without the pool as well.
+ * @param buf buffer to fill
+ * @param len number of bytes
+ */
+void rng_fill(void *buf, uint32_t len)
+{
+        uint8_t *p = buf;
+        uint32_t w, n, mask;
+        bool got;
 
-        return rv;
+        while (len) {
+                /* Masked so that rng_isr() can't take a word between the
+                 * DRDY check and the DR read of a direct read */
+                do {
+                        mask = cm_mask_interrupts(1);
+                        if (rng_pool && rng_pool_tail != rng_pool_head) {
+                                w = rng_pool[rng_pool_tail];
+                                rng_pool_tail =
+                                        rng_pool_tail + 1 == rng_pool_size ?
+                                        0 : rng_pool_tail + 1;
+                                got = true;
+                        } else {
+                                rng_clear_errors();
+                                got = rng_get_random(&w);
+                        }
+                        cm_mask_interrupts(mask);
+                } while (!got);
+
+                n = len < 4 ? len : 4;
+                memcpy(p, &w, n);
+                p += n;
+                len -= n;
+        }
+
+        if (rng_pool) {
+                rng_interrupt_enable();
+        }
+}
+
+#define RNG_ROTL(x, n)  (((x) << (n)) | ((x) >> (32 - (n))))
+#define RNG_QR(a, b, c, d) do {                                         \
+        a += b; d ^= a; d = RNG_ROTL(d, 16);                            \
+        c += d; b ^= c; b = RNG_ROTL(b, 12);                            \
+        a += b; d ^= a; d = RNG_ROTL(d, 8);                             \
+        c += d; b ^= c; b = RNG_ROTL(b, 7);                             \
+} while (0)
+
+/* One ChaCha20 block of the DRBG key stream */
+static void rng_drbg_block(struct rng_drbg *d, uint32_t *out)
+{
+        static const uint32_t sigma[4] = {
+                0x61707865, 0x3320646e, 0x79622d32, 0x6b206574
+        };
+        uint32_t x[16];
+        int i;
+
+        for (i = 0; i < 4; i++) {
+                x[i] = sigma[i];
+        }
+        for (i = 0; i < 8; i++) {
+                x[4 + i] = d->key[i];
+        }
+        x[12] = d->counter;
+        x[13] = d->counter >> 32;
+        x[14] = 0;
+        x[15] = 0;
+        d->counter++;
+
+        for (i = 0; i < 16; i++) {
+                out[i] = x[i];
+        }
+        for (i = 0; i < 10; i++) {
+                RNG_QR(out[0], out[4], out[8], out[12]);
+                RNG_QR(out[1], out[5], out[9], out[13]);
+                RNG_QR(out[2], out[6], out[10], out[14]);
+                RNG_QR(out[3], out[7], out[11], out[15]);
+                RNG_QR(out[0], out[5], out[10], out[15]);
+                RNG_QR(out[1], out[6], out[11], out[12]);
+                RNG_QR(out[2], out[7], out[8], out[13]);
+                RNG_QR(out[3], out[4], out[9], out[14]);
+        }
+        for (i = 0; i < 16; i++) {
+                out[i] += x[i];
+        }
+}
+
+/* Replace the key by key stream, so earlier output can't be recomputed */
+static void rng_drbg_rekey(struct rng_drbg *d)
+{
+        uint32_t blk[16];
+        int i;
+
+        rng_drbg_block(d, blk);
+        for (i = 0; i < 8; i++) {
+                d->key[i] = blk[i];
+        }
+        memset(blk, 0, sizeof(blk));
+}
+
+/** Mix fresh hardware entropy into a DRBG.
+ * @param d generator
+ */
+void rng_drbg_reseed(struct rng_drbg *d)
+{
+        uint32_t seed[8];
+        int i;
+
+        rng_fill(seed, sizeof(seed));
+        for (i = 0; i < 8; i++) {
+                d->key[i] ^= seed[i];
+        }
+        memset(seed, 0, sizeof(seed));
+        rng_drbg_rekey(d);
+        d->generated = 0;
+}
+
+/** Seed a software DRBG from the hardware.
+ * The generator is ChaCha20 based with key erasure after every request.
+ * It is much faster than the peripheral for bulk output and reseeds itself
+ * from rng_fill() after @p reseed_interval bytes.
+ * @param d generator
+ * @param reseed_interval bytes between reseeds, 0 for never
+ */
+void rng_drbg_init(struct rng_drbg *d, uint32_t reseed_interval)
+{
+        memset(d, 0, sizeof(*d));
+        d->reseed_interval = reseed_interval;
+        rng_drbg_reseed(d);
+}
+
+/** Generate random bytes from a DRBG.
+ * @param d generator
+ * @param buf buffer to fill
+ * @param len number of bytes
+ */
+void rng_drbg_generate(struct rng_drbg *d, void *buf, uint32_t len)
+{
+        uint32_t blk[16];
+        uint8_t *p = buf;
+        uint32_t n;
+
+        if (d->reseed_interval && d->generated >= d->reseed_interval) {
+                rng_drbg_reseed(d);
+        }
+        d->generated += len;
+
+        while (len) {
+                rng_drbg_block(d, blk);
+                n = len < sizeof(blk) ? len : sizeof(blk);
+                memcpy(p, blk, n);
+                p += n;
+                len -= n;
+        }
+        memset(blk, 0, sizeof(blk));
+
+        rng_drbg_rekey(d);
 }
 
 
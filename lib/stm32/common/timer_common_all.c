@@ -670,6 +670,46 @@ void timer_set_repetition_counter(uint32_t timer_peripheral, uint32_t value)
 	TIM_RCR(timer_peripheral) = value;
 }
 
+/*---------------------------------------------------------------------------*/
+/** @brief Timer Set Update Rate
+
+Chooses prescaler and period for an update event rate as close as possible to
+the one requested, and makes the update event the trigger output (TRGO), as
+used to pace DAC and ADC conversions. Suits 16 bit counters, such as the basic
+timers TIM6 and TIM7.
+
+@param[in] timer_peripheral Unsigned int32. Timer register address base @ref
+tim_reg_base
+@param[in] clock Unsigned int32. Timer input clock in Hz.
+@param[in] rate Unsigned int32. Update events per second.
+@returns Unsigned int32. The rate achieved, 0 if out of range.
+*/
+
+uint32_t timer_set_update_rate(uint32_t timer_peripheral, uint32_t clock,
+			       uint32_t rate)
+{
+	uint32_t ticks, psc, arr;
+
+	if (rate == 0 || rate > clock) {
+		return 0;
+	}
+
+	ticks = (clock + rate / 2) / rate;
+	psc = (ticks - 1) / 65536;
+	arr = (ticks + psc / 2) / (psc + 1) - 1;
+	if (psc > 0xffff) {
+		return 0;
+	}
+
+	timer_set_prescaler(timer_peripheral, psc);
+	timer_set_period(timer_peripheral, arr);
+	timer_set_master_mode(timer_peripheral, TIM_CR2_MMS_UPDATE);
+	/* Load the prescaler now rather than at the next update */
+	timer_generate_event(timer_peripheral, TIM_EGR_UG);
+
+	return clock / ((psc + 1) * (arr + 1));
+}
+
 /*---------------------------------------------------------------------------*/
 /** @brief Timer Set Period
 
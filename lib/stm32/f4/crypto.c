@@ -8,6 +8,9 @@
  *
  * @date 18 Jun 2013
  *
+ * The GCM and CCM modes are only wired up here, for F42xx and F43xx. The F7
+ * has the same CRYP block but no crypto driver in this tree yet.
+ *
  */
 /*
  * This file is part of the libopencm3 project.
@@ -28,6 +31,7 @@
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <libopencm3/stm32/crypto.h>
 
 /**@{*/
@@ -59,8 +63,262 @@ void crypto_context_swap(uint32_t *buf)
 	for (i = 0; i < 8; i++) {
 		uint32_t save = *buf;
 		*buf++ = CRYP_CSGCMR(i);
-		CRYP_CSGCMCCMR(i) = save;
+		CRYP_CSGCMR(i) = save;
 	};
 }
 
+/* AAD and payload length of the running GCM/CCM operation */
+static uint32_t crypto_aead_aadlen;
+static uint32_t crypto_aead_len;
+/* Partial header block */
+static uint8_t crypto_aead_buf[16];
+static uint32_t crypto_aead_fill;
+/* CCM counter block 0, encrypted for the tag */
+static uint8_t crypto_ccm_ctr0[16];
+static uint32_t crypto_ccm_taglen;
+
+/* Write a 16 byte block; the 8 bit data type makes it byte ordered */
+static void crypto_write_block(const uint8_t *p)
+{
+	uint32_t w[4];
+	int i;
+
+	memcpy(w, p, 16);
+	for (i = 0; i < 4; i++) {
+		while (!(CRYP_SR & CRYP_SR_IFNF));
+		CRYP_DIN = w[i];
+	}
+}
+
+static void crypto_read_block(uint8_t *p)
+{
+	uint32_t w[4];
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		while (!(CRYP_SR & CRYP_SR_OFNE));
+		w[i] = CRYP_DOUT;
+	}
+	memcpy(p, w, 16);
+}
+
+static void crypto_set_phase(uint32_t phase)
+{
+	CRYP_CR &= ~CRYP_CR_CRYPEN;
+	CRYP_CR = (CRYP_CR & ~CRYP_CR_GCM_CMPH) | phase;
+	CRYP_CR |= CRYP_CR_CRYPEN;
+}
+
+/* Queue header bytes, writing each block once complete */
+static void crypto_aead_feed(const uint8_t *p, uint32_t len)
+{
+	while (len--) {
+		crypto_aead_buf[crypto_aead_fill++] = *p++;
+		if (crypto_aead_fill == 16) {
+			crypto_write_block(crypto_aead_buf);
+			crypto_aead_fill = 0;
+		}
+	}
+}
+
+/* Zero pad and write the last header block, then enter the payload phase */
+static void crypto_aead_header_end(void)
+{
+	if (crypto_aead_fill) {
+		memset(crypto_aead_buf + crypto_aead_fill, 0,
+		       16 - crypto_aead_fill);
+		crypto_write_block(crypto_aead_buf);
+		crypto_aead_fill = 0;
+	}
+	crypto_wait_busy();
+	crypto_set_phase(CRYP_CR_GCM_CMPH_PAYLOAD);
+}
+
+/* Load the session for byte ordered data and run the init phase */
+static void crypto_aead_init(struct crypto_session *s, const uint8_t *iv,
+			     const uint8_t *b0)
+{
+	crypto_session_load(s, iv);
+	CRYP_CR = (CRYP_CR & ~(CRYP_CR_DATATYPE | CRYP_CR_GCM_CMPH)) |
+		  CRYP_CR_DATATYPE_8 | CRYP_CR_GCM_CMPH_INIT;
+	CRYP_CR |= CRYP_CR_CRYPEN;
+	if (b0) {
+		crypto_write_block(b0);
+	}
+	while (CRYP_CR & CRYP_CR_CRYPEN);
+
+	crypto_aead_len = 0;
+	crypto_aead_fill = 0;
+	crypto_set_phase(CRYP_CR_GCM_CMPH_HEADER);
+}
+
+/**
+ * @brief Start an AES-GCM operation
+ *
+ * Runs the init and header phases, leaving the controller ready for
+ * crypto_aead_update().
+ *
+ * @param[in] s Session set up with ENCRYPT_GCM or DECRYPT_GCM.
+ * @param[in] iv uint8_t* 12 byte IV
+ * @param[in] aad uint8_t* Additional authenticated data
+ * @param[in] aadlen uint32_t Length of @p aad in bytes
+ */
+void crypto_gcm_start(struct crypto_session *s, const uint8_t *iv,
+		      const uint8_t *aad, uint32_t aadlen)
+{
+	uint8_t j0[16];
+
+	memcpy(j0, iv, 12);
+	j0[12] = 0;
+	j0[13] = 0;
+	j0[14] = 0;
+	j0[15] = 2;
+
+	crypto_aead_init(s, j0, NULL);
+	crypto_aead_aadlen = aadlen;
+	crypto_aead_feed(aad, aadlen);
+	crypto_aead_header_end();
+}
+
+/**
+ * @brief Process GCM/CCM payload
+ *
+ * May be called repeatedly with lengths a multiple of 16 bytes; only the
+ * last call may pass a partial block.
+ *
+ * @note On F42xx/F43xx a partial last block gives a wrong tag for GCM
+ * encryption and CCM decryption (see the errata sheet), so pad the payload
+ * to whole blocks there.
+ *
+ * @param[in] in uint8_t* Input data
+ * @param[out] out uint8_t* Output data
+ * @param[in] len uint32_t Length in bytes
+ */
+void crypto_aead_update(const uint8_t *in, uint8_t *out, uint32_t len)
+{
+	uint8_t blk[16];
+	uint32_t n;
+
+	crypto_aead_len += len;
+	while (len) {
+		n = len < 16 ? len : 16;
+		memcpy(blk, in, n);
+		memset(blk + n, 0, 16 - n);
+		crypto_write_block(blk);
+		crypto_read_block(blk);
+		memcpy(out, blk, n);
+		in += n;
+		out += n;
+		len -= n;
+	}
+}
+
+/**
+ * @brief Finish an AES-GCM operation
+ *
+ * @param[out] tag uint8_t* 16 byte authentication tag. When decrypting,
+ *                 compare it with the received one in constant time.
+ */
+void crypto_gcm_finish(uint8_t *tag)
+{
+	uint32_t w[4];
+	int i;
+
+	crypto_wait_busy();
+	/* The final phase computes the tag in the encrypt direction */
+	CRYP_CR &= ~CRYP_CR_CRYPEN;
+	CRYP_CR = (CRYP_CR & ~(CRYP_CR_GCM_CMPH | CRYP_CR_ALGODIR)) |
+		  CRYP_CR_GCM_CMPH_FINAL;
+	CRYP_CR |= CRYP_CR_CRYPEN;
+
+	/* len(A) || len(C) in bits, byte swapped for the 8 bit data type */
+	w[0] = __builtin_bswap32(crypto_aead_aadlen >> 29);
+	w[1] = __builtin_bswap32(crypto_aead_aadlen << 3);
+	w[2] = __builtin_bswap32(crypto_aead_len >> 29);
+	w[3] = __builtin_bswap32(crypto_aead_len << 3);
+	for (i = 0; i < 4; i++) {
+		CRYP_DIN = w[i];
+	}
+	crypto_read_block(tag);
+	crypto_stop();
+}
+
+/**
+ * @brief Start an AES-CCM operation
+ *
+ * Formats B0 and the counter blocks from the parameters (NIST SP 800-38C)
+ * and runs the init and header phases, leaving the controller ready for
+ * crypto_aead_update().
+ *
+ * @param[in] s Session set up with ENCRYPT_CCM or DECRYPT_CCM.
+ * @param[in] nonce uint8_t* Nonce
+ * @param[in] noncelen uint32_t Nonce length, 7 to 13 bytes
+ * @param[in] aad uint8_t* Additional authenticated data
+ * @param[in] aadlen uint32_t Length of @p aad in bytes
+ * @param[in] len uint32_t Payload length in bytes
+ * @param[in] taglen uint32_t Tag length, 4 to 16 bytes, even
+ */
+void crypto_ccm_start(struct crypto_session *s, const uint8_t *nonce,
+		      uint32_t noncelen, const uint8_t *aad, uint32_t aadlen,
+		      uint32_t len, uint32_t taglen)
+{
+	uint8_t b0[16];
+	uint8_t ctr1[16];
+	uint8_t pre[6];
+	uint32_t q = 15 - noncelen;
+	uint32_t i;
+
+	memset(b0, 0, 16);
+	b0[0] = (aadlen ? 0x40 : 0) | (((taglen - 2) / 2) << 3) | (q - 1);
+	memcpy(b0 + 1, nonce, noncelen);
+	for (i = 0; i < q && i < 4; i++) {
+		b0[15 - i] = len >> (8 * i);
+	}
+
+	memset(crypto_ccm_ctr0, 0, 16);
+	crypto_ccm_ctr0[0] = q - 1;
+	memcpy(crypto_ccm_ctr0 + 1, nonce, noncelen);
+	memcpy(ctr1, crypto_ccm_ctr0, 16);
+	ctr1[15] = 1;
+	crypto_ccm_taglen = taglen;
+
+	crypto_aead_init(s, ctr1, b0);
+	crypto_aead_aadlen = aadlen;
+	if (aadlen) {
+		if (aadlen < 0xff00) {
+			pre[0] = aadlen >> 8;
+			pre[1] = aadlen;
+			crypto_aead_feed(pre, 2);
+		} else {
+			pre[0] = 0xff;
+			pre[1] = 0xfe;
+			pre[2] = aadlen >> 24;
+			pre[3] = aadlen >> 16;
+			pre[4] = aadlen >> 8;
+			pre[5] = aadlen;
+			crypto_aead_feed(pre, 6);
+		}
+		crypto_aead_feed(aad, aadlen);
+	}
+	crypto_aead_header_end();
+}
+
+/**
+ * @brief Finish an AES-CCM operation
+ *
+ * @param[out] tag uint8_t* Authentication tag, of the length given to
+ *                 crypto_ccm_start()
+ */
+void crypto_ccm_finish(uint8_t *tag)
+{
+	uint8_t t[16];
+
+	crypto_wait_busy();
+	crypto_set_phase(CRYP_CR_GCM_CMPH_FINAL);
+	crypto_write_block(crypto_ccm_ctr0);
+	crypto_read_block(t);
+	memcpy(tag, t, crypto_ccm_taglen);
+	crypto_stop();
+}
+
 /**@}*/
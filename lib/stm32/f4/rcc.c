@@ -859,6 +859,167 @@ void rcc_clock_setup_pll(const struct rcc_clock_scale *clock)
 	}
 }
 
+/* Keep a main PLL candidate if it gets closer to the target from below, or
+ * as close with a higher VCO input frequency, which means less jitter. */
+static void rcc_pll_try(uint32_t source_freq, uint32_t m, uint32_t n,
+			uint32_t p, uint32_t q, uint32_t target,
+			struct rcc_clock_scale *best)
+{
+	uint64_t vco = (uint64_t)source_freq * n / m;
+	uint32_t f;
+
+	if (n < 50 || n > 432 || vco < 100000000 || vco > 432000000) {
+		return;
+	}
+	f = vco / p;
+	if (f > target || f < best->ahb_frequency ||
+	    (f == best->ahb_frequency && m >= best->pllm)) {
+		return;
+	}
+	best->pllm = m;
+	best->plln = n;
+	best->pllp = p;
+	best->pllq = q;
+	best->ahb_frequency = f;
+}
+
+/**
+ * Compute a clock configuration for rcc_clock_setup_pll().
+ *
+ * Searches the main PLL dividers for the system clock closest to, and not
+ * above, @p sysclk, with a PLL input of 1 to 2 MHz, the highest possible,
+ * and a VCO of 100 to 432 MHz. If @p usb48 is set, PLL48CK must be exactly
+ * 48 MHz, for USB OTG FS, SDIO and RNG; otherwise Q only keeps it at or
+ * below 48 MHz. APB1 and APB2 are divided down to at most 42 and 84 MHz, or
+ * 45 and 90 MHz above 168 MHz, and the voltage scale and flash wait states,
+ * for a 2.7 to 3.6 V supply, follow from the system clock. It is pure
+ * computation, so the same results can be tabulated ahead of time.
+ *
+ * @param source_freq HSE or HSI frequency in Hz.
+ * @param pll_source RCC_CFGR_PLLSRC_HSE_CLK or RCC_CFGR_PLLSRC_HSI_CLK
+ * @param sysclk System clock wanted in Hz, at most the part's maximum.
+ * @param usb48 Require exactly 48 MHz from the PLL Q output.
+ * @param clock Filled in with the configuration found.
+ * @returns false if there is none.
+ */
+bool rcc_clock_solve(uint32_t source_freq, uint8_t pll_source,
+		     uint32_t sysclk, bool usb48,
+		     struct rcc_clock_scale *clock)
+{
+	uint32_t m, p, q, ws, apb1_max, apb2_max;
+	uint64_t vco;
+
+	clock->pllm = 0xff;
+	clock->ahb_frequency = 0;
+	for (m = 2; m <= 63; m++) {
+		if (source_freq < m * 1000000 || source_freq > m * 2000000) {
+			continue;
+		}
+		for (p = 2; p <= 8; p += 2) {
+			if (!usb48) {
+				rcc_pll_try(source_freq, m,
+					    (uint64_t)sysclk * m * p / source_freq,
+					    p, 0, sysclk, clock);
+				continue;
+			}
+			/* The VCO must be a multiple of 48 MHz */
+			for (q = 3; q <= 9; q++) {
+				vco = 48000000ULL * q * m;
+				if (vco % source_freq == 0) {
+					rcc_pll_try(source_freq, m,
+						    vco / source_freq, p, q,
+						    sysclk, clock);
+				}
+			}
+		}
+	}
+	if (clock->ahb_frequency == 0) {
+		return false;
+	}
+
+	vco = (uint64_t)clock->ahb_frequency * clock->pllp;
+	if (!usb48) {
+		clock->pllq = (vco + 47999999) / 48000000;
+		if (clock->pllq < 2) {
+			clock->pllq = 2;
+		}
+	}
+	clock->pllr = 0;
+	clock->pll_source = pll_source;
+
+	clock->hpre = RCC_CFGR_HPRE_NODIV;
+	apb1_max = clock->ahb_frequency > 168000000 ? 45000000 : 42000000;
+	apb2_max = 2 * apb1_max;
+	clock->ppre1 = RCC_CFGR_PPRE_NODIV;
+	clock->apb1_frequency = clock->ahb_frequency;
+	while (clock->apb1_frequency > apb1_max) {
+		clock->ppre1 = clock->ppre1 ? clock->ppre1 + 1 :
+					      RCC_CFGR_PPRE_DIV2;
+		clock->apb1_frequency /= 2;
+	}
+	clock->ppre2 = RCC_CFGR_PPRE_NODIV;
+	clock->apb2_frequency = clock->ahb_frequency;
+	while (clock->apb2_frequency > apb2_max) {
+		clock->ppre2 = clock->ppre2 ? clock->ppre2 + 1 :
+					      RCC_CFGR_PPRE_DIV2;
+		clock->apb2_frequency /= 2;
+	}
+
+	/* Limits of the lowest performing parts, F401 and F411 */
+	if (clock->ahb_frequency <= 60000000) {
+		clock->voltage_scale = PWR_SCALE3;
+	} else if (clock->ahb_frequency <= 84000000) {
+		clock->voltage_scale = PWR_SCALE2;
+	} else {
+		clock->voltage_scale = PWR_SCALE1;
+	}
+
+	ws = (clock->ahb_frequency - 1) / 30000000;
+	clock->flash_config = FLASH_ACR_DCEN | FLASH_ACR_ICEN |
+			      FLASH_ACR_LATENCY(ws);
+	return true;
+}
+
+/**
+ * Compute the PLLI2S dividers for an I2S clock.
+ *
+ * The PLLI2S shares the main PLL input divider, so this takes the
+ * configuration the main PLL runs from.
+ *
+ * @param clock Main PLL configuration.
+ * @param source_freq HSE or HSI frequency in Hz.
+ * @param i2s_freq I2S clock wanted in Hz.
+ * @param n Set to the multiplication factor for rcc_plli2s_config().
+ * @param r Set to the division factor for rcc_plli2s_config().
+ * @returns the I2S clock closest to @p i2s_freq, 0 if none.
+ */
+uint32_t rcc_plli2s_solve(const struct rcc_clock_scale *clock,
+			  uint32_t source_freq, uint32_t i2s_freq,
+			  uint16_t *n, uint8_t *r)
+{
+	uint32_t ri, ni, f, err, best = 0, best_err = UINT32_MAX;
+	uint64_t vco;
+
+	for (ri = 2; ri <= 7; ri++) {
+		ni = ((uint64_t)i2s_freq * ri * clock->pllm +
+		      source_freq / 2) / source_freq;
+		vco = (uint64_t)source_freq * ni / clock->pllm;
+		if (ni < 50 || ni > 432 ||
+		    vco < 100000000 || vco > 432000000) {
+			continue;
+		}
+		f = vco / ri;
+		err = f > i2s_freq ? f - i2s_freq : i2s_freq - f;
+		if (err < best_err) {
+			best_err = err;
+			best = f;
+			*n = ni;
+			*r = ri;
+		}
+	}
+	return best;
+}
+
 /**
  * Setup clocks with the HSE.
  *
@@ -81,6 +81,61 @@ unsigned fdcan_get_txbuf_element_size(uint32_t canport)
 	return sizeof(struct fdcan_tx_buffer_element);
 }
 
+/** Returns amount of elements in receive FIFO.
+ *
+ * G4 has both receive FIFOs hardcoded to 3 elements.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block. Unused.
+ * @param [in] fifo_id ID of FIFO whose size is queried. Unused.
+ * @returns Amount of elements in the FIFO.
+ */
+unsigned fdcan_get_rxfifo_depth(uint32_t canport, unsigned fifo_id)
+{
+	/* Silences compiler. Variables are present for API compatibility
+	 * with STM32H7
+	 */
+	(void) (canport);
+	(void) (fifo_id);
+	return 3;
+}
+
+/** Returns amount of elements in transmit event FIFO.
+ *
+ * G4 has transmit event FIFO hardcoded to 3 elements.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block. Unused.
+ * @returns Amount of elements in transmit event FIFO.
+ */
+unsigned fdcan_get_txevt_depth(uint32_t canport)
+{
+	(void) (canport);
+	return 3;
+}
+
+/** Returns index of first transmit buffer belonging to transmit FIFO/queue.
+ *
+ * G4 has no dedicated transmit buffers, all 3 buffers form FIFO/queue.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block. Unused.
+ * @returns Index of first transmit FIFO/queue element.
+ */
+unsigned fdcan_get_txfifo_first(uint32_t canport)
+{
+	(void) (canport);
+	return 0;
+}
+
+/** Returns amount of elements in transmit FIFO/queue.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block. Unused.
+ * @returns Amount of elements in transmit FIFO/queue.
+ */
+unsigned fdcan_get_txfifo_depth(uint32_t canport)
+{
+	(void) (canport);
+	return 3;
+}
+
 /** Configure amount of filters and initialize filtering block.
  *
  * This function allows to configure global amount of filters present.
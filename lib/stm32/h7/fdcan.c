@@ -98,6 +98,49 @@ unsigned fdcan_get_txbuf_element_size(uint32_t canport)
 	return 8 + fdcan_dlc_to_length((element_size & FDCAN_TXESC_TBDS_MASK) | 0x8);
 }
 
+/** Returns amount of elements in receive FIFO.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block.
+ * @param [in] fifo_id ID of FIFO whose size is queried.
+ * @returns Amount of elements configured for the FIFO.
+ */
+unsigned fdcan_get_rxfifo_depth(uint32_t canport, unsigned fifo_id)
+{
+	return (FDCAN_RXFIC(canport, fifo_id) >> FDCAN_RXFIC_FIS_SHIFT) & FDCAN_RXFIC_FIS_MASK;
+}
+
+/** Returns amount of elements in transmit event FIFO.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block.
+ * @returns Amount of elements configured for transmit event FIFO.
+ */
+unsigned fdcan_get_txevt_depth(uint32_t canport)
+{
+	return (FDCAN_TXEFC(canport) >> FDCAN_TXEFC_EFS_SHIFT) & FDCAN_TXEFC_EFS_MASK;
+}
+
+/** Returns index of first transmit buffer belonging to transmit FIFO/queue.
+ *
+ * Transmit FIFO/queue follows dedicated transmit buffers.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block.
+ * @returns Index of first transmit FIFO/queue element.
+ */
+unsigned fdcan_get_txfifo_first(uint32_t canport)
+{
+	return (FDCAN_TXBC(canport) >> FDCAN_TXBC_NDTB_SHIFT) & FDCAN_TXBC_NDTB_MASK;
+}
+
+/** Returns amount of elements in transmit FIFO/queue.
+ *
+ * @param [in] canport FDCAN block base address. See @ref fdcan_block.
+ * @returns Amount of elements configured for transmit FIFO/queue.
+ */
+unsigned fdcan_get_txfifo_depth(uint32_t canport)
+{
+	return (FDCAN_TXBC(canport) >> FDCAN_TXBC_TFQS_SHIFT) & FDCAN_TXBC_TFQS_MASK;
+}
+
 /** Initialize allocation of standard filter block in CAN message RAM.
  *
  * Allows specifying size of standard filtering block (in term of available filtering